@@ -0,0 +1,44 @@
+# Local HTTP/1.1 server for testing the HTTP worker pool with "/client bench http [port]"
+#   Usage: python3 misc/http_test_server.py [port] (port defaults to 8080)
+# Every response is delayed, so that requests overlap. The response body is
+#   "[connection id],[most requests seen at once to this request's Host]"
+# which the client uses to check keep-alive reuse and the per host request limit.
+import sys, threading, time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+DELAY = 0.2
+lock  = threading.Lock()
+state = { "conns": 0, "active": {}, "most": {} }
+
+class Handler(BaseHTTPRequestHandler):
+	protocol_version = "HTTP/1.1"
+
+	def setup(self):
+		super().setup()
+		with lock:
+			state["conns"] += 1
+			self.conn_id = state["conns"]
+
+	def do_GET(self):
+		host = self.headers.get("Host", "")
+		with lock:
+			active = state["active"].get(host, 0) + 1
+			state["active"][host] = active
+			state["most"][host]   = max(state["most"].get(host, 0), active)
+
+		time.sleep(DELAY)
+		with lock:
+			state["active"][host] -= 1
+			body = ("%d,%d" % (self.conn_id, state["most"][host])).encode()
+
+		self.send_response(200)
+		self.send_header("Content-Type",   "text/plain")
+		self.send_header("Content-Length", str(len(body)))
+		self.end_headers()
+		self.wfile.write(body)
+
+	def log_message(self, fmt, *args):
+		sys.stderr.write("[conn %d] %s\n" % (self.conn_id, fmt % args))
+
+port = int(sys.argv[1]) if len(sys.argv) > 1 else 8080
+ThreadingHTTPServer(("", port), Handler).serve_forever()
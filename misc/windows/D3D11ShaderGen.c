@@ -9,16 +9,25 @@
 
 static const char VS_SOURCE[] =
 "float4x4 mvpMatrix;                                                \n" \
-"#ifdef VS_TEXTURE_OFFSET                                           \n" \
+"#if defined VS_TEXTURE_OFFSET || defined VS_CHUNK                  \n" \
 "float2 texOffset;                                                  \n" \
 "#endif                                                             \n" \
+"#ifdef VS_CHUNK                                                    \n" \
+"float3 chunkOrigin;                                                \n" \
+"#endif                                                             \n" \
 "                                                                   \n" \
 "struct INPUT_VERTEX {                                              \n" \
+"#ifdef VS_CHUNK                                                    \n" \
+"   int3 position : POSITION;                                       \n" \
+"   float4 color : COLOR0;                                          \n" \
+"   uint2 coords : TEXCOORD0;                                       \n" \
+"#else                                                              \n" \
 "   float3 position : POSITION;                                     \n" \
 "   float4 color : COLOR0;                                          \n" \
 "#ifndef VS_COLOR_ONLY                                              \n" \
 "   float2 coords : TEXCOORD0;                                      \n" \
 "#endif                                                             \n" \
+"#endif                                                             \n" \
 "};                                                                 \n" \
 "struct OUTPUT_VERTEX {                                             \n" \
 "#ifndef VS_COLOR_ONLY                                              \n" \
@@ -31,8 +40,15 @@ static const char VS_SOURCE[] =
 "OUTPUT_VERTEX main(INPUT_VERTEX input) {                           \n" \
 "   OUTPUT_VERTEX output;                                           \n" \
 "   // https://stackoverflow.com/questions/16578765/hlsl-mul-variables-clarification \n" \
+"#ifdef VS_CHUNK                                                    \n" \
+"   // See CHUNK_VERTEX_POS_SCALE/U_SCALE/V_SCALE in Graphics.h      \n" \
+"   float3 pos    = input.position * (1.0f / 256.0f) + chunkOrigin; \n" \
+"   output.position = mul(mvpMatrix, float4(pos, 1.0f));            \n" \
+"   output.coords = input.coords * float2(1.0f / 2048.0f, 1.0f / 32768.0f); \n" \
+"#else                                                              \n" \
 "   output.position = mul(mvpMatrix, float4(input.position, 1.0f)); \n" \
-"#ifndef VS_COLOR_ONLY                                              \n" \
+"#endif                                                             \n" \
+"#if !defined VS_COLOR_ONLY && !defined VS_CHUNK                    \n" \
 "   output.coords = input.coords;                                   \n" \
 "#endif                                                             \n" \
 "#ifdef VS_TEXTURE_OFFSET                                           \n" \
@@ -138,6 +154,7 @@ int main() {
 	const D3D_SHADER_MACRO vs_colored[]  = { "VS_COLOR_ONLY","1",  NULL,NULL };
 	const D3D_SHADER_MACRO vs_textured[] = {                       NULL,NULL };
 	const D3D_SHADER_MACRO vs_offset[]   = { "VS_TEXTURE_OFFSET","1",  NULL,NULL };
+	const D3D_SHADER_MACRO vs_chunk[]    = { "VS_CHUNK","1",  NULL,NULL };
 
 	const D3D_SHADER_MACRO ps_colored[]       = { "PS_COLOR_ONLY","1",  NULL,NULL };
 	const D3D_SHADER_MACRO ps_textured[]      = {                       NULL,NULL };
@@ -161,6 +178,7 @@ int main() {
 	CompileVertexShader("vs_colored",         vs_colored);
 	CompileVertexShader("vs_textured",        vs_textured);
 	CompileVertexShader("vs_textured_offset", vs_offset);
+	CompileVertexShader("vs_chunk",           vs_chunk);
 
 	printf("\n\n");
 	printf("//########################################################################################################################\n");
@@ -396,7 +396,7 @@ static void OnInit(void) {
 	TextureEntry_Register(&water_entry);
 	TextureEntry_Register(&lava_entry);
 
-	ScheduledTask_Add(GAME_DEF_TICKS, Animations_Tick);
+	ScheduledTask_AddNamed(GAME_DEF_TICKS, Animations_Tick, "Animations_Tick");
 	Event_Register_(&TextureEvents.PackChanged, NULL, OnPackChanged);
 }
 #else
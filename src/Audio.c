@@ -13,6 +13,7 @@
 #include "Utils.h"
 #include "Options.h"
 #include "Deflate.h"
+#include "Entity.h"
 #ifdef CC_BUILD_MOBILE
 /* TODO: Refactor maybe to not rely on checking WinInfo.Handle != NULL */
 #include "Window.h"
@@ -46,6 +47,440 @@ const cc_string Sounds_ZipPathCC = String_FromConst("audio/classicube.zip");
 static const cc_string audio_dir = String_FromConst("audio");
 
 
+/*########################################################################################################################*
+*-----------------------------------------------------Software mixer------------------------------------------------------*
+*#########################################################################################################################*/
+#ifndef CC_BUILD_NOSOUNDS
+/* The web client decodes sounds itself, and consoles often have limited audio memory, */
+/*  so those backends keep playing each sound through its own pooled context instead */
+#if !defined CC_BUILD_WEBAUDIO && !defined CC_BUILD_CONSOLE
+#define AUDIO_SOFTWARE_MIXER
+#endif
+/* Number of stereo frames mixed per queued output chunk (~23 ms) */
+#define MIXER_CHUNK_FRAMES 1024
+
+struct MixerVoice {
+	const cc_int16* samples;
+	cc_uint32 frames;     /* Total number of frames in samples */
+	cc_uint32 index;      /* Current frame being played */
+	cc_uint32 frac, step; /* Fractional frame position and per output frame advance (16.16 fixed point) */
+	cc_uint16 gainL, gainR;
+	cc_uint8 channels, priority;
+	cc_bool active;
+};
+static struct MixerVoice mixer_voices[AUDIO_MIXER_MAX_VOICES];
+static cc_int32 mixer_accum[MIXER_CHUNK_FRAMES * 2];
+static void* mixer_lock;
+
+#define MixerVoice_Score(priority, gainL, gainR) (((priority) << 9) + (gainL) + (gainR))
+
+static void MixerVoice_Init(struct MixerVoice* voice, const struct AudioData* data, int priority, int gainL, int gainR) {
+	voice->samples  = (const cc_int16*)data->chunk.data;
+	voice->channels = data->channels;
+	voice->frames   = data->chunk.size / (2 * data->channels);
+	voice->index    = 0;
+	voice->frac     = 0;
+	voice->step     = (cc_uint32)((((cc_uint64)data->sampleRate * data->rate) << 16) / (100 * AUDIO_MIXER_SAMPLE_RATE));
+	voice->gainL    = gainL * data->volume / 100;
+	voice->gainR    = gainR * data->volume / 100;
+	voice->priority = priority;
+	voice->active   = voice->frames && voice->step;
+}
+
+cc_bool AudioMixer_Play(const struct AudioData* data, int priority, int gainL, int gainR) {
+	struct MixerVoice* voice = NULL;
+	struct MixerVoice* v;
+	int i, score, bestScore = MixerVoice_Score(priority, gainL, gainR);
+	if (data->channels < 1 || data->channels > 2 || !data->chunk.size) return false;
+
+	Mutex_Lock(mixer_lock);
+	for (i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+	{
+		v = &mixer_voices[i];
+		if (!v->active) { voice = v; break; }
+
+		/* Otherwise steal the least important voice */
+		score = MixerVoice_Score(v->priority, v->gainL, v->gainR);
+		if (score < bestScore) { voice = v; bestScore = score; }
+	}
+
+	if (voice) MixerVoice_Init(voice, data, priority, gainL, gainR);
+	Mutex_Unlock(mixer_lock);
+	return voice != NULL;
+}
+
+static void MixerVoice_Mix(struct MixerVoice* v, cc_int32* dst, int frames) {
+	const cc_int16* src = v->samples;
+	cc_uint32 idx = v->index, frac = v->frac, last = v->frames - 1;
+	int i, a, b, l, r;
+
+	for (i = 0; i < frames && idx < v->frames; i++, dst += 2)
+	{
+		/* Linearly interpolate between this and the next frame */
+		if (v->channels == 1) {
+			a = src[idx]; b = idx < last ? src[idx + 1] : a;
+			l = a + (((b - a) * (int)(frac >> 2)) >> 14);
+			r = l;
+		} else {
+			a = src[idx * 2 + 0]; b = idx < last ? src[idx * 2 + 2] : a;
+			l = a + (((b - a) * (int)(frac >> 2)) >> 14);
+			a = src[idx * 2 + 1]; b = idx < last ? src[idx * 2 + 3] : a;
+			r = a + (((b - a) * (int)(frac >> 2)) >> 14);
+		}
+
+		dst[0] += (l * v->gainL) >> 8;
+		dst[1] += (r * v->gainR) >> 8;
+
+		frac += v->step;
+		idx  += frac >> 16;
+		frac &= 0xFFFF;
+	}
+
+	v->index  = idx;
+	v->frac   = frac;
+	v->active = idx < v->frames;
+}
+
+static void MixerVoices_Mix(struct MixerVoice* voices, int count, cc_int32* accum, int frames) {
+	int i;
+	Mem_Set(accum, 0, frames * 2 * sizeof(cc_int32));
+
+	for (i = 0; i < count; i++)
+	{
+		if (!voices[i].active) continue;
+		MixerVoice_Mix(&voices[i], accum, frames);
+	}
+}
+
+static void AudioMixer_Clip(const cc_int32* accum, cc_int16* dst, int frames) {
+	int i, sample;
+
+	for (i = 0; i < frames * 2; i++)
+	{
+		sample = accum[i];
+		dst[i] = (cc_int16)(sample < -32768 ? -32768 : (sample > 32767 ? 32767 : sample));
+	}
+}
+
+static void AudioMixer_MixChunk(cc_int16* dst, int frames) {
+	Mutex_Lock(mixer_lock);
+	MixerVoices_Mix(mixer_voices, AUDIO_MIXER_MAX_VOICES, mixer_accum, frames);
+	Mutex_Unlock(mixer_lock);
+	AudioMixer_Clip(mixer_accum, dst, frames);
+}
+
+void AudioMixer_Mix(cc_int16* dst, int frames) {
+	int count;
+
+	for (; frames > 0; frames -= count, dst += count * 2)
+	{
+		count = min(frames, MIXER_CHUNK_FRAMES);
+		AudioMixer_MixChunk(dst, count);
+	}
+}
+
+#define MIXER_CHECK_FRAMES 8
+cc_bool AudioMixer_Check(void) {
+	static const cc_int16 mono[4]   = { 1000, 2000, 3000, 4000 };
+	static const cc_int16 stereo[4] = { 20000, -20000, 30000, -30000 };
+	/* Mono is at full left and half right gain, stereo is resampled from half the rate and clips */
+	static const cc_int16 expected[MIXER_CHECK_FRAMES * 2] = {
+		21000, -19500, 27000, -24000, 32767, -28500, 32767, -28000
+	};
+	struct MixerVoice voices[2];
+	struct AudioData data;
+	cc_int32 accum[MIXER_CHECK_FRAMES * 2];
+	cc_int16 out[MIXER_CHECK_FRAMES * 2];
+
+	data.volume = 100; data.rate = 100;
+	data.chunk.data = (void*)mono;   data.chunk.size = sizeof(mono);
+	data.channels   = 1;             data.sampleRate = AUDIO_MIXER_SAMPLE_RATE;
+	MixerVoice_Init(&voices[0], &data, 0, 256, 128);
+
+	data.chunk.data = (void*)stereo; data.chunk.size = sizeof(stereo);
+	data.channels   = 2;             data.sampleRate = AUDIO_MIXER_SAMPLE_RATE / 2;
+	MixerVoice_Init(&voices[1], &data, 0, 256, 256);
+
+	/* Uses its own voices, so doesn't interfere with sounds currently being mixed */
+	MixerVoices_Mix(voices, 2, accum, MIXER_CHECK_FRAMES);
+	AudioMixer_Clip(accum, out, MIXER_CHECK_FRAMES);
+
+	return Mem_Equal(out, expected, sizeof(out)) && !voices[0].active && !voices[1].active;
+}
+
+int AudioMixer_ActiveVoices(void) {
+	int i, count = 0;
+
+	for (i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+	{
+		if (mixer_voices[i].active) count++;
+	}
+	return count;
+}
+
+#ifdef AUDIO_SOFTWARE_MIXER
+static void* mixer_thread;
+static volatile cc_bool mixer_active, mixer_stopping, mixer_joining;
+
+static void AudioMixer_StopAll(void) {
+	int i;
+	Mutex_Lock(mixer_lock);
+	for (i = 0; i < AUDIO_MIXER_MAX_VOICES; i++) { mixer_voices[i].active = false; }
+	Mutex_Unlock(mixer_lock);
+}
+
+static void AudioMixer_RunLoop(void) {
+	struct AudioChunk chunks[AUDIO_MAX_BUFFERS] = { 0 };
+	int inUse, cur = 0;
+	cc_result res;
+
+	if ((res = Audio_Init(&mixer_ctx, AUDIO_MAX_BUFFERS))) goto cleanup;
+	if ((res = StreamContext_SetFormat(&mixer_ctx, 2, AUDIO_MIXER_SAMPLE_RATE, 100))) goto cleanup;
+	if ((res = Audio_AllocChunks(MIXER_CHUNK_FRAMES * 4, chunks, AUDIO_MAX_BUFFERS))) goto cleanup;
+
+	/* Volume is already applied per voice when mixing */
+	Audio_SetVolume(&mixer_ctx, 100);
+	mixer_active = true;
+
+	while (!mixer_stopping) {
+		if ((res = StreamContext_Update(&mixer_ctx, &inUse))) break;
+
+		if (inUse >= AUDIO_MAX_BUFFERS) {
+			Thread_Sleep(5); continue;
+		}
+
+		AudioMixer_Mix((cc_int16*)chunks[cur].data, MIXER_CHUNK_FRAMES);
+		chunks[cur].size = MIXER_CHUNK_FRAMES * 4;
+
+		if ((res = StreamContext_Enqueue(&mixer_ctx, &chunks[cur]))) break;
+		cur = (cur + 1) % AUDIO_MAX_BUFFERS;
+
+		/* Start playing initially, or again after running out of queued audio */
+		if (!inUse && (res = StreamContext_Play(&mixer_ctx))) break;
+	}
+
+cleanup:
+	/* Sounds fall back to the context pool from now on */
+	mixer_active = false;
+	if (res) Audio_Warn(res, "mixing sounds");
+
+	/* must close audio context before freeing the chunks it may still reference */
+	Audio_Close(&mixer_ctx);
+	if (chunks[0].data) Audio_FreeChunks(chunks, AUDIO_MAX_BUFFERS);
+
+	if (mixer_joining) return;
+	Thread_Detach(mixer_thread);
+	mixer_thread = NULL;
+}
+
+static void AudioMixer_Start(void) {
+	if (mixer_thread) return;
+	mixer_joining  = false;
+	mixer_stopping = false;
+
+	Thread_Run(&mixer_thread, AudioMixer_RunLoop, 64 * 1024, "Sound mixer");
+}
+
+static void AudioMixer_Stop(void) {
+	mixer_joining  = true;
+	mixer_stopping = true;
+
+	if (mixer_thread) Thread_Join(mixer_thread);
+	mixer_thread = NULL;
+	AudioMixer_StopAll();
+}
+#else
+#define mixer_active false
+static void AudioMixer_Start(void) { }
+static void AudioMixer_Stop(void)  { }
+#endif
+#endif
+
+
+/*########################################################################################################################*
+*--------------------------------------------------------PCM cache--------------------------------------------------------*
+*#########################################################################################################################*/
+#ifndef CC_BUILD_NOMUSIC
+/* Fully decoded audio, shared between ogg sounds and music tracks decoded ahead of time */
+struct PcmEntry {
+	cc_uint32 key, srcSize, lastUsed;
+	int refs, type;
+	struct Sound pcm;
+	/* Path of the source file (empty for sounds) */
+	cc_string path; char _pathBuffer[FILENAME_SIZE];
+};
+
+#ifdef CC_BUILD_LOWMEM
+#define PCM_CACHE_MAX_BYTES 0
+#else
+/* Max bytes of unreferenced audio kept around (~3 minutes of 44.1 kHz stereo) */
+#define PCM_CACHE_MAX_BYTES (32 * 1024 * 1024)
+#endif
+#define PCM_CACHE_MAX_ENTRIES 256
+/* Entries are keyed by CRC32 and size of the ogg data, and for music also by the file path */
+enum PcmType { PCM_TYPE_SOUND, PCM_TYPE_MUSIC };
+
+static struct PcmEntry pcm_entries[PCM_CACHE_MAX_ENTRIES];
+static cc_uint32 pcm_clock;
+static void* pcm_lock;
+
+/* Frees least recently used unreferenced entries until under the size limit */
+static void PcmCache_Evict(void) {
+	struct PcmEntry* e;
+	struct PcmEntry* lru;
+	cc_uint32 unused;
+	int i;
+
+	for (;;) {
+		lru = NULL; unused = 0;
+
+		for (i = 0; i < PCM_CACHE_MAX_ENTRIES; i++)
+		{
+			e = &pcm_entries[i];
+			if (!e->pcm.chunk.data || e->refs) continue;
+
+			unused += e->pcm.chunk.size;
+			if (!lru || e->lastUsed < lru->lastUsed) lru = e;
+		}
+		if (unused <= PCM_CACHE_MAX_BYTES) return;
+
+		Audio_FreeChunks(&lru->pcm.chunk, 1);
+		lru->pcm.chunk.data = NULL;
+		lru->pcm.chunk.size = 0;
+	}
+}
+
+static cc_bool PcmEntry_Matches(struct PcmEntry* e, int type, cc_uint32 key, cc_uint32 srcSize, const cc_string* path) {
+	if (!e->pcm.chunk.data) return false;
+	if (e->key != key || e->srcSize != srcSize || e->type != type) return false;
+	return path ? String_Equals(&e->path, path) : true;
+}
+
+/* Returns the entry with the given key (and adds a reference to it), or NULL if not cached */
+static struct PcmEntry* PcmCache_Acquire(int type, cc_uint32 key, cc_uint32 srcSize, const cc_string* path) {
+	struct PcmEntry* entry = NULL;
+	int i;
+	Mutex_Lock(pcm_lock);
+
+	for (i = 0; i < PCM_CACHE_MAX_ENTRIES; i++)
+	{
+		if (!PcmEntry_Matches(&pcm_entries[i], type, key, srcSize, path)) continue;
+		entry = &pcm_entries[i];
+		entry->refs++;
+		entry->lastUsed = ++pcm_clock;
+		break;
+	}
+
+	Mutex_Unlock(pcm_lock);
+	return entry;
+}
+
+static void PcmCache_Release(struct PcmEntry* entry) {
+	Mutex_Lock(pcm_lock);
+	entry->refs--;
+	PcmCache_Evict();
+	Mutex_Unlock(pcm_lock);
+}
+
+/* Takes ownership of the given decoded audio, returning a referenced entry for it */
+/* Returns NULL if the cache is full, in which case the caller still owns the audio */
+static struct PcmEntry* PcmCache_Insert(int type, cc_uint32 key, cc_uint32 srcSize, const cc_string* path, 
+										const struct Sound* pcm) {
+	struct PcmEntry* entry = NULL;
+	int i;
+	Mutex_Lock(pcm_lock);
+
+	for (i = 0; i < PCM_CACHE_MAX_ENTRIES; i++)
+	{
+		if (pcm_entries[i].pcm.chunk.data) continue;
+		entry = &pcm_entries[i];
+		entry->key      = key;
+		entry->srcSize  = srcSize;
+		entry->type     = type;
+		entry->refs     = 1;
+		entry->lastUsed = ++pcm_clock;
+		entry->pcm      = *pcm;
+
+		String_InitArray(entry->path, entry->_pathBuffer);
+		if (path) String_Copy(&entry->path, path);
+		break;
+	}
+
+	Mutex_Unlock(pcm_lock);
+	return entry;
+}
+
+static void PcmCache_Init(void) { pcm_lock = Mutex_Create("PCM cache"); }
+
+static void PcmCache_Free(void) {
+	int i;
+	for (i = 0; i < PCM_CACHE_MAX_ENTRIES; i++)
+	{
+		/* Referenced entries are owned by sounds, which are never unloaded */
+		if (!pcm_entries[i].pcm.chunk.data || pcm_entries[i].refs) continue;
+		Audio_FreeChunks(&pcm_entries[i].pcm.chunk, 1);
+		pcm_entries[i].pcm.chunk.data = NULL;
+	}
+	Mutex_Free(pcm_lock);
+}
+
+/* Decodes an entire ogg vorbis stream into 16 bit PCM samples */
+/* Fails with ERR_NOT_SUPPORTED if maxBytes (if non-zero) is exceeded, or if cancel becomes true */
+static cc_result Audio_DecodeOgg(struct Stream* source, struct Sound* snd, cc_uint32 maxBytes, volatile cc_bool* cancel) {
+	struct VorbisState* vorbis = (struct VorbisState*)Mem_TryAllocCleared(1, sizeof(struct VorbisState));
+	struct OggState* ogg       = (struct OggState*)Mem_TryAllocCleared(1, sizeof(struct OggState));
+	cc_int16* samples = NULL;
+	cc_int16* tmp;
+	cc_uint32 count = 0, capacity = 0, frameMax;
+	cc_result res;
+
+	snd->chunk.data = NULL;
+	snd->chunk.size = 0;
+	if (!vorbis || !ogg) { res = ERR_OUT_OF_MEMORY; goto cleanup; }
+
+	Ogg_Init(ogg, source);
+	Vorbis_Init(vorbis);
+	vorbis->source = ogg;
+	if ((res = Vorbis_DecodeHeaders(vorbis))) goto cleanup;
+
+	snd->channels   = vorbis->channels;
+	snd->sampleRate = vorbis->sampleRate;
+	frameMax        = vorbis->blockSizes[1] * vorbis->channels;
+
+	for (;;) {
+		if (cancel && *cancel) { res = ERR_NOT_SUPPORTED; break; }
+		if ((res = Vorbis_DecodeFrame(vorbis))) break;
+
+		if (count + frameMax > capacity) {
+			if (maxBytes && (count + frameMax) * 2 > maxBytes) { res = ERR_NOT_SUPPORTED; break; }
+			capacity = max(capacity * 2, count + frameMax);
+			capacity = max(capacity, 65536);
+			if (maxBytes) capacity = min(capacity, maxBytes / 2);
+
+			tmp = (cc_int16*)Mem_TryRealloc(samples, capacity, 2);
+			if (!tmp) { res = ERR_OUT_OF_MEMORY; break; }
+			samples = tmp;
+		}
+		count += Vorbis_OutputFrame(vorbis, samples + count);
+	}
+
+	if (res != ERR_END_OF_STREAM) goto cleanup;
+	if (!count) { res = ERR_END_OF_STREAM; goto cleanup; }
+
+	/* Backends may need audio data to be in specific memory */
+	if ((res = Audio_AllocChunks(count * 2, &snd->chunk, 1))) goto cleanup;
+	Mem_Copy(snd->chunk.data, samples, count * 2);
+
+cleanup:
+	if (vorbis) Vorbis_Free(vorbis);
+	Mem_Free(samples);
+	Mem_Free(vorbis);
+	Mem_Free(ogg);
+	return res;
+}
+#endif
+
+
 /*########################################################################################################################*
 *--------------------------------------------------------Sounds-----------------------------------------------------------*
 *#########################################################################################################################*/
@@ -63,6 +498,7 @@ void Audio_PlayDigSound(cc_uint8 type)  { }
 void Audio_PlayDigSoundRate(cc_uint8 type, int rate) { }
 void Audio_PlayStepSound(cc_uint8 type) { }
 void Audio_PlayStepSoundVolume(cc_uint8 type, int volume) { }
+void Audio_PlayDigSoundAt(cc_uint8 type, float x, float y, float z) { }
 
 void Sounds_LoadDefault(void) { }
 #else
@@ -119,6 +555,171 @@ static cc_result Sound_ReadWaveData(struct Stream* stream, struct Sound* snd) {
 	}
 }
 
+#ifndef CC_BUILD_NOMUSIC
+/* Ogg sounds are only read into memory while extracting, then decoded in parallel afterwards */
+#define SOUND_DECODE_MAX_JOBS 256
+
+struct SoundDecodeJob {
+	struct Sound* snd;
+	cc_uint8* data;
+	cc_uint32 size, crc;
+	int dupOf; /* Index of earlier job with identical data, or -1 */
+	cc_result res;
+	cc_string file;
+	char _fileBuffer[STRING_SIZE];
+};
+static struct SoundDecodeJob* decode_jobs;
+static int decode_count;
+
+static cc_result Sound_ReadOggData(const cc_string* file, cc_uint8* data, cc_uint32 size, struct Sound* snd) {
+	struct SoundDecodeJob* job;
+	struct PcmEntry* entry;
+	cc_uint32 crc = Utils_CRC32(data, size);
+	int i;
+
+	/* Reuse already decoded audio (e.g. from a previously loaded sound pack) */
+	/* Like sounds, the reference is never released */
+	if ((entry = PcmCache_Acquire(PCM_TYPE_SOUND, crc, size, NULL))) {
+		*snd = entry->pcm;
+		Mem_Free(data);
+		return 0;
+	}
+
+	if (!decode_jobs) {
+		decode_jobs = (struct SoundDecodeJob*)Mem_TryAlloc(SOUND_DECODE_MAX_JOBS, sizeof(struct SoundDecodeJob));
+		if (!decode_jobs) { Mem_Free(data); return ERR_OUT_OF_MEMORY; }
+	}
+	if (decode_count == SOUND_DECODE_MAX_JOBS) { Mem_Free(data); return ERR_NOT_SUPPORTED; }
+
+	job = &decode_jobs[decode_count];
+	job->snd   = snd;
+	job->data  = data;
+	job->size  = size;
+	job->crc   = crc;
+	job->dupOf = -1;
+	job->res   = 0;
+	String_InitArray(job->file, job->_fileBuffer);
+	String_AppendString(&job->file, file);
+
+	/* Sound packs often reuse the same file for several sounds */
+	for (i = 0; i < decode_count; i++)
+	{
+		if (decode_jobs[i].crc != crc || decode_jobs[i].size != size) continue;
+		if (decode_jobs[i].dupOf >= 0) continue;
+		if (!Mem_Equal(decode_jobs[i].data, data, size)) continue;
+
+		job->dupOf = i;
+		job->data  = NULL;
+		Mem_Free(data);
+		break;
+	}
+
+	decode_count++;
+	return 0;
+}
+
+static cc_result Sound_ReadData(const cc_string* file, struct Stream* stream, struct Sound* snd) {
+	static const cc_string ogg = String_FromConst(".ogg");
+	struct Stream mem;
+	cc_uint8* data = NULL;
+	cc_uint8* tmp;
+	cc_uint32 size = 0, capacity = 0, read;
+	cc_result res;
+	if (!String_CaselessEnds(file, &ogg)) return Sound_ReadWaveData(stream, snd);
+
+	/* Zip entry streams don't provide their length, so read until end of stream */
+	for (;;) {
+		if (size == capacity) {
+			capacity = max(capacity * 2, 16384);
+			tmp = (cc_uint8*)Mem_TryRealloc(data, capacity, 1);
+			if (!tmp) { Mem_Free(data); return ERR_OUT_OF_MEMORY; }
+			data = tmp;
+		}
+
+		res = stream->Read(stream, data + size, capacity - size, &read);
+		if (res) { Mem_Free(data); return res; }
+		if (!read) break;
+		size += read;
+	}
+
+	if (size >= 4 && data[0] == 'O' && data[1] == 'g' && data[2] == 'g' && data[3] == 'S')
+		return Sound_ReadOggData(file, data, size, snd);
+
+	/* Some sound packs have .wav files renamed to .ogg */
+	Stream_ReadonlyMemory(&mem, data, size);
+	res = Sound_ReadWaveData(&mem, snd);
+	Mem_Free(data);
+	return res;
+}
+
+static void SoundDecode_Range(void* arg, int beg, int end) {
+	struct SoundDecodeJob* job;
+	struct Stream stream;
+	int i;
+
+	for (i = beg; i < end; i++) {
+		job = &decode_jobs[i];
+		if (job->dupOf >= 0) continue;
+
+		Stream_ReadonlyMemory(&stream, job->data, job->size);
+		job->res = Audio_DecodeOgg(&stream, job->snd, 0, NULL);
+	}
+}
+
+/* Decodes all queued ogg sounds, then adds them to the PCM cache */
+static void SoundDecode_RunAll(void) {
+	struct SoundDecodeJob* job;
+	int i;
+	if (!decode_count) return;
+
+	Jobs_ParallelFor(decode_count, 1, SoundDecode_Range, NULL);
+
+	for (i = 0; i < decode_count; i++)
+	{
+		job = &decode_jobs[i];
+		if (job->dupOf >= 0) {
+			job->res  = decode_jobs[job->dupOf].res;
+			*job->snd = *decode_jobs[job->dupOf].snd;
+		} else if (!job->res) {
+			/* Sounds are never unloaded, so the reference is never released */
+			/* (if the cache is full, the sound just keeps sole ownership) */
+			PcmCache_Insert(PCM_TYPE_SOUND, job->crc, job->size, NULL, job->snd);
+		}
+
+		if (job->res) Logger_SysWarn2(job->res, "decoding", &job->file);
+		Mem_Free(job->data);
+	}
+
+	Mem_Free(decode_jobs);
+	decode_jobs  = NULL;
+	decode_count = 0;
+}
+#else
+static cc_result Sound_ReadData(const cc_string* file, struct Stream* stream, struct Sound* snd) {
+	return Sound_ReadWaveData(stream, snd);
+}
+static void SoundDecode_RunAll(void) { }
+#endif
+
+/* Removes sounds that failed to decode in SoundDecode_RunAll */
+static void Soundboard_Compact(struct Soundboard* board) {
+	struct SoundGroup* group;
+	int i, j, count;
+
+	for (i = 0; i < SOUND_COUNT; i++)
+	{
+		group = &board->groups[i];
+		count = 0;
+
+		for (j = 0; j < group->count; j++)
+		{
+			if (!group->sounds[j].chunk.size) continue;
+			group->sounds[count++] = group->sounds[j];
+		}
+		group->count = count;
+	}
+}
+
 static struct SoundGroup* Soundboard_FindGroup(struct Soundboard* board, const cc_string* name) {
 	struct SoundGroup* groups = board->groups;
 	int i;
@@ -156,7 +757,7 @@ static void Soundboard_Load(struct Soundboard* board, const cc_string* boardName
 	}
 
 	snd = &group->sounds[group->count];
-	res = Sound_ReadWaveData(stream, snd);
+	res = Sound_ReadData(file, stream, snd);
 
 	if (res) {
 		Logger_SysWarn2(res, "decoding", file);
@@ -187,10 +788,64 @@ CC_NOINLINE static void Sounds_Fail(cc_result res) {
 	Audio_SetSounds(0);
 }
 
-static void Sounds_Play(cc_uint8 type, struct Soundboard* board) {
+/* Sounds further away than this from the player can't be heard */
+#define SOUNDS_MAX_DISTANCE 40.0f
+/* Sounds closer than this to the player are always played at full volume */
+#define SOUNDS_FULL_DISTANCE 2.0f
+
+/* Calculates the left/right gains (0 to 256) of a sound at the given position relative to the player */
+/* Returns false if the sound is too far away to be heard */
+static cc_bool Sounds_CalcGains(const Vec3* pos, int* gainL, int* gainR) {
+	struct Entity* p = &Entities.CurPlayer->Base;
+	Vec3 eye = Entity_GetEyePosition(p);
+	float dx = pos->x - eye.x, dy = pos->y - eye.y, dz = pos->z - eye.z;
+	float dist = Math_SqrtF(dx * dx + dy * dy + dz * dz);
+	float atten, pan = 0.0f, yaw;
+
+	if (dist >= SOUNDS_MAX_DISTANCE) return false;
+	atten = 1.0f - (dist - SOUNDS_FULL_DISTANCE) / (SOUNDS_MAX_DISTANCE - SOUNDS_FULL_DISTANCE);
+	atten = dist <= SOUNDS_FULL_DISTANCE ? 1.0f : atten * atten;
+
+	/* Pan by how far the sound is to the right of the direction the player faces */
+	if (dist > 0.001f) {
+		yaw = p->Yaw * MATH_DEG2RAD;
+		pan = (dx * Math_CosF(yaw) + dz * Math_SinF(yaw)) / dist;
+	}
+
+	*gainL = (int)(256 * atten * min(1.0f, Math_SqrtF(1.0f - pan)));
+	*gainR = (int)(256 * atten * min(1.0f, Math_SqrtF(1.0f + pan)));
+	return true;
+}
+
+static int Sounds_Priority(cc_uint8 type, struct Soundboard* board) {
+	if (board == &stepBoard) return 0;
+
+	if (type == SOUND_EXPLODE || type == SOUND_EXPLODE_BIG) return 3;
+	if (type >= SOUND_FUSE) return 2;
+	return 1;
+}
+
+/* Plays the given sound, from the given position in the world if pos is non NULL */
+static void Sounds_Submit(struct AudioData* data, int priority, const Vec3* pos) {
+	int gainL = 256, gainR = 256;
+	cc_result res;
+	if (pos && !Sounds_CalcGains(pos, &gainL, &gainR)) return;
+
+	if (mixer_active) {
+		AudioMixer_Play(data, priority, gainL, gainR); return;
+	}
+
+	/* Pooled backend contexts can't pan, so only attenuate */
+	data->volume = data->volume * (gainL + gainR) / 512;
+	if (!data->volume) return;
+
+	res = AudioPool_Play(data);
+	if (res) Sounds_Fail(res);
+}
+
+static void Sounds_Play(cc_uint8 type, struct Soundboard* board, const Vec3* pos) {
 	const struct Sound* snd;
 	struct AudioData data;
-	cc_result res;
 
 	if (type == SOUND_NONE || !Audio_SoundsVolume) return;
 	snd = Soundboard_PickRandom(board, type);
@@ -204,8 +859,7 @@ static void Sounds_Play(cc_uint8 type, struct Soundboard* board) {
 		data.sampleRate = snd->sampleRate;
 		data.rate       = 60; /* lower pitch = deeper, bigger explosion */
 		data.volume     = min(Audio_SoundsVolume * 2, 100);
-		res = AudioPool_Play(&data);
-		if (res) Sounds_Fail(res);
+		Sounds_Submit(&data, Sounds_Priority(type, board), pos);
 		return;
 	}
 
@@ -233,18 +887,19 @@ static void Sounds_Play(cc_uint8 type, struct Soundboard* board) {
 		data.volume /= 2;
 		if (type == SOUND_METAL) data.rate = 140;
 	}
-	
-	res = AudioPool_Play(&data);
-	if (res) Sounds_Fail(res);
+	Sounds_Submit(&data, Sounds_Priority(type, board), pos);
 }
 
 static void Audio_PlayBlockSound(void* obj, IVec3 coords, BlockID old, BlockID now) {
+	Vec3 pos;
+	pos.x = coords.x + 0.5f; pos.y = coords.y + 0.5f; pos.z = coords.z + 0.5f;
+
 	if (now == BLOCK_AIR) {
-		Audio_PlayDigSound(Blocks.DigSounds[old]);
+		Sounds_Play(Blocks.DigSounds[old], &digBoard, &pos);
 	} else if (!Game_ClassicMode) {
 		/* use StepSounds instead when placing, as don't want */
 		/*  to play glass break sound when placing glass */
-		Audio_PlayDigSound(Blocks.StepSounds[now]);
+		Sounds_Play(Blocks.StepSounds[now], &digBoard, &pos);
 	}
 }
 
@@ -268,7 +923,7 @@ static void ProcessDoorSound(const cc_string* file, struct Stream* stream) {
 	if (group->count == Array_Elems(group->sounds)) return;
 	
 	snd = &group->sounds[group->count];
-	res = Sound_ReadWaveData(stream, snd);
+	res = Sound_ReadData(file, stream, snd);
 	
 	if (res) {
 		Logger_SysWarn2(res, "decoding", file);
@@ -303,7 +958,7 @@ static void ProcessButtonSound(const cc_string* file, struct Stream* stream) {
 	if (group->count == Array_Elems(group->sounds)) return;
 	
 	snd = &group->sounds[group->count];
-	res = Sound_ReadWaveData(stream, snd);
+	res = Sound_ReadData(file, stream, snd);
 	
 	if (res) {
 		Logger_SysWarn2(res, "decoding", file);
@@ -342,7 +997,7 @@ static void ProcessTNTSound(const cc_string* file, struct Stream* stream) {
 	if (group->count == Array_Elems(group->sounds)) return;
 	
 	snd = &group->sounds[group->count];
-	res = Sound_ReadWaveData(stream, snd);
+	res = Sound_ReadData(file, stream, snd);
 	
 	if (res) {
 		Logger_SysWarn2(res, "decoding", file);
@@ -372,7 +1027,7 @@ static void ProcessHurtSound(const cc_string* file, struct Stream* stream) {
 	if (group->count == Array_Elems(group->sounds)) return;
 	
 	snd = &group->sounds[group->count];
-	res = Sound_ReadWaveData(stream, snd);
+	res = Sound_ReadData(file, stream, snd);
 	
 	if (res) {
 		Logger_SysWarn2(res, "decoding", file);
@@ -402,7 +1057,7 @@ static void ProcessShootSound(const cc_string* file, struct Stream* stream) {
 	if (group->count == Array_Elems(group->sounds)) return;
 	
 	snd = &group->sounds[group->count];
-	res = Sound_ReadWaveData(stream, snd);
+	res = Sound_ReadData(file, stream, snd);
 	
 	if (res) {
 		Logger_SysWarn2(res, "decoding", file);
@@ -431,7 +1086,7 @@ static void ProcessPickupSound(const cc_string* file, struct Stream* stream) {
 	if (group->count == Array_Elems(group->sounds)) return;
 
 	snd = &group->sounds[group->count];
-	res = Sound_ReadWaveData(stream, snd);
+	res = Sound_ReadData(file, stream, snd);
 
 	if (res) {
 		Logger_SysWarn2(res, "decoding", file);
@@ -493,7 +1148,7 @@ static void ProcessMobSounds(const cc_string* file, struct Stream* stream) {
 	if (group->count == Array_Elems(group->sounds)) return;
 
 	snd = &group->sounds[group->count];
-	res = Sound_ReadWaveData(stream, snd);
+	res = Sound_ReadData(file, stream, snd);
 
 	if (res) {
 		Logger_SysWarn2(res, "decoding", file);
@@ -541,6 +1196,10 @@ static cc_result Sounds_ExtractZip(const cc_string* path) {
 						entries, Array_Elems(entries));
 	if (res) Logger_IOWarn2(res, "extracting", &raw_path);
 
+	SoundDecode_RunAll();
+	Soundboard_Compact(&digBoard);
+	Soundboard_Compact(&stepBoard);
+
 	/* No point logging error for closing readonly file */
 	(void)stream.Close(&stream);
 	return res;
@@ -560,26 +1219,40 @@ static void Sounds_Start(void) {
 		return; 
 	}
 
+	AudioMixer_Start();
+
 	if (sounds_loaded) return;
 	sounds_loaded = true;
 	AudioBackend_LoadSounds();
 }
 
-static void Sounds_Stop(void) { AudioPool_Close(); }
+static void Sounds_Stop(void) { 
+	AudioMixer_Stop();
+	AudioPool_Close(); 
+}
 
 static void Sounds_Init(void) {
 	int volume = Options_GetInt(OPT_SOUND_VOLUME, 0, 100, DEFAULT_SOUNDS_VOLUME);
+	mixer_lock = Mutex_Create("Sound mixer");
 	Audio_SetSounds(volume);
 	Event_Register_(&UserEvents.BlockChanged, NULL, Audio_PlayBlockSound);
 }
-static void Sounds_Free(void) { Sounds_Stop(); }
+static void Sounds_Free(void) { 
+	Sounds_Stop(); 
+	Mutex_Free(mixer_lock);
+}
 
-void Audio_PlayDigSound(cc_uint8 type)  { Sounds_Play(type, &digBoard); }
+void Audio_PlayDigSound(cc_uint8 type)  { Sounds_Play(type, &digBoard, NULL); }
+
+void Audio_PlayDigSoundAt(cc_uint8 type, float x, float y, float z) {
+	Vec3 pos;
+	pos.x = x; pos.y = y; pos.z = z;
+	Sounds_Play(type, &digBoard, &pos);
+}
 
 void Audio_PlayDigSoundRate(cc_uint8 type, int rate) {
 	const struct Sound* snd;
 	struct AudioData data;
-	cc_result res;
 
 	if (type == SOUND_NONE || !Audio_SoundsVolume) return;
 	snd = Soundboard_PickRandom(&digBoard, type);
@@ -590,17 +1263,14 @@ void Audio_PlayDigSoundRate(cc_uint8 type, int rate) {
 	data.sampleRate = snd->sampleRate;
 	data.rate       = rate;
 	data.volume     = Audio_SoundsVolume;
-
-	res = AudioPool_Play(&data);
-	if (res) Sounds_Fail(res);
+	Sounds_Submit(&data, Sounds_Priority(type, &digBoard), NULL);
 }
 
-void Audio_PlayStepSound(cc_uint8 type) { Sounds_Play(type, &stepBoard); }
+void Audio_PlayStepSound(cc_uint8 type) { Sounds_Play(type, &stepBoard, NULL); }
 
 void Audio_PlayStepSoundVolume(cc_uint8 type, int volume) {
 	const struct Sound* snd;
 	struct AudioData data;
-	cc_result res;
 
 	if (type == SOUND_NONE || !Audio_SoundsVolume) return;
 	snd = Soundboard_PickRandom(&stepBoard, type);
@@ -611,9 +1281,7 @@ void Audio_PlayStepSoundVolume(cc_uint8 type, int volume) {
 	data.sampleRate = snd->sampleRate;
 	data.rate       = 100;
 	data.volume     = volume;
-
-	res = AudioPool_Play(&data);
-	if (res) Sounds_Fail(res);
+	Sounds_Submit(&data, Sounds_Priority(type, &stepBoard), NULL);
 }
 #endif
 
@@ -636,17 +1304,31 @@ static void* music_waitable;
 static volatile cc_bool music_stopping, music_joining;
 static int music_minDelay, music_maxDelay;
 
-static cc_result Music_Buffer(struct AudioChunk* chunk, int maxSamples, struct VorbisState* ctx) {
+struct MusicSource {
+	struct VorbisState* vorbis; /* Decodes audio frame by frame, if non NULL */
+	const cc_int16* pcm;        /* Otherwise plays already decoded audio */
+	cc_uint32 pcmLeft;
+};
+
+static cc_result Music_Buffer(struct AudioChunk* chunk, int maxSamples, struct MusicSource* src) {
 	int samples = 0;
 	cc_int16* cur;
 	cc_result res = 0, res2;
 	cc_int16* data = (cc_int16*)chunk->data;
 
-	while (samples < maxSamples) {
-		if ((res = Vorbis_DecodeFrame(ctx))) break;
+	if (src->vorbis) {
+		while (samples < maxSamples) {
+			if ((res = Vorbis_DecodeFrame(src->vorbis))) break;
 
-		cur = &data[samples];
-		samples += Vorbis_OutputFrame(ctx, cur);
+			cur = &data[samples];
+			samples += Vorbis_OutputFrame(src->vorbis, cur);
+		}
+	} else {
+		samples = (int)min((cc_uint32)maxSamples, src->pcmLeft);
+		Mem_Copy(data, src->pcm, samples * 2);
+		src->pcm     += samples;
+		src->pcmLeft -= samples;
+		if (!src->pcmLeft) res = ERR_END_OF_STREAM;
 	}
 
 	chunk->size = samples * 2;
@@ -655,38 +1337,15 @@ static cc_result Music_Buffer(struct AudioChunk* chunk, int maxSamples, struct V
 	return res;
 }
 
-static cc_result Music_PlayOgg(struct Stream* source) {
-	int channels, sampleRate, volume;
-	int chunkSize, samplesPerSecond;
+/* Streams audio from the given source until it ends or music is stopped */
+/* chunkSize is the max samples Music_Buffer can produce for roughly one second of audio */
+static cc_result Music_Play(struct MusicSource* src, int channels, int sampleRate, int chunkSize) {
 	struct AudioChunk chunks[AUDIO_MAX_BUFFERS] = { 0 };
-	int inUse, i, cur;
+	int inUse, i, cur, volume;
+	int samplesPerSecond = channels * sampleRate;
 	cc_result res;
 
-#if CC_BUILD_MAXSTACK <= (64 * 1024)
-	struct VorbisState* vorbis = (struct VorbisState*)Mem_TryAllocCleared(1, sizeof(struct VorbisState));
-	struct OggState* ogg = (struct OggState*)Mem_TryAllocCleared(1, sizeof(struct OggState));
-	if (!vorbis || !ogg) return ERR_OUT_OF_MEMORY;
-#else
-	struct OggState _ogg;
-	struct OggState* ogg = &_ogg;
-	struct VorbisState _vorbis;
-	struct VorbisState* vorbis = &_vorbis;
-#endif
-
-	Ogg_Init(ogg, source);
-	Vorbis_Init(vorbis);
-	vorbis->source = ogg;
-	if ((res = Vorbis_DecodeHeaders(vorbis))) goto cleanup;
-	
-	channels   = vorbis->channels;
-	sampleRate = vorbis->sampleRate;
 	if ((res = StreamContext_SetFormat(&music_ctx, channels, sampleRate, 100))) goto cleanup;
-
-	/* largest possible vorbis frame decodes to blocksize1 * channels samples, */
-	/*  so can end up decoding slightly over a second of audio */
-	chunkSize        = channels * (sampleRate + vorbis->blockSizes[1]);
-	samplesPerSecond = channels * sampleRate;
-
 	if ((res = Audio_AllocChunks(chunkSize * 2, chunks, AUDIO_MAX_BUFFERS))) goto cleanup;
     volume = Audio_MusicVolume;
     Audio_SetVolume(&music_ctx, volume);	
@@ -694,7 +1353,7 @@ static cc_result Music_PlayOgg(struct Stream* source) {
 	/* fill up with some samples before playing */
 	for (i = 0; i < AUDIO_MAX_BUFFERS && !res; i++) 
 	{
-		res = Music_Buffer(&chunks[i], samplesPerSecond, vorbis);
+		res = Music_Buffer(&chunks[i], samplesPerSecond, src);
 	}
 	if (music_stopping) goto cleanup;
 
@@ -726,7 +1385,7 @@ static cc_result Music_PlayOgg(struct Stream* source) {
 			Thread_Sleep(10); continue;
 		}
 
-		res = Music_Buffer(&chunks[cur], samplesPerSecond, vorbis);
+		res = Music_Buffer(&chunks[cur], samplesPerSecond, src);
 		cur = (cur + 1) % AUDIO_MAX_BUFFERS;
 
 		/* need to specially handle last bit of audio */
@@ -748,12 +1407,111 @@ static cc_result Music_PlayOgg(struct Stream* source) {
 
 cleanup:
 	Audio_FreeChunks(chunks, AUDIO_MAX_BUFFERS);
+	return res == ERR_END_OF_STREAM ? 0 : res;
+}
+
+static cc_result Music_PlayOgg(struct Stream* source) {
+	struct MusicSource src = { 0 };
+	int channels, sampleRate;
+	cc_result res;
+
+#if CC_BUILD_MAXSTACK <= (64 * 1024)
+	struct VorbisState* vorbis = (struct VorbisState*)Mem_TryAllocCleared(1, sizeof(struct VorbisState));
+	struct OggState* ogg = (struct OggState*)Mem_TryAllocCleared(1, sizeof(struct OggState));
+	if (!vorbis || !ogg) return ERR_OUT_OF_MEMORY;
+#else
+	struct OggState _ogg;
+	struct OggState* ogg = &_ogg;
+	struct VorbisState _vorbis;
+	struct VorbisState* vorbis = &_vorbis;
+#endif
+
+	Ogg_Init(ogg, source);
+	Vorbis_Init(vorbis);
+	vorbis->source = ogg;
+	if ((res = Vorbis_DecodeHeaders(vorbis))) goto cleanup;
+	
+	channels   = vorbis->channels;
+	sampleRate = vorbis->sampleRate;
+	src.vorbis = vorbis;
+
+	/* largest possible vorbis frame decodes to blocksize1 * channels samples, */
+	/*  so can end up decoding slightly over a second of audio */
+	res = Music_Play(&src, channels, sampleRate, channels * (sampleRate + vorbis->blockSizes[1]));
+
+cleanup:
 	Vorbis_Free(vorbis);
 #if CC_BUILD_MAXSTACK <= (64 * 1024)
 	Mem_Free(ogg);
 	Mem_Free(vorbis);
 #endif
-	return res == ERR_END_OF_STREAM ? 0 : res;
+	return res;
+}
+
+static cc_result Music_PlayCached(struct PcmEntry* entry) {
+	struct MusicSource src = { 0 };
+	const struct Sound* pcm = &entry->pcm;
+
+	src.pcm     = (const cc_int16*)pcm->chunk.data;
+	src.pcmLeft = pcm->chunk.size / 2;
+	return Music_Play(&src, pcm->channels, pcm->sampleRate, pcm->channels * pcm->sampleRate);
+}
+
+/* Calculates CRC32 and size of the given music file's contents, so edited or replaced files aren't */
+/*  mistaken for the previously cached decoded track */
+static cc_result Music_CacheKey(const cc_string* path, cc_uint32* key, cc_uint32* size) {
+	cc_uint8 buffer[4096];
+	cc_uint32 crc = 0xffffffffUL, read, i;
+	struct Stream stream;
+	cc_filepath raw_path;
+	cc_result res;
+	*size = 0;
+
+	Platform_EncodePath(&raw_path, path);
+	if ((res = Stream_OpenPath(&stream, &raw_path))) return res;
+
+	for (;;) {
+		res = stream.Read(&stream, buffer, sizeof(buffer), &read);
+		if (res || !read) break;
+
+		for (i = 0; i < read; i++) {
+			crc = Utils_Crc32Table[(crc ^ buffer[i]) & 0xFF] ^ (crc >> 8);
+		}
+		*size += read;
+	}
+
+	/* No point logging error for closing readonly file */
+	(void)stream.Close(&stream);
+	*key = crc ^ 0xffffffffUL;
+	return res;
+}
+
+/* Decodes the given music file into the PCM cache, so that playing it later doesn't decode on the fly */
+static void Music_DecodeAhead(const cc_string* path) {
+	struct PcmEntry* entry;
+	struct Stream stream;
+	struct Sound pcm;
+	cc_filepath raw_path;
+	cc_uint32 key, size;
+	cc_result res;
+	if (!PCM_CACHE_MAX_BYTES) return;
+
+	if (Music_CacheKey(path, &key, &size)) return;
+	if ((entry = PcmCache_Acquire(PCM_TYPE_MUSIC, key, size, path))) { PcmCache_Release(entry); return; }
+
+	Platform_EncodePath(&raw_path, path);
+	if (Stream_OpenPath(&stream, &raw_path)) return;
+
+	/* Tracks too large to cache are just streamed instead */
+	res = Audio_DecodeOgg(&stream, &pcm, PCM_CACHE_MAX_BYTES, &music_stopping);
+	(void)stream.Close(&stream);
+	if (res) { Audio_FreeChunks(&pcm.chunk, 1); return; }
+
+	if ((entry = PcmCache_Insert(PCM_TYPE_MUSIC, key, size, path, &pcm))) {
+		PcmCache_Release(entry);
+	} else {
+		Audio_FreeChunks(&pcm.chunk, 1);
+	}
 }
 
 static void Music_AddFile(const cc_string* path, void* obj, int isDirectory) {
@@ -769,11 +1527,14 @@ static void Music_AddFile(const cc_string* path, void* obj, int isDirectory) {
 
 static void Music_RunLoop(void) {
 	struct StringsBuffer files;
+	struct PcmEntry* entry;
 	cc_string path;
 	RNGState rnd;
 	struct Stream stream;
 	cc_filepath raw_path;
-	int idx, delay;
+	cc_uint64 beg;
+	cc_uint32 key, size;
+	int idx, delay, elapsed;
 	cc_result res = 0;
 
 	StringsBuffer_SetLengthBits(&files, STRINGSBUFFER_DEF_LEN_SHIFT);
@@ -783,25 +1544,43 @@ static void Music_RunLoop(void) {
 	Random_SeedFromCurrentTime(&rnd);
 	res = Audio_Init(&music_ctx, AUDIO_MAX_BUFFERS);
 	if (res) music_stopping = true;
+	idx = files.count ? Random_Next(&rnd, files.count) : 0;
 
 	while (!music_stopping && files.count) {
-		idx  = Random_Next(&rnd, files.count);
 		path = StringsBuffer_UNSAFE_Get(&files, idx);
 		Platform_Log1("playing music file: %s", &path);
 
-		Platform_EncodePath(&raw_path, &path);
-		res = Stream_OpenPath(&stream, &raw_path);
-		if (res) { Logger_IOWarn2(res, "opening", &raw_path); break; }
+		entry = NULL;
+		if (PCM_CACHE_MAX_BYTES && !Music_CacheKey(&path, &key, &size))
+			entry = PcmCache_Acquire(PCM_TYPE_MUSIC, key, size, &path);
 
-		res = Music_PlayOgg(&stream);
-		if (res) { Logger_SimpleWarn2(res, "playing", &path); }
+		if (entry) {
+			res = Music_PlayCached(entry);
+			PcmCache_Release(entry);
+			if (res) { Logger_SimpleWarn2(res, "playing", &path); }
+		} else {
+			Platform_EncodePath(&raw_path, &path);
+			res = Stream_OpenPath(&stream, &raw_path);
+			if (res) { Logger_IOWarn2(res, "opening", &raw_path); break; }
 
-		/* No point logging error for closing readonly file */
-		(void)stream.Close(&stream);
+			res = Music_PlayOgg(&stream);
+			if (res) { Logger_SimpleWarn2(res, "playing", &path); }
+
+			/* No point logging error for closing readonly file */
+			(void)stream.Close(&stream);
+		}
 
 		if (music_stopping) break;
 		delay = Random_Range(&rnd, music_minDelay, music_maxDelay);
-		Waitable_WaitFor(music_waitable, delay);
+
+		/* Decode the next track in the meantime, instead of while it is playing */
+		idx  = Random_Next(&rnd, files.count);
+		path = StringsBuffer_UNSAFE_Get(&files, idx);
+		beg  = Stopwatch_Measure();
+		Music_DecodeAhead(&path);
+
+		elapsed = Stopwatch_ElapsedMS(beg, Stopwatch_Measure());
+		if (elapsed < delay) Waitable_WaitFor(music_waitable, delay - elapsed);
 	}
 
 	if (res) {
@@ -874,6 +1653,9 @@ void Audio_SetMusic(int volume) {
 
 static void OnInit(void) {
 	Utils_EnsureDirectory("audio");
+#ifndef CC_BUILD_NOMUSIC
+	PcmCache_Init();
+#endif
 
 	Sounds_Init();
 	Music_Init();
@@ -882,6 +1664,9 @@ static void OnInit(void) {
 static void OnFree(void) {
 	Sounds_Free();
 	Music_Free();
+#ifndef CC_BUILD_NOMUSIC
+	PcmCache_Free();
+#endif
 	AudioBackend_Free();
 }
 
@@ -52,6 +52,9 @@ void Audio_PlayDigSound(cc_uint8 type);
 void Audio_PlayDigSoundRate(cc_uint8 type, int rate);
 void Audio_PlayStepSound(cc_uint8 type);
 void Audio_PlayStepSoundVolume(cc_uint8 type, int volume);
+/* Plays a dig sound as if it came from the given position in the world */
+/* The sound is attenuated by its distance from the player, and also panned when the software mixer is used */
+void Audio_PlayDigSoundAt(cc_uint8 type, float x, float y, float z);
 #define AUDIO_MAX_BUFFERS 4
 
 cc_bool AudioBackend_Init(void);
@@ -77,6 +80,7 @@ cc_result Audio_AllocChunks(cc_uint32 size, struct AudioChunk* chunks, int numCh
 void Audio_FreeChunks(struct AudioChunk* chunks, int numChunks);
 
 extern struct AudioContext music_ctx;
+extern struct AudioContext mixer_ctx;
 void Audio_Warn(cc_result res, const char* action);
 
 cc_result AudioPool_Play(struct AudioData* data);
@@ -115,6 +119,28 @@ cc_result SoundContext_PlayData(struct AudioContext* ctx, struct AudioData* data
 cc_result SoundContext_PollBusy(struct AudioContext* ctx, cc_bool* isBusy);
 
 
+/*########################################################################################################################*
+*-----------------------------------------------------Software mixer------------------------------------------------------*
+*#########################################################################################################################*/
+/* Sounds are mixed in software into a single stereo stream, instead of each using their own backend context */
+#define AUDIO_MIXER_MAX_VOICES  48
+#define AUDIO_MIXER_SAMPLE_RATE 44100
+
+/* Starts playing the given audio data on a free mixer voice, with left/right gains from 0 to 256 */
+/* If all voices are busy, the voice with the lowest priority (and then quietest) is stolen instead */
+/* Returns false if all voices are busy playing sounds of higher priority */
+cc_bool AudioMixer_Play(const struct AudioData* data, int priority, int gainL, int gainR);
+/* Mixes the next given number of stereo frames of all playing voices into dst */
+/* NOTE: This can be called directly without an output stream (e.g. for headless testing) */
+void AudioMixer_Mix(cc_int16* dst, int frames);
+/* Returns the number of voices that are currently playing */
+int  AudioMixer_ActiveVoices(void);
+/* Mixes a couple of short known sounds into a buffer and checks the mixed output is as expected */
+/* NOTE: Doesn't need an output device, so can be used to check the mixer when running headless */
+/* NOTE: Not available when compiled without sound (CC_BUILD_NOSOUNDS) */
+cc_bool AudioMixer_Check(void);
+
+
 /*########################################################################################################################*
 *---------------------------------------------------------Sounds---------------------------------------------------------*
 *#########################################################################################################################*/
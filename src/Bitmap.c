@@ -114,12 +114,37 @@ cc_bool Png_Detect(const cc_uint8* data, cc_uint32 len) {
 	return len >= PNG_SIG_SIZE && Mem_Equal(data, pngSig, PNG_SIG_SIZE);
 }
 
+/* Also identifies streams made by Png_DecodedStream */
+static cc_result Png_DecodedClose(struct Stream* s) { return 0; }
+
+void Png_DecodedStream(struct Stream* s, void* data, cc_uint32 len, struct Bitmap* bmp) {
+	Stream_ReadonlyMemory(s, data, len);
+	s->Close = Png_DecodedClose;
+	s->meta.mem.decoded = bmp;
+}
+
+/* Hands out the bitmap previously decoded from the given stream, if there is one */
+static cc_bool Png_TakeDecoded(struct Bitmap* bmp, struct Stream* stream) {
+	struct Bitmap* decoded;
+	if (stream->Close != Png_DecodedClose) return false;
+
+	decoded = (struct Bitmap*)stream->meta.mem.decoded;
+	if (!decoded->scan0) return false;
+
+	*bmp = *decoded;
+	decoded->scan0 = NULL;
+	return true;
+}
+
 
 /*########################################################################################################################*
 *------------------------------------------------------PNG decoder--------------------------------------------------------*
 *#########################################################################################################################*/
 #if !defined CC_BUILD_COMPRESSION
-cc_result Png_Decode(struct Bitmap* bmp, struct Stream* stream) {
+cc_bool Png_UseSIMD = false;
+
+cc_result Png_DecodeWith(struct Bitmap* bmp, struct Stream* stream, cc_bool simd) {
+	if (Png_TakeDecoded(bmp, stream)) return 0;
 	return ERR_NOT_SUPPORTED;
 }
 #else
@@ -152,8 +177,172 @@ static void Png_ReconstructFirst(cc_uint8 type, cc_uint8 bytesPerPixel, cc_uint8
 	}
 }
 
-static void Png_Reconstruct(cc_uint8 type, cc_uint8 bytesPerPixel, cc_uint8* line, cc_uint8* prior, cc_uint32 lineLen) {
+/* Reconstructs scanlines using SSE2/NEON, producing identical results to Png_Reconstruct */
+/* Sub/Average/Paeth depend on the previous pixel, so only the bytes of each pixel are done in parallel */
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PNG_SIMD
+cc_bool Png_UseSIMD = true;
+
+static CC_INLINE __m128i Png_LoadPixel(const cc_uint8* p, int bpp) {
+	cc_uint32 v = p[0] | (p[1] << 8) | (p[2] << 16);
+	if (bpp == 4) v |= (cc_uint32)p[3] << 24;
+	return _mm_cvtsi32_si128((int)v);
+}
+
+static CC_INLINE void Png_StorePixel(cc_uint8* p, __m128i x, int bpp) {
+	cc_uint32 v = (cc_uint32)_mm_cvtsi128_si32(x);
+	p[0] = (cc_uint8)v; p[1] = (cc_uint8)(v >> 8); p[2] = (cc_uint8)(v >> 16);
+	if (bpp == 4) p[3] = (cc_uint8)(v >> 24);
+}
+
+#define Png_Abs16(v) _mm_max_epi16(v, _mm_sub_epi16(zero, v))
+#define Png_Select(mask, x, y) _mm_or_si128(_mm_and_si128(mask, x), _mm_andnot_si128(mask, y))
+
+static cc_bool Png_ReconstructSIMD(cc_uint8 type, int bpp, cc_uint8* line, cc_uint8* prior, cc_uint32 lineLen) {
+	const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi8(1);
+	__m128i a = zero, b, c = zero, x, pa, pb, pc, notA, useC;
+	cc_uint32 i;
+
+	if (type == PNG_FILTER_UP) {
+		for (i = 0; i + 16 <= lineLen; i += 16) 
+		{
+			x = _mm_add_epi8(_mm_loadu_si128((__m128i*)(line + i)), _mm_loadu_si128((__m128i*)(prior + i)));
+			_mm_storeu_si128((__m128i*)(line + i), x);
+		}
+		for (; i < lineLen; i++) { line[i] += prior[i]; }
+		return true;
+	}
+	if (bpp != 3 && bpp != 4) return false;
+
+	switch (type) {
+	case PNG_FILTER_SUB:
+		for (i = 0; i < lineLen; i += bpp) 
+		{
+			a = _mm_add_epi8(Png_LoadPixel(line + i, bpp), a);
+			Png_StorePixel(line + i, a, bpp);
+		}
+		return true;
+
+	case PNG_FILTER_AVERAGE:
+		for (i = 0; i < lineLen; i += bpp) 
+		{
+			/* _mm_avg_epu8 rounds up, whereas (a + b) >> 1 rounds down */
+			b = Png_LoadPixel(prior + i, bpp);
+			x = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+			a = _mm_add_epi8(Png_LoadPixel(line + i, bpp), x);
+			Png_StorePixel(line + i, a, bpp);
+		}
+		return true;
+
+	case PNG_FILTER_PAETH:
+		/* a, b and c are widened to 16 bits, as p = a + b - c can be outside 0-255 */
+		for (i = 0; i < lineLen; i += bpp) 
+		{
+			b  = _mm_unpacklo_epi8(Png_LoadPixel(prior + i, bpp), zero);
+			pa = _mm_sub_epi16(b, c); /* p - a */
+			pb = _mm_sub_epi16(a, c); /* p - b */
+			pc = _mm_add_epi16(pa, pb);
+			pa = Png_Abs16(pa); pb = Png_Abs16(pb); pc = Png_Abs16(pc);
+
+			notA = _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc));
+			useC = _mm_cmpgt_epi16(pb, pc);
+			x    = Png_Select(notA, Png_Select(useC, c, b), a);
+
+			x = _mm_add_epi8(Png_LoadPixel(line + i, bpp), _mm_packus_epi16(x, x));
+			Png_StorePixel(line + i, x, bpp);
+			a = _mm_unpacklo_epi8(x, zero);
+			c = b;
+		}
+		return true;
+	}
+	return false;
+}
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define PNG_SIMD
+cc_bool Png_UseSIMD = true;
+
+static CC_INLINE uint8x8_t Png_LoadPixel(const cc_uint8* p, int bpp) {
+	cc_uint32 v = p[0] | (p[1] << 8) | (p[2] << 16);
+	if (bpp == 4) v |= (cc_uint32)p[3] << 24;
+	return vreinterpret_u8_u32(vdup_n_u32(v));
+}
+
+static CC_INLINE void Png_StorePixel(cc_uint8* p, uint8x8_t x, int bpp) {
+	cc_uint32 v = vget_lane_u32(vreinterpret_u32_u8(x), 0);
+	p[0] = (cc_uint8)v; p[1] = (cc_uint8)(v >> 8); p[2] = (cc_uint8)(v >> 16);
+	if (bpp == 4) p[3] = (cc_uint8)(v >> 24);
+}
+
+#define Png_Widen(x) vreinterpretq_s16_u16(vmovl_u8(x))
+
+static cc_bool Png_ReconstructSIMD(cc_uint8 type, int bpp, cc_uint8* line, cc_uint8* prior, cc_uint32 lineLen) {
+	uint8x8_t a = vdup_n_u8(0), x;
+	int16x8_t a16 = vdupq_n_s16(0), b16, c16 = vdupq_n_s16(0), pa, pb, pc, p;
+	uint16x8_t notA, useC;
+	cc_uint32 i;
+
+	if (type == PNG_FILTER_UP) {
+		for (i = 0; i + 16 <= lineLen; i += 16) 
+		{
+			vst1q_u8(line + i, vaddq_u8(vld1q_u8(line + i), vld1q_u8(prior + i)));
+		}
+		for (; i < lineLen; i++) { line[i] += prior[i]; }
+		return true;
+	}
+	if (bpp != 3 && bpp != 4) return false;
+
+	switch (type) {
+	case PNG_FILTER_SUB:
+		for (i = 0; i < lineLen; i += bpp) 
+		{
+			a = vadd_u8(Png_LoadPixel(line + i, bpp), a);
+			Png_StorePixel(line + i, a, bpp);
+		}
+		return true;
+
+	case PNG_FILTER_AVERAGE:
+		for (i = 0; i < lineLen; i += bpp) 
+		{
+			x = vhadd_u8(a, Png_LoadPixel(prior + i, bpp));
+			a = vadd_u8(Png_LoadPixel(line + i, bpp), x);
+			Png_StorePixel(line + i, a, bpp);
+		}
+		return true;
+
+	case PNG_FILTER_PAETH:
+		/* a, b and c are widened to 16 bits, as p = a + b - c can be outside 0-255 */
+		for (i = 0; i < lineLen; i += bpp) 
+		{
+			b16 = Png_Widen(Png_LoadPixel(prior + i, bpp));
+			pa  = vsubq_s16(b16, c16); /* p - a */
+			pb  = vsubq_s16(a16, c16); /* p - b */
+			pc  = vabsq_s16(vaddq_s16(pa, pb));
+			pa  = vabsq_s16(pa); pb = vabsq_s16(pb);
+
+			notA = vorrq_u16(vcgtq_s16(pa, pb), vcgtq_s16(pa, pc));
+			useC = vcgtq_s16(pb, pc);
+			p    = vbslq_s16(notA, vbslq_s16(useC, c16, b16), a16);
+
+			x = vadd_u8(Png_LoadPixel(line + i, bpp), vmovn_u16(vreinterpretq_u16_s16(p)));
+			Png_StorePixel(line + i, x, bpp);
+			a16 = Png_Widen(x);
+			c16 = b16;
+		}
+		return true;
+	}
+	return false;
+}
+#else
+cc_bool Png_UseSIMD = false;
+#endif
+
+static void Png_Reconstruct(cc_uint8 type, cc_uint8 bytesPerPixel, cc_uint8* line, cc_uint8* prior, cc_uint32 lineLen, cc_bool simd) {
 	cc_uint32 i, j;
+#ifdef PNG_SIMD
+	if (simd && Png_ReconstructSIMD(type, bytesPerPixel, line, prior, lineLen)) return;
+#endif
 
 	switch (type) {
 	case PNG_FILTER_SUB:
@@ -241,6 +430,91 @@ static void Png_Expand_GRAYSCALE_8(int width, BitmapCol* palette, cc_uint8* src,
 	for (; width > 0; width--) { PNG_Do_Grayscale_8(); }
 }
 
+/* Converts RGB/RGBA pixels into BGRA bitmap colours using SSE2/NEON */
+#if defined PNG_SIMD && BITMAPCOLOR_B_SHIFT == 0 && BITMAPCOLOR_R_SHIFT == 16 && BITMAPCOLOR_A_SHIFT == 24
+#define PNG_EXPAND_SIMD
+
+#ifdef __ARM_NEON
+/* Number of leading pixels in a row that Png_ExpandRGB_SIMD can process */
+#define PNG_RGB_SIMD_PIXELS(width) ((width) & ~15)
+
+/* NOTE: Processed in backwards order, same as Png_Expand_RGB_8 */
+static void Png_ExpandRGB_SIMD(int count, cc_uint8* src, BitmapCol* dst) {
+	uint8x16x3_t rgb;
+	uint8x16x4_t bgra;
+	int i;
+	bgra.val[3] = vdupq_n_u8(255);
+
+	for (i = count - 16; i >= 0; i -= 16) 
+	{
+		rgb = vld3q_u8(src + i * 3);
+		bgra.val[0] = rgb.val[2]; bgra.val[1] = rgb.val[1]; bgra.val[2] = rgb.val[0];
+		vst4q_u8((cc_uint8*)(dst + i), bgra);
+	}
+}
+
+/* Returns number of leading pixels processed */
+static int Png_ExpandRGBA_SIMD(int width, cc_uint8* src, BitmapCol* dst) {
+	uint8x16x4_t px;
+	uint8x16_t tmp;
+	int i;
+
+	for (i = 0; i + 16 <= width; i += 16) 
+	{
+		px = vld4q_u8(src + i * 4);
+		tmp = px.val[0]; px.val[0] = px.val[2]; px.val[2] = tmp;
+		vst4q_u8((cc_uint8*)(dst + i), px);
+	}
+	return i;
+}
+#else
+/* Number of leading pixels in a row that Png_ExpandRGB_SIMD can process */
+/* (16 bytes are read for each 4 pixels, so the last couple of pixels must be done without SIMD) */
+#define PNG_RGB_SIMD_PIXELS(width) ((width) >= 2 ? ((width) - 2) & ~3 : 0)
+
+/* Swaps R and B in each pixel, and sets A to 255 if fillA is all 1s */
+static CC_INLINE __m128i Png_SwapRB(__m128i px, __m128i keepMask, __m128i fillA) {
+	const __m128i rbMask = _mm_set1_epi32(0x00FF00FF);
+	__m128i rb = _mm_and_si128(px, rbMask);
+	__m128i ga = _mm_or_si128(_mm_and_si128(px, keepMask), fillA);
+	return _mm_or_si128(ga, _mm_or_si128(_mm_srli_epi32(rb, 16), _mm_slli_epi32(rb, 16)));
+}
+
+/* NOTE: Processed in backwards order, same as Png_Expand_RGB_8 */
+static void Png_ExpandRGB_SIMD(int count, cc_uint8* src, BitmapCol* dst) {
+	const __m128i gMask = _mm_set1_epi32(0x0000FF00);
+	const __m128i aFill = _mm_set1_epi32((int)0xFF000000);
+	__m128i v, lo, hi;
+	int i;
+
+	for (i = count - 4; i >= 0; i -= 4) 
+	{
+		/* Spread the 12 bytes of 4 RGB pixels out to one pixel per 32 bit lane */
+		v  = _mm_loadu_si128((__m128i*)(src + i * 3));
+		lo = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+		hi = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+		v  = _mm_unpacklo_epi64(lo, hi);
+		_mm_storeu_si128((__m128i*)(dst + i), Png_SwapRB(v, gMask, aFill));
+	}
+}
+
+/* Returns number of leading pixels processed */
+static int Png_ExpandRGBA_SIMD(int width, cc_uint8* src, BitmapCol* dst) {
+	const __m128i gaMask = _mm_set1_epi32((int)0xFF00FF00);
+	const __m128i zero   = _mm_setzero_si128();
+	__m128i v;
+	int i;
+
+	for (i = 0; i + 4 <= width; i += 4) 
+	{
+		v = _mm_loadu_si128((__m128i*)(src + i * 4));
+		_mm_storeu_si128((__m128i*)(dst + i), Png_SwapRB(v, gaMask, zero));
+	}
+	return i;
+}
+#endif
+#endif
+
 static void Png_Expand_RGB_8(int width, BitmapCol* palette, cc_uint8* src, BitmapCol* dst) {
 	src += (width - 1) * 3;
 	dst += (width - 1);
@@ -252,6 +526,15 @@ static void Png_Expand_RGB_8(int width, BitmapCol* palette, cc_uint8* src, Bitma
 	for (; width > 0; width--) { PNG_Do_RGB__8(); }
 }
 
+#ifdef PNG_EXPAND_SIMD
+static void Png_Expand_RGB_8_SIMD(int width, BitmapCol* palette, cc_uint8* src, BitmapCol* dst) {
+	int simd = PNG_RGB_SIMD_PIXELS(width);
+	/* Trailing pixels are done first, as pixels must be processed backwards */
+	Png_Expand_RGB_8(width - simd, palette, src + simd * 3, dst + simd);
+	if (simd) Png_ExpandRGB_SIMD(simd, src, dst);
+}
+#endif
+
 static void Png_Expand_INDEXED_1(int width, BitmapCol* palette, cc_uint8* src, BitmapCol* dst) {
 	int i; /* NOTE: not optimised */
 	for (i = width - 1; i >= 0; i--) { dst[i] = palette[PNG_Get__1(i)]; }
@@ -292,7 +575,6 @@ static void Png_Expand_GRAYSCALE_A_8(int width, BitmapCol* palette, cc_uint8* sr
 
 static void Png_Expand_RGB_A_8(int width, BitmapCol* palette, cc_uint8* src, BitmapCol* dst) {
 	/* Processed in forward order */
-
 	for (; width >= 4; width -= 4) {
 		PNG_Do_RGB_A__8(); PNG_Do_RGB_A__8();
 		PNG_Do_RGB_A__8(); PNG_Do_RGB_A__8();
@@ -300,7 +582,17 @@ static void Png_Expand_RGB_A_8(int width, BitmapCol* palette, cc_uint8* src, Bit
 	for (; width > 0; width--) { PNG_Do_RGB_A__8(); }
 }
 
-static Png_RowExpander Png_GetExpander(cc_uint8 col, cc_uint8 bitsPerSample) {
+#ifdef PNG_EXPAND_SIMD
+static void Png_Expand_RGB_A_8_SIMD(int width, BitmapCol* palette, cc_uint8* src, BitmapCol* dst) {
+	int simd = Png_ExpandRGBA_SIMD(width, src, dst);
+	Png_Expand_RGB_A_8(width - simd, palette, src + simd * 4, dst + simd);
+}
+#else
+#define Png_Expand_RGB_8_SIMD   Png_Expand_RGB_8
+#define Png_Expand_RGB_A_8_SIMD Png_Expand_RGB_A_8
+#endif
+
+static Png_RowExpander Png_GetExpander(cc_uint8 col, cc_uint8 bitsPerSample, cc_bool simd) {
 	switch (col) {
 	case PNG_COLOR_GRAYSCALE:
 		switch (bitsPerSample) {
@@ -313,7 +605,7 @@ static Png_RowExpander Png_GetExpander(cc_uint8 col, cc_uint8 bitsPerSample) {
 
 	case PNG_COLOR_RGB:
 		switch (bitsPerSample) {
-		case 8:  return Png_Expand_RGB_8;
+		case 8:  return simd ? Png_Expand_RGB_8_SIMD : Png_Expand_RGB_8;
 		}
 		return NULL;
 
@@ -334,7 +626,7 @@ static Png_RowExpander Png_GetExpander(cc_uint8 col, cc_uint8 bitsPerSample) {
 
 	case PNG_COLOR_RGB_A:
 		switch (bitsPerSample) {
-		case 8:  return Png_Expand_RGB_A_8;
+		case 8:  return simd ? Png_Expand_RGB_A_8_SIMD : Png_Expand_RGB_A_8;
 		}
 		return NULL;
 	}
@@ -367,7 +659,7 @@ static BitmapCol ExpandRGB(cc_uint8 bitsPerSample, int r, int g, int b) {
 	return BitmapCol_Make(r, g, b, 0);
 }
 
-cc_result Png_Decode(struct Bitmap* bmp, struct Stream* stream) {
+cc_result Png_DecodeWith(struct Bitmap* bmp, struct Stream* stream, cc_bool simd) {
 	cc_uint8 tmp[64];
 	cc_uint32 dataSize, fourCC;
 	cc_result res;
@@ -402,6 +694,7 @@ cc_result Png_Decode(struct Bitmap* bmp, struct Stream* stream) {
 	int zlib_state = ZLIB_STATE_COMPRESSION_METHOD;
 	cc_uint8* data = NULL;
 
+	if (Png_TakeDecoded(bmp, stream)) return 0;
 	bmp->width = 0; bmp->height = 0;
 	bmp->scan0 = NULL;
 
@@ -436,7 +729,7 @@ cc_result Png_Decode(struct Bitmap* bmp, struct Stream* stream) {
 			bitsPerSample = tmp[8]; colorspace = tmp[9];
 			if (bitsPerSample == 16) return PNG_ERR_16BITSAMPLES;
 
-			rowExpander = Png_GetExpander(colorspace, bitsPerSample);
+			rowExpander = Png_GetExpander(colorspace, bitsPerSample, simd);
 			if (!rowExpander) return PNG_ERR_INVALID_COL_BPP;
 
 			if (tmp[10] != 0) return PNG_ERR_COMP_METHOD;
@@ -536,7 +829,7 @@ cc_result Png_Decode(struct Bitmap* bmp, struct Stream* stream) {
 					Png_ReconstructFirst(scanline[0], bytesPerPixel, &scanline[1], scanlineSize);
 				} else {
 					cc_uint8* prior = &data[(rowY - 1) * scanlineBytes];
-					Png_Reconstruct(scanline[0], bytesPerPixel, &scanline[1], &prior[1], scanlineSize);
+					Png_Reconstruct(scanline[0], bytesPerPixel, &scanline[1], &prior[1], scanlineSize, simd);
 					
 					/* With the RGBA colourspace, each scanline is (1 + width*4) bytes wide */
 					/* Therefore once a row has been reconstructed, the prior row can be converted */
@@ -587,6 +880,10 @@ cc_result Png_Decode(struct Bitmap* bmp, struct Stream* stream) {
 }
 #endif
 
+cc_result Png_Decode(struct Bitmap* bmp, struct Stream* stream) {
+	return Png_DecodeWith(bmp, stream, Png_UseSIMD);
+}
+
 
 /*########################################################################################################################*
 *------------------------------------------------------PNG encoder--------------------------------------------------------*
@@ -597,6 +894,10 @@ cc_result Png_Encode(struct Bitmap* bmp, struct Stream* stream,
 					Png_RowGetter getRow, cc_bool alpha, void* ctx) {
 	return ERR_NOT_SUPPORTED;
 }
+
+void Png_SetCapture(struct Bitmap* bmp) {
+	if (bmp) bmp->scan0 = NULL;
+}
 #else
 static void Png_Filter(cc_uint8 filter, const cc_uint8* cur, const cc_uint8* prior, cc_uint8* best, int lineLen, int bpp) {
 	/* 3 bytes per pixel constant */
@@ -698,29 +999,184 @@ static void Png_EncodeRow(const cc_uint8* cur, const cc_uint8* prior, cc_uint8*
 }
 
 static BitmapCol* DefaultGetRow(struct Bitmap* bmp, int y, void* ctx) { return Bitmap_GetRow(bmp, y); }
-static cc_result Png_EncodeCore(struct Bitmap* bmp, struct Stream* stream, cc_uint8* buffer,
+
+/* Filters rows from beg to end, then writes them to the given stream */
+/* If adler32 is non NULL, it is updated with the filtered data written */
+static cc_result Png_WriteRows(struct Bitmap* bmp, struct Stream* dst, int beg, int end, cc_uint32* adler32,
 					Png_RowGetter getRow, cc_bool alpha, void* ctx) {
-	cc_uint8 tmp[32];
-	cc_uint8* prevLine = buffer;
-	cc_uint8*  curLine = buffer + (bmp->width * 4) * 1;
-	cc_uint8* bestLine = buffer + (bmp->width * 4) * 2;
+	cc_uint8* buffer;
+	cc_uint8* prevLine;
+	cc_uint8*  curLine;
+	cc_uint8* bestLine;
+	int y, lineSize;
+	cc_result res = 0;
+
+	/* Add 1 for scanline filter type byter */
+	buffer = (cc_uint8*)Mem_TryAlloc(3, bmp->width * 4 + 1);
+	if (!buffer) return ERR_OUT_OF_MEMORY;
+
+	prevLine = buffer;
+	curLine  = buffer + (bmp->width * 4) * 1;
+	bestLine = buffer + (bmp->width * 4) * 2;
+	lineSize = bmp->width * (alpha ? 4 : 3);
+
+	/* Row is filtered based on the row before, even when that row is written by another band */
+	if (beg) {
+		Png_MakeRow(getRow(bmp, beg - 1, ctx), (beg & 1) == 0 ? prevLine : curLine, lineSize, alpha);
+	} else {
+		Mem_Set(prevLine, 0, lineSize);
+	}
+
+	for (y = beg; y < end; y++) {
+		BitmapCol* src = getRow(bmp, y, ctx);
+		cc_uint8* prev = (y & 1) == 0 ? prevLine : curLine;
+		cc_uint8* cur  = (y & 1) == 0 ? curLine  : prevLine;
+
+		Png_MakeRow(src, cur, lineSize, alpha);
+		Png_EncodeRow(cur, prev, bestLine, lineSize, alpha);
+
+		/* +1 for filter byte */
+		if (adler32) *adler32 = ZLib_Adler32(*adler32, bestLine, lineSize + 1);
+		if ((res = Stream_Write(dst, bestLine, lineSize + 1))) break;
+	}
+
+	Mem_Free(buffer);
+	return res;
+}
 
+/* Filters and compresses all rows into a ZLIB stream, one after another */
+static cc_result Png_WriteData(struct Bitmap* bmp, struct Stream* dst, 
+					Png_RowGetter getRow, cc_bool alpha, void* ctx) {
 #if CC_BUILD_MAXSTACK <= (64 * 1024)
 	struct ZLibState* zlState = (struct ZLibState*)Mem_TryAlloc(1, sizeof(struct ZLibState));
 #else
 	struct ZLibState _zlState;
 	struct ZLibState* zlState = &_zlState;
 #endif
-	struct Stream chunk, zlStream;
+	struct Stream zlStream;
+	cc_result res;
+	if (!zlState) return ERR_OUT_OF_MEMORY;
+
+	ZLib_MakeStream(&zlStream, zlState, dst); 
+	res = Png_WriteRows(bmp, &zlStream, 0, bmp->height, NULL, getRow, alpha, ctx);
+	if (res) return res;
+	return zlStream.Close(&zlStream);
+}
+
+
+/* Larger images are split into bands of rows, which are then filtered and compressed in parallel */
+/* Each band is compressed as a separate DEFLATE segment, which are then joined into one ZLIB stream */
+#define PNG_MIN_BAND_ROWS 64
+#define PNG_MAX_BANDS 32
+struct PngBand {
+	struct Bitmap* bmp;
+	int beg, end;
+	cc_bool alpha;
+	cc_result res;
+	cc_uint8* data;
+	cc_uint32 size, rawSize, adler32;
+};
+
+static void Png_EncodeBand(struct PngBand* band) {
+	struct Bitmap* bmp = band->bmp;
+	struct DeflateState* state;
+	struct Stream mem, stream;
+	cc_uint32 capacity;
+
+	band->rawSize = (band->end - band->beg) * (bmp->width * (band->alpha ? 4 : 3) + 1);
+	band->adler32 = 1;
+	/* Fixed huffman codes use at most 9 bits per byte, plus a few bytes for block headers */
+	capacity   = band->rawSize + band->rawSize / 8 + 64;
+	band->data = (cc_uint8*)Mem_TryAlloc(capacity, 1);
+	state      = (struct DeflateState*)Mem_TryAlloc(1, sizeof(struct DeflateState));
+
+	if (!band->data || !state) {
+		band->res = ERR_OUT_OF_MEMORY;
+		Mem_Free(state); return;
+	}
+	Stream_WriteonlyMemory(&mem, band->data, capacity);
+
+	/* Only the last band marks the end of the DEFLATE data */
+	if (band->end == bmp->height) {
+		Deflate_MakeStream(&stream, state, &mem);
+	} else {
+		Deflate_MakeSegment(&stream, state, &mem);
+	}
+
+	band->res = Png_WriteRows(bmp, &stream, band->beg, band->end, &band->adler32, DefaultGetRow, band->alpha, NULL);
+	if (!band->res) band->res = stream.Close(&stream);
+	if (!band->res) band->res = mem.Position(&mem, &band->size);
+	Mem_Free(state);
+}
+
+static void Png_EncodeBands(void* arg, int beg, int end) {
+	struct PngBand* bands = (struct PngBand*)arg;
+	for (; beg < end; beg++) Png_EncodeBand(&bands[beg]);
+}
+
+/* Returns number of bands to split the image into (1 if it should just be encoded serially) */
+static int Png_CalcBands(struct Bitmap* bmp, Png_RowGetter getRow) {
+	int bands;
+	/* Row getters might reuse a buffer for the returned row (e.g. converting from framebuffer format) */
+	if (getRow || !Jobs_WorkerCount()) return 1;
+
+	/* A couple of bands per thread, so that threads finishing early can help with the rest */
+	bands = (Jobs_WorkerCount() + 1) * 2;
+	bands = min(bands, PNG_MAX_BANDS);
+	return min(bands, bmp->height / PNG_MIN_BAND_ROWS);
+}
+
+/* Filters and compresses bands of rows in parallel, then writes them as one ZLIB stream */
+/* NOTE: Nothing is written to dst if ERR_OUT_OF_MEMORY is returned */
+static cc_result Png_WriteBands(struct Bitmap* bmp, struct Stream* dst, int count, cc_bool alpha) {
+	static const cc_uint8 header[2] = { 0x78, 0x9C }; /* ZLib header */
+	struct PngBand bands[PNG_MAX_BANDS];
+	cc_uint32 adler32 = 1;
+	cc_uint8 tmp[4];
+	cc_result res = 0;
+	int i, rows;
+
+	rows = (bmp->height + count - 1) / count;
+	for (i = 0; i < count; i++) 
+	{
+		bands[i].bmp   = bmp;
+		bands[i].beg   = i * rows;
+		bands[i].end   = min(bmp->height, (i + 1) * rows);
+		bands[i].alpha = alpha;
+		bands[i].res   = 0;
+		bands[i].data  = NULL;
+		bands[i].size  = 0;
+	}
+	Jobs_ParallelFor(count, 1, Png_EncodeBands, bands);
+
+	for (i = 0; i < count && !res; i++) { res = bands[i].res; }
+	if (res) goto finished;
+	if ((res = Stream_Write(dst, header, sizeof(header)))) goto finished;
+
+	for (i = 0; i < count; i++) 
+	{
+		if ((res = Stream_Write(dst, bands[i].data, bands[i].size))) goto finished;
+		adler32 = i ? ZLib_CombineAdler32(adler32, bands[i].adler32, bands[i].rawSize) : bands[i].adler32;
+	}
+	Stream_SetU32_BE(tmp, adler32);
+	res = Stream_Write(dst, tmp, 4);
+
+finished:
+	for (i = 0; i < count; i++) { Mem_Free(bands[i].data); }
+	return res;
+}
+
+static cc_result Png_EncodeCore(struct Bitmap* bmp, struct Stream* stream, 
+					Png_RowGetter getRow, cc_bool alpha, void* ctx) {
+	cc_uint8 tmp[32];
+	struct Stream chunk;
 	cc_uint32 stream_end, stream_beg;
-	int y, lineSize;
+	int bands;
 	cc_result res;
 
-	if (!zlState) return ERR_OUT_OF_MEMORY;
 	/* stream may not start at 0 (e.g. when making default.zip) */
 	if ((res = stream->Position(stream, &stream_beg))) return res;
 
-	if (!getRow) getRow = DefaultGetRow;
 	if ((res = Stream_Write(stream, pngSig, PNG_SIG_SIZE))) return res;
 	Stream_WriteonlyCrc32(&chunk, stream);
 
@@ -744,22 +1200,15 @@ static cc_result Png_EncodeCore(struct Bitmap* bmp, struct Stream* stream, cc_ui
 	Stream_SetU32_BE(&tmp[0], PNG_FourCC('I','D','A','T'));
 	if ((res = Stream_Write(&chunk, tmp, 4))) return res;
 
-	ZLib_MakeStream(&zlStream, zlState, &chunk); 
-	lineSize = bmp->width * (alpha ? 4 : 3);
-	Mem_Set(prevLine, 0, lineSize);
+	bands = Png_CalcBands(bmp, getRow);
+	res   = bands > 1 ? Png_WriteBands(bmp, &chunk, bands, alpha) : 0;
 
-	for (y = 0; y < bmp->height; y++) {
-		BitmapCol* src = getRow(bmp, y, ctx);
-		cc_uint8* prev = (y & 1) == 0 ? prevLine : curLine;
-		cc_uint8* cur  = (y & 1) == 0 ? curLine  : prevLine;
-
-		Png_MakeRow(src, cur, lineSize, alpha);
-		Png_EncodeRow(cur, prev, bestLine, lineSize, alpha);
-
-		/* +1 for filter byte */
-		if ((res = Stream_Write(&zlStream, bestLine, lineSize + 1))) return res;
+	/* Small images aren't worth splitting up, and fallback when not enough memory for each band */
+	if (bands <= 1 || res == ERR_OUT_OF_MEMORY) {
+		if (!getRow) getRow = DefaultGetRow;
+		res = Png_WriteData(bmp, &chunk, getRow, alpha, ctx);
 	}
-	if ((res = zlStream.Close(&zlStream))) return res;
+	if (res) return res;
 	Stream_SetU32_BE(&tmp[0], chunk.meta.crc32.crc32 ^ 0xFFFFFFFFUL);
 
 	/* Write end chunk */
@@ -777,16 +1226,32 @@ static cc_result Png_EncodeCore(struct Bitmap* bmp, struct Stream* stream, cc_ui
 	return stream->Seek(stream, stream_end);
 }
 
+static struct Bitmap* png_capture;
+void Png_SetCapture(struct Bitmap* bmp) {
+	png_capture = bmp;
+	if (bmp) bmp->scan0 = NULL;
+}
+
+static cc_result Png_Capture(struct Bitmap* bmp, Png_RowGetter getRow, void* ctx) {
+	struct Bitmap* dst = png_capture;
+	int y;
+
+	png_capture = NULL;
+	if (!getRow) getRow = DefaultGetRow;
+	Bitmap_TryAllocate(dst, bmp->width, bmp->height);
+	if (!dst->scan0) return ERR_OUT_OF_MEMORY;
+
+	for (y = 0; y < bmp->height; y++) 
+	{
+		Mem_Copy(Bitmap_GetRow(dst, y), getRow(bmp, y, ctx), bmp->width * BITMAPCOLOR_SIZE);
+	}
+	return 0;
+}
+
 cc_result Png_Encode(struct Bitmap* bmp, struct Stream* stream, 
 					Png_RowGetter getRow, cc_bool alpha, void* ctx) {
-	cc_result res;
-	/* Add 1 for scanline filter type byter */
-	cc_uint8* buffer = (cc_uint8*)Mem_TryAlloc(3, bmp->width * 4 + 1);
-	if (!buffer) return ERR_NOT_SUPPORTED;
-
-	res = Png_EncodeCore(bmp, stream, buffer, getRow, alpha, ctx);
-	Mem_Free(buffer);
-	return res;
+	if (png_capture) return Png_Capture(bmp, getRow, ctx);
+	return Png_EncodeCore(bmp, stream, getRow, alpha, ctx);
 }
 #endif
 
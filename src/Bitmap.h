@@ -128,6 +128,11 @@ CC_API void Bitmap_Scale(struct Bitmap* dst, struct Bitmap* src,
 #define PNG_MAX_DIMS 0x8000
 #endif
 
+/* Whether Png_Decode uses SSE2/NEON instructions to unfilter and convert rows */
+/* (always false when compiled without SSE2/NEON support) */
+/* NOTE: Images may be decoded on other threads, use Png_DecodeWith instead of changing this */
+extern cc_bool Png_UseSIMD;
+
 /* Whether data starts with PNG format signature/identifier. */
 cc_bool Png_Detect(const cc_uint8* data, cc_uint32 len);
 typedef BitmapCol* (*Png_RowGetter)(struct Bitmap* bmp, int row, void* ctx);
@@ -137,11 +142,23 @@ typedef BitmapCol* (*Png_RowGetter)(struct Bitmap* bmp, int row, void* ctx);
      https://github.com/nothings/stb/blob/master/stb_image.h
 */
 CC_API cc_result Png_Decode(struct Bitmap* bmp, struct Stream* stream);
+/* Same as Png_Decode, except that SSE2/NEON instructions are only used if simd is true */
+/* (simd is ignored when compiled without SSE2/NEON support) */
+cc_result Png_DecodeWith(struct Bitmap* bmp, struct Stream* stream, cc_bool simd);
+/* Wraps a readonly memory stream around the given .png data, that also carries the already decoded bmp */
+/*  Png_Decode on this stream then returns bmp instead of decoding the stream again */
+/* NOTE: bmp->scan0 is set to NULL when handed out, as the caller then owns the pixels */
+void Png_DecodedStream(struct Stream* s, void* data, cc_uint32 len, struct Bitmap* bmp);
 /* Encodes a bitmap in PNG format. */
 /* getRow is optional. Can be used to modify how rows are encoded. (e.g. flip image) */
 /* if alpha is non-zero, RGBA channels are saved, otherwise only RGB channels are. */
+/* NOTE: Large images without a getRow are filtered and compressed on multiple threads */
 cc_result Png_Encode(struct Bitmap* bmp, struct Stream* stream, 
 						Png_RowGetter getRow, cc_bool alpha, void* ctx);
+/* Makes the next Png_Encode call just copy the image's rows into bmp, instead of encoding to the stream */
+/* (e.g. to capture a screenshot now, but encode it later on a background thread) */
+/* NOTE: bmp->scan0 is left NULL if Png_Encode is never called, otherwise you must free it */
+void Png_SetCapture(struct Bitmap* bmp);
 
 CC_END_HEADER
 #endif
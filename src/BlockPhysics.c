@@ -2678,7 +2678,7 @@ void TNT_ExplodeRadius(int x, int y, int z, int power) {
 }
 
 void TNT_Explode(int x, int y, int z) {
-	Audio_PlayDigSound(SOUND_EXPLODE);
+	Audio_PlayDigSoundAt(SOUND_EXPLODE, x + 0.5f, y + 0.5f, z + 0.5f);
 	TNT_ExplodeRadius(x, y, z, TNT_POWER);
 }
 
@@ -2751,7 +2751,7 @@ void TNT_ScheduleFuse(int x, int y, int z) {
 	tnt_fuseQueue[tnt_fuseCount].z = z;
 	tnt_fuseQueue[tnt_fuseCount].ticksLeft = TNT_FUSE_TICKS;
 	tnt_fuseCount++;
-	Audio_PlayDigSound(SOUND_FUSE);
+	Audio_PlayDigSoundAt(SOUND_FUSE, x + 0.5f, y + 0.5f, z + 0.5f);
 }
 
 /* Schedule a TNT fuse with custom tick count (for chain reactions) */
@@ -3071,9 +3071,12 @@ void Physics_Tick(void) {
 	if (Gui_GetInputGrab()) return;
 
 	/*if ((tickCount % 5) == 0) {*/
+	Profiler_Begin("Physics_LiquidQueues");
 	Physics_TickLava();
 	Physics_TickWater();
+	Profiler_End();
 	/*}*/
+	Profiler_Begin("Physics_RedstoneQueues");
 	Redstone_TickTorchQueue();
 	Redstone_TickButtonQueue();
 	Redstone_TickPressurePlates();
@@ -3081,6 +3084,10 @@ void Physics_Tick(void) {
 	Redstone_TickIronDoors();
 	Redstone_TickTNT();
 	Redstone_TickTNTFuse();
+	Profiler_End();
 	physics_tickCount++;
+
+	Profiler_Begin("Physics_RandomBlocks");
 	Physics_TickRandomBlocks();
+	Profiler_End();
 }
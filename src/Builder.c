@@ -54,6 +54,68 @@ The first ATLAS1D_MAX_ATLASES parts are for normal parts, remainder are for tran
 static CC_BIG_VAR struct Builder1DPart Builder_Parts[ATLAS1D_MAX_ATLASES * 2];
 static struct VertexTextured* Builder_Vertices;
 
+#ifdef CC_GFX_CHUNK_VERTICES
+/* Chunk meshes are built with full precision vertices, then packed into the compact chunk vertex format */
+static struct VertexTextured* stagingVertices;
+static int stagingCount;
+
+static struct VertexTextured* Builder_AllocStaging(int count) {
+	if (count > stagingCount) {
+		stagingCount    = max(count, stagingCount * 2);
+		stagingVertices = (struct VertexTextured*)Mem_Realloc(stagingVertices, stagingCount,
+													sizeof(struct VertexTextured), "chunk staging vertices");
+	}
+	return stagingVertices;
+}
+
+static cc_int16 Builder_PackPos(float value, int origin) {
+	/* Adding 32768 before truncating rounds towards negative infinity instead of zero */
+	return (cc_int16)((int)((value - origin) * CHUNK_VERTEX_POS_SCALE + 32768.5f) - 32768);
+}
+
+static cc_uint16 Builder_PackUV(float value, float scale) {
+	/* Converting an out of range float to an integer is undefined behaviour */
+	value *= scale;
+	if (value <= 0.0f)     return 0;
+	if (value >= 65535.0f) return 65535;
+	return (cc_uint16)(value + 0.5f);
+}
+
+static void Builder_PackVertex(struct VertexChunk* dst, const struct VertexTextured* src, int x1, int y1, int z1) {
+	dst->x   = Builder_PackPos(src->x, x1);
+	dst->y   = Builder_PackPos(src->y, y1);
+	dst->z   = Builder_PackPos(src->z, z1);
+	dst->pad = 0;
+	dst->Col = src->Col;
+	dst->U   = Builder_PackUV(src->U, CHUNK_VERTEX_U_SCALE);
+	dst->V   = Builder_PackUV(src->V, CHUNK_VERTEX_V_SCALE);
+}
+
+/* Packs the staging vertices, plus an extra zeroed vertex (see Builder_MakeChunk) */
+static void Builder_PackVertices(struct VertexChunk* dst, int count, int x1, int y1, int z1) {
+	struct VertexTextured* src = stagingVertices;
+	int i;
+
+	for (i = 0; i < count; i++, src++, dst++)
+	{
+		Builder_PackVertex(dst, src, x1, y1, z1);
+	}
+	Mem_Set(dst, 0, sizeof(struct VertexChunk));
+}
+
+#ifndef CHUNK_VB_ARENA
+static GfxResourceID Builder_CreatePackedVb(int count, int x1, int y1, int z1) {
+	/* add an extra element to fix crashing on some GPUs */
+	GfxResourceID vb = Gfx_CreateVb(VERTEX_FORMAT_CHUNK, count + 1);
+	struct VertexChunk* dst = (struct VertexChunk*)Gfx_LockVb(vb, VERTEX_FORMAT_CHUNK, count + 1);
+
+	Builder_PackVertices(dst, count, x1, y1, z1);
+	Gfx_UnlockVb(vb);
+	return vb;
+}
+#endif
+#endif
+
 static int Builder1DPart_VerticesCount(struct Builder1DPart* part) {
 	int i, count = part->sCount;
 	for (i = 0; i < FACE_COUNT; i++) { count += part->faces.count[i]; }
@@ -433,7 +495,12 @@ void Builder_MakeChunk(struct ChunkInfo* info) {
 	
 	OutputChunkPartsMeta(x1, y1, z1, info);
 
-#if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
+#if defined CC_GFX_CHUNK_VERTICES
+	Builder_Vertices = Builder_AllocStaging(totalVerts);
+#elif defined CHUNK_VB_ARENA
+	/* add an extra element to fix crashing on some GPUs */
+	Builder_Vertices = (struct VertexTextured*)MapRenderer_AllocVertices(info, totalVerts + 1);
+#elif CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
 	/* add an extra element to fix crashing on some GPUs */
 	info->vb = Gfx_CreateVb(VERTEX_FORMAT_TEXTURED, totalVerts + 1);
 	Builder_Vertices = (struct VertexTextured*)Gfx_LockVb(info->vb,
@@ -470,6 +537,15 @@ void Builder_MakeChunk(struct ChunkInfo* info) {
 		BuildPartVbs(&MapRenderer_PartsNormal[curIdx]);
 		BuildPartVbs(&MapRenderer_PartsTranslucent[curIdx]);
 	}
+#elif defined CHUNK_VB_ARENA && defined CC_GFX_CHUNK_VERTICES
+	/* add an extra element to fix crashing on some GPUs */
+	Builder_PackVertices((struct VertexChunk*)MapRenderer_AllocVertices(info, totalVerts + 1), 
+							totalVerts, x1, y1, z1);
+	MapRenderer_SubmitVertices(info);
+#elif defined CHUNK_VB_ARENA
+	MapRenderer_SubmitVertices(info);
+#elif defined CC_GFX_CHUNK_VERTICES
+	info->vb = Builder_CreatePackedVb(totalVerts, x1, y1, z1);
 #else
 	Gfx_UnlockVb(info->vb);
 #endif
@@ -1979,6 +2055,14 @@ static void OnInit(void) {
 	Builder_ApplyActive();
 }
 
+static void OnFree(void) {
+#ifdef CC_GFX_CHUNK_VERTICES
+	Mem_Free(stagingVertices);
+	stagingVertices = NULL;
+	stagingCount    = 0;
+#endif
+}
+
 static void OnNewMapLoaded(void) {
 	Builder_SidesLevel = max(0, Env_SidesHeight);
 	Builder_EdgeLevel  = max(0, Env.EdgeHeight);
@@ -1986,7 +2070,7 @@ static void OnNewMapLoaded(void) {
 
 struct IGameComponent Builder_Component = {
 	OnInit, /* Init */
-	NULL, /* Free */
+	OnFree, /* Free */
 	NULL, /* Reset */
 	NULL, /* OnNewMap */
 	OnNewMapLoaded /* OnNewMapLoaded */
@@ -99,6 +99,7 @@ static const cc_string cryptoAlt = String_FromConst("libcrypto.so.3");
 
 static X509_STORE* store;
 static cc_bool ossl_loaded;
+static void* store_lock;
 
 void CertsBackend_Init(void) {
 	static const struct DynamicLibSym funcs[] = {		
@@ -116,6 +117,22 @@ void CertsBackend_Init(void) {
 	if (!lib) { 
 		ossl_loaded = DynamicLib_LoadAll(&cryptoAlt, funcs, Array_Elems(funcs), &lib);
 	}
+	store_lock = Mutex_Create("X509 store");
+}
+
+/* Chains may be verified from multiple HTTP worker threads at once */
+static X509_STORE* GetX509Store(void) {
+	X509_STORE* result;
+	Mutex_Lock(store_lock);
+
+	/* Delay creating X509 store until necessary */
+	if (!store && (store = _X509_STORE_new())) {
+		_X509_STORE_set_default_paths(store);
+	}
+
+	result = store;
+	Mutex_Unlock(store_lock);
+	return result;
 }
 
 static X509* ToOpenSSLCert(struct X509Cert* cert) {
@@ -130,15 +147,11 @@ int Certs_VerifyChain(struct X509CertContext* chain) {
 	int i, status;
 	X509* cur;
 	X509* cert;
+	X509_STORE* store;
 	if (!ossl_loaded) return ERR_NOT_SUPPORTED;
 
-	/* Delay creating X509 store until necessary */
-	if (!store) {
-		store = _X509_STORE_new();
-		if (!store) return ERR_OUT_OF_MEMORY;
-
-		_X509_STORE_set_default_paths(store);
-	}
+	store = GetX509Store();
+	if (!store) return ERR_OUT_OF_MEMORY;
 
 	/* End/Leaf certificate */
 	cert = ToOpenSSLCert(&chain->certs[0]);
@@ -181,12 +194,13 @@ int Certs_VerifyChain(struct X509CertContext* chain) {
 #include <Security/oidsalg.h>
 #endif
 
+static SecPolicyRef policy;
+static void* policy_lock;
+
 void CertsBackend_Init(void) {
-	
+	policy_lock = Mutex_Create("X509 policy");
 }
 
-static SecPolicyRef policy;
-
 static void CreateChain(struct X509CertContext* x509, CFMutableArrayRef chain) {
 	struct X509Cert* certs = x509->certs;
 	int i;
@@ -234,7 +248,10 @@ int Certs_VerifyChain(struct X509CertContext* x509) {
 	SecTrustRef trust;
 	int res;
 	
+	/* Chains may be verified from multiple HTTP worker threads at once */
+	Mutex_Lock(policy_lock);
 	if (!policy) CreateX509Policy();
+	Mutex_Unlock(policy_lock);
 	if (!policy) return ERR_OUT_OF_MEMORY;
 	
 	chain = CFArrayCreateMutable(NULL, x509->numCerts, &kCFTypeArrayCallBacks);
@@ -262,6 +279,7 @@ int Certs_VerifyChain(struct X509CertContext* x509) {
 
 static jmethodID JAVA_sslCreateTrust, JAVA_sslAddCert, JAVA_sslVerifyChain;
 static int created_trust;
+static void* trust_lock;
 
 void CertsBackend_Init(void) {
 	JNIEnv* env;
@@ -270,16 +288,20 @@ void CertsBackend_Init(void) {
 	JAVA_sslCreateTrust   = Java_GetSMethod(env, "sslCreateTrust", "()I");
 	JAVA_sslAddCert       = Java_GetSMethod(env, "sslAddCert",     "([B)V");
 	JAVA_sslVerifyChain   = Java_GetSMethod(env, "sslVerifyChain", "()I");
+	trust_lock = Mutex_Create("X509 trust");
 }
 
 int Certs_VerifyChain(struct X509CertContext* x509) {
 	JNIEnv* env;
 	jvalue args[1];
-	int i;
+	int i, res;
 	Java_GetCurrentEnv(env);
 	
+	/* The java side collects added certs into one shared chain, */
+	/*  so chains from multiple HTTP worker threads can't be verified at once */
+	Mutex_Lock(trust_lock);
 	if (!created_trust) created_trust = Java_SCall_Int(env, JAVA_sslCreateTrust, NULL);
-	if (!created_trust) return ERR_NOT_SUPPORTED;
+	if (!created_trust) { Mutex_Unlock(trust_lock); return ERR_NOT_SUPPORTED; }
 	
 	for (i = 0; i < x509->numCerts; i++)
 	{
@@ -289,7 +311,9 @@ int Certs_VerifyChain(struct X509CertContext* x509) {
 		Java_DeleteLocalRef(env, args[0].l);
 	}
 
-	return Java_SCall_Int(env, JAVA_sslVerifyChain, NULL);
+	res = Java_SCall_Int(env, JAVA_sslVerifyChain, NULL);
+	Mutex_Unlock(trust_lock);
+	return res;
 }
 #elif CC_CRT_BACKEND == CC_CRT_BACKEND_WINCRYPTO
 #define CC_CRYPT32_FUNC extern
@@ -18,6 +18,16 @@
 #include "Options.h"
 #include "Drawer2D.h"
 #include "Audio.h"
+#include "Platform.h"
+#include "ExtMath.h"
+#include "Vorbis.h"
+#include "Stream.h"
+#include "Errors.h"
+#include "Generator.h"
+#include "Bitmap.h"
+#include "Deflate.h"
+#include "Model.h"
+#include "Http.h"
 
 #define COMMANDS_PREFIX "/client"
 #define COMMANDS_PREFIX_SPACE "/client "
@@ -793,6 +803,515 @@ static struct ChatCommand BlockEditCommand = {
 };
 
 
+/*########################################################################################################################*
+*------------------------------------------------------BenchCommand-------------------------------------------------------*
+*#########################################################################################################################*/
+#define BENCH_GEN_SEED 1234
+/* Returns milliseconds taken to generate the map, or -1 on failure */
+static int BenchCommand_Generate(BlockRaw* blocks) {
+	cc_uint64 beg = Stopwatch_Measure();
+	if (!Gen_RunBlocking(&NotchyGen, BENCH_GEN_SEED, blocks)) return -1;
+	return Stopwatch_ElapsedMS(beg, Stopwatch_Measure());
+}
+
+static void BenchCommand_Gen(void) {
+	cc_bool simd = Gen_NoiseSIMD, parallel = Gen_Parallel, identical;
+	BlockRaw* ref;
+	BlockRaw* out;
+	int refMs, outMs, workers, seed = BENCH_GEN_SEED;
+
+	if (!World.Loaded) {
+		Chat_AddRaw("&e/client bench: &cNo map is currently loaded."); return;
+	}
+	ref = (BlockRaw*)Mem_TryAlloc(World.Volume, 1);
+	out = (BlockRaw*)Mem_TryAlloc(World.Volume, 1);
+	if (!ref || !out) {
+		Chat_AddRaw("&e/client bench: &cOut of memory");
+		Mem_Free(ref); Mem_Free(out); return;
+	}
+
+	/* Reference is the original serial and scalar generator */
+	Gen_NoiseSIMD = false; Gen_Parallel = false;
+	refMs = BenchCommand_Generate(ref);
+	Gen_NoiseSIMD = simd;  Gen_Parallel = parallel;
+	outMs = BenchCommand_Generate(out);
+
+	if (refMs < 0 || outMs < 0) {
+		Chat_AddRaw("&e/client bench: &cFailed to generate map");
+	} else {
+		identical = Mem_Equal(ref, out, World.Volume);
+		workers   = Jobs_WorkerCount();
+		Chat_Add4("&eBench gen: &f%ix%ix%i &eNotchy map, seed %i", 
+			&World.Width, &World.Height, &World.Length, &seed);
+		Chat_Add4("&e  &f%i &ems serial scalar, &f%i &ems with %i workers (SIMD: %t)",
+			&refMs, &outMs, &workers, &simd);
+		if (identical) {
+			Chat_AddRaw("&e  Output is identical");
+		} else {
+			Chat_AddRaw("&e  &cOutput differs from serial scalar generator!");
+		}
+	}
+	Mem_Free(ref);
+	Mem_Free(out);
+}
+
+#if !defined CC_BUILD_NOMUSIC
+#define BENCH_IMDCT_SIZE  2048
+#define BENCH_IMDCT_ITERS 4096
+/* Returns average microseconds per inverse MDCT */
+static float BenchCommand_Imdct(struct imdct_state* state, const float* in, float* out) {
+	cc_uint64 beg, end;
+	int i;
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_IMDCT_ITERS; i++)
+	{
+		Mem_Copy(out, in, (BENCH_IMDCT_SIZE / 2) * sizeof(float));
+		imdct_calc(out, out, state);
+	}
+	end = Stopwatch_Measure();
+	return (float)Stopwatch_ElapsedMicroseconds(beg, end) / BENCH_IMDCT_ITERS;
+}
+
+static void BenchCommand_FindOgg(const cc_string* path, void* obj, int isDirectory) {
+	static const cc_string ogg = String_FromConst(".ogg");
+	cc_string* dst = (cc_string*)obj;
+
+	if (dst->length || isDirectory || !String_CaselessEnds(path, &ogg)) return;
+	String_Copy(dst, path);
+}
+
+/* Returns seconds of audio decoded */
+static float BenchCommand_DecodeOgg(struct Stream* source, cc_int16* samples, int* ms) {
+	struct VorbisState* vorbis = (struct VorbisState*)Mem_TryAllocCleared(1, sizeof(struct VorbisState));
+	struct OggState* ogg       = (struct OggState*)Mem_TryAllocCleared(1, sizeof(struct OggState));
+	cc_uint64 beg, end;
+	float count = 0.0f, seconds = 0.0f;
+	cc_result res;
+
+	if (!vorbis || !ogg) { Mem_Free(vorbis); Mem_Free(ogg); return 0.0f; }
+	beg = Stopwatch_Measure();
+	Ogg_Init(ogg, source);
+	Vorbis_Init(vorbis);
+	vorbis->source = ogg;
+
+	if (!(res = Vorbis_DecodeHeaders(vorbis))) {
+		while (!(res = Vorbis_DecodeFrame(vorbis))) 
+		{
+			count += Vorbis_OutputFrame(vorbis, samples);
+		}
+		seconds = count / (vorbis->channels * vorbis->sampleRate);
+	}
+	end = Stopwatch_Measure();
+
+	if (res != ERR_END_OF_STREAM) {
+		Chat_Add1("&e/client bench: &cError %e decoding ogg file", &res);
+		seconds = 0.0f;
+	}
+	*ms = Stopwatch_ElapsedMS(beg, end);
+
+	Vorbis_Free(vorbis);
+	Mem_Free(vorbis);
+	Mem_Free(ogg);
+	return seconds;
+}
+
+static void BenchCommand_Vorbis(void) {
+	static const cc_string audioDir = String_FromConst("audio");
+	struct imdct_state* state;
+	float* in;
+	float* out;
+	float* ref;
+	cc_bool simd = imdct_useSIMD, identical = true;
+	float scalarUs, simdUs, seconds;
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	struct Stream file, mem;
+	cc_filepath raw_path;
+	cc_uint8* data;
+	cc_int16* samples;
+	cc_uint32 length;
+	RNGState rnd;
+	int i, ms, size = BENCH_IMDCT_SIZE;
+
+	state = (struct imdct_state*)Mem_TryAlloc(1, sizeof(struct imdct_state));
+	in    = (float*)Mem_TryAlloc(BENCH_IMDCT_SIZE * 3, sizeof(float));
+	if (!state || !in) {
+		Chat_AddRaw("&e/client bench: &cOut of memory");
+		Mem_Free(state); Mem_Free(in); return;
+	}
+	out = in  + BENCH_IMDCT_SIZE;
+	ref = out + BENCH_IMDCT_SIZE;
+
+	Random_Seed(&rnd, 1234);
+	for (i = 0; i < BENCH_IMDCT_SIZE / 2; i++) { in[i] = Random_Float(&rnd) - 0.5f; }
+	imdct_init(state, BENCH_IMDCT_SIZE);
+
+	/* Only toggle SIMD for this state, other threads may be decoding sounds */
+	state->useSIMD = false;
+	scalarUs = BenchCommand_Imdct(state, in, ref);
+	state->useSIMD = simd;
+
+	if (simd) {
+		simdUs = BenchCommand_Imdct(state, in, out);
+		for (i = 0; i < BENCH_IMDCT_SIZE; i++) { identical &= out[i] == ref[i]; }
+		Chat_Add4("&eimdct(%i): &f%f2 &eus scalar, &f%f2 &eus SIMD, identical: %t",
+			&size, &scalarUs, &simdUs, &identical);
+	} else {
+		Chat_Add2("&eimdct(%i): &f%f2 &eus (no SIMD support in this build)", &size, &scalarUs);
+	}
+	Mem_Free(state);
+	Mem_Free(in);
+
+	String_InitArray(path, pathBuffer);
+	Directory_Enum(&audioDir, &path, BenchCommand_FindOgg);
+	if (!path.length) {
+		Chat_AddRaw("&eNo .ogg files in audio folder, skipping decode benchmark"); return;
+	}
+
+	/* Decode from memory so disk speed doesn't affect results */
+	Platform_EncodePath(&raw_path, &path);
+	if (Stream_OpenPath(&file, &raw_path)) {
+		Chat_Add1("&e/client bench: &cFailed to open %s", &path); return;
+	}
+
+	data    = NULL;
+	samples = (cc_int16*)Mem_TryAlloc(VORBIS_MAX_BLOCK_SIZE * VORBIS_MAX_CHANS, 2);
+	if (!file.Length(&file, &length) && (data = (cc_uint8*)Mem_TryAlloc(length, 1))) {
+		if (Stream_Read(&file, data, length)) length = 0;
+	}
+	(void)file.Close(&file);
+
+	if (data && samples && length) {
+		Stream_ReadonlyMemory(&mem, data, length);
+		seconds = BenchCommand_DecodeOgg(&mem, samples, &ms);
+		scalarUs = ms ? seconds * 1000.0f / ms : 0.0f;
+		Chat_Add4("&eDecoded &f%f2 &es of %s in &f%i &ems (&f%f1x &erealtime)",
+			&seconds, &path, &ms, &scalarUs);
+	} else {
+		Chat_Add1("&e/client bench: &cFailed to read %s", &path);
+	}
+	Mem_Free(data);
+	Mem_Free(samples);
+}
+#endif
+
+#define BENCH_PNG_MAX_FILES 512
+#define BENCH_PNG_ITERS 20
+/* isSkin is whether the image is a player or mob skin (i.e. a model texture, such as char.png) */
+static struct BenchPng { cc_uint8* data; cc_uint32 size; struct Bitmap ref; cc_bool isSkin; } bench_pngs[BENCH_PNG_MAX_FILES];
+static int bench_pngsCount, bench_skinsCount;
+
+static cc_bool BenchCommand_SelectPng(const cc_string* path) {
+	static const cc_string png = String_FromConst(".png");
+	return String_CaselessEnds(path, &png);
+}
+
+static cc_result BenchCommand_ReadPng(const cc_string* path, struct Stream* stream, struct ZipEntry* entry) {
+	struct BenchPng* png = &bench_pngs[bench_pngsCount];
+	cc_string name = *path;
+	cc_result res;
+	if (!entry->UncompressedSize) return 0;
+
+	png->data = (cc_uint8*)Mem_TryAlloc(entry->UncompressedSize, 1);
+	png->size = entry->UncompressedSize;
+	if (!png->data) return ERR_OUT_OF_MEMORY;
+
+	if ((res = Stream_Read(stream, png->data, png->size))) {
+		Mem_Free(png->data); return res;
+	}
+
+	Utils_UNSAFE_GetFilename(&name);
+	png->isSkin = Model_GetTexture(&name) != NULL;
+	bench_skinsCount += png->isSkin;
+	bench_pngsCount++;
+	return 0;
+}
+
+static cc_result BenchCommand_OpenPngs(const cc_string* path) {
+	static struct ZipEntry entries[BENCH_PNG_MAX_FILES];
+	struct Stream file;
+	cc_filepath raw_path;
+	cc_result res;
+
+	Platform_EncodePath(&raw_path, path);
+	if ((res = Stream_OpenPath(&file, &raw_path))) return res;
+
+	res = Zip_Extract(&file, BenchCommand_SelectPng, BenchCommand_ReadPng, entries, BENCH_PNG_MAX_FILES);
+	(void)file.Close(&file);
+	return res;
+}
+
+/* Calculates MB/s of decoded pixels for all images (rates[0]) and for just skins (rates[1]) */
+/*  First iteration's output is compared against (or stored as) the reference */
+static void BenchCommand_DecodePngs(cc_bool simd, float* rates, cc_bool* identical) {
+	struct BenchPng* png;
+	struct Stream mem;
+	struct Bitmap bmp;
+	cc_uint64 beg, elapsed[2] = { 0, 0 };
+	float bytes[2] = { 0.0f, 0.0f };
+	cc_uint64 time;
+	cc_result res;
+	int i, j;
+
+	for (j = 0; j < BENCH_PNG_ITERS; j++)
+	{
+		for (i = 0; i < bench_pngsCount; i++)
+		{
+			png = &bench_pngs[i];
+			Stream_ReadonlyMemory(&mem, png->data, png->size);
+
+			beg = Stopwatch_Measure();
+			res  = Png_DecodeWith(&bmp, &mem, simd);
+			time = Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
+
+			if (res) { Mem_Free(bmp.scan0); continue; }
+			elapsed[0] += time;
+			bytes[0]   += (float)Bitmap_DataSize(bmp.width, bmp.height);
+			if (png->isSkin) {
+				elapsed[1] += time;
+				bytes[1]   += (float)Bitmap_DataSize(bmp.width, bmp.height);
+			}
+
+			if (j) {
+				Mem_Free(bmp.scan0);
+			} else if (!simd) {
+				png->ref = bmp;
+			} else {
+				*identical &= png->ref.scan0 && bmp.width == png->ref.width && bmp.height == png->ref.height
+					&& Mem_Equal(bmp.scan0, png->ref.scan0, Bitmap_DataSize(bmp.width, bmp.height));
+				Mem_Free(bmp.scan0);
+			}
+		}
+	}
+
+	for (i = 0; i < 2; i++) 
+	{
+		rates[i] = elapsed[i] ? bytes[i] / elapsed[i] : 0.0f;
+	}
+}
+
+static void BenchCommand_Png(void) {
+	cc_bool identical = true;
+	const char* default_path;
+	float scalarRates[2], simdRates[2];
+	int i, iters = BENCH_PNG_ITERS;
+
+	bench_pngsCount  = 0;
+	bench_skinsCount = 0;
+	TexturePack_ExtractDefault(BenchCommand_OpenPngs, &default_path);
+	if (!bench_pngsCount) {
+		Chat_AddRaw("&e/client bench: &cNo .png files found in default texture pack"); return;
+	}
+	Chat_Add3("&eBench png: &f%i &eimages (&f%i &eskins) from default texture pack, decoded &f%i &etimes", 
+		&bench_pngsCount, &bench_skinsCount, &iters);
+
+	BenchCommand_DecodePngs(false, scalarRates, &identical);
+
+	if (Png_UseSIMD) {
+		BenchCommand_DecodePngs(true, simdRates, &identical);
+		Chat_Add3("&e  All: &f%f1 &eMB/s scalar, &f%f1 &eMB/s SIMD, identical: %t",
+			&scalarRates[0], &simdRates[0], &identical);
+		Chat_Add2("&e  Skins: &f%f1 &eMB/s scalar, &f%f1 &eMB/s SIMD",
+			&scalarRates[1], &simdRates[1]);
+	} else {
+		Chat_Add2("&e  &f%f1 &eMB/s, skins &f%f1 &eMB/s (no SIMD support in this build)", 
+			&scalarRates[0], &scalarRates[1]);
+	}
+
+	for (i = 0; i < bench_pngsCount; i++)
+	{
+		Mem_Free(bench_pngs[i].data);
+		Mem_Free(bench_pngs[i].ref.scan0);
+		bench_pngs[i].ref.scan0 = NULL;
+	}
+	bench_pngsCount = 0;
+}
+
+#if defined CC_BUILD_NETWORKING && CC_NET_BACKEND == CC_NET_BACKEND_BUILTIN && !defined CC_BUILD_COOPTHREADED
+#define BENCH_HTTP_SUPPORTED
+#define BENCH_HTTP_REQUESTS 16
+/* See HTTP_MAX_HOST_REQUESTS in Http_Worker.c */
+#define BENCH_HTTP_HOST_LIMIT 2
+static const cc_string bench_httpPort = String_FromConst("8080");
+
+/* Parses the "[connection id],[most requests to host at once]" response of misc/http_test_server.py */
+static cc_bool BenchCommand_ParseHttp(struct HttpRequest* req, int* conn, int* most) {
+	cc_string parts[2];
+	cc_string str;
+	if (!req->success) return false;
+
+	str = String_Init((char*)req->data, req->size, req->size);
+	return String_UNSAFE_Split(&str, ',', parts, 2) == 2 &&
+		Convert_ParseInt(&parts[0], conn) && Convert_ParseInt(&parts[1], most);
+}
+
+static void BenchCommand_Http(const cc_string* port) {
+	static const char* const hosts[2] = { "127.0.0.1", "localhost" };
+	cc_string url; char urlBuffer[URL_MAX_SIZE];
+	int ids[BENCH_HTTP_REQUESTS + 1], conns[BENCH_HTTP_REQUESTS + 1];
+	cc_uint64 times[BENCH_HTTP_REQUESTS + 1];
+	cc_bool done[BENCH_HTTP_REQUESTS + 1];
+	struct HttpRequest item;
+	int i, j, conn, most, ms, total = BENCH_HTTP_REQUESTS + 1, limit = BENCH_HTTP_HOST_LIMIT;
+	int remaining = total, numConns = 0, maxMost = 0, failed = 0, before = 0;
+	cc_uint64 beg = Stopwatch_Measure();
+
+	/* Alternate between two names for the same server, so the per host limit applies to each */
+	for (i = 0; i < BENCH_HTTP_REQUESTS; i++)
+	{
+		String_InitArray(url, urlBuffer);
+		String_Format3(&url, "http://%c:%s/%i", hosts[i & 1], port, &i);
+		ids[i]  = Http_AsyncGetData(&url, 0);
+		done[i] = false;
+	}
+
+	/* Queued last, but should still be one of the first to finish */
+	String_InitArray(url, urlBuffer);
+	String_Format2(&url, "http://%c:%s/priority", hosts[1], port);
+	ids[i]  = Http_AsyncGetData(&url, HTTP_FLAG_PRIORITY);
+	done[i] = false;
+
+	while (remaining && Stopwatch_ElapsedMS(beg, Stopwatch_Measure()) < 30 * 1000)
+	{
+		for (i = 0; i < total; i++)
+		{
+			if (done[i] || !Http_GetResult(ids[i], &item)) continue;
+			done[i]  = true;
+			times[i] = item.timeDownloaded;
+			remaining--;
+
+			if (BenchCommand_ParseHttp(&item, &conn, &most)) {
+				for (j = 0; j < numConns && conns[j] != conn; j++) { }
+				if (j == numConns) conns[numConns++] = conn;
+				maxMost = max(maxMost, most);
+			} else {
+				failed++;
+			}
+			HttpRequest_Free(&item);
+		}
+		Thread_Sleep(10);
+	}
+	ms = Stopwatch_ElapsedMS(beg, Stopwatch_Measure());
+
+	if (remaining) {
+		for (i = 0; i < total; i++) { if (!done[i]) Http_TryCancel(ids[i]); }
+		Chat_Add1("&e/client bench: &c%i requests timed out", &remaining); return;
+	}
+	if (failed) {
+		Chat_Add2("&e/client bench: &c%i of %i requests failed, is misc/http_test_server.py running?", &failed, &total);
+		return;
+	}
+
+	for (i = 0; i < BENCH_HTTP_REQUESTS; i++)
+	{
+		if (times[i] < times[BENCH_HTTP_REQUESTS]) before++;
+	}
+	Chat_Add3("&eBench http: &f%i requests in %i ms over %i connections", &total, &ms, &numConns);
+	Chat_Add2("&e  Most requests to one host at once: &f%i (limit %i)", &maxMost, &limit);
+	Chat_Add1("&e  Requests finished before the priority request: &f%i", &before);
+
+	if (numConns >= total) Chat_AddRaw("&e  &cKept-alive connections were not reused!");
+	if (maxMost  >  limit) Chat_AddRaw("&e  &cPer host request limit was exceeded!");
+	if (before >= BENCH_HTTP_REQUESTS / 2) Chat_AddRaw("&e  &cPriority request waited behind other requests!");
+}
+#endif
+
+#if CC_GFX_BACKEND == CC_GFX_BACKEND_SOFTGPU
+static cc_bool bench_rasterActive;
+static void BenchCommand_Raster(void) {
+	int flushes, mismatches, pixels;
+
+	if (!bench_rasterActive) {
+		bench_rasterActive = true;
+		Gfx_SetRasterCompare(true);
+		Chat_AddRaw("&eBench raster: &fNow drawing every frame with both tiled and scanline rasterisers");
+		Chat_AddRaw("&e  Run &a/client bench raster &eagain to stop and compare the results");
+		return;
+	}
+
+	Gfx_GetRasterCompare(&flushes, &mismatches, &pixels);
+	bench_rasterActive = false;
+	Gfx_SetRasterCompare(false);
+
+	Chat_Add1("&eBench raster: &f%i &eflushes of binned triangles compared", &flushes);
+	if (mismatches) {
+		Chat_Add2("&e  &cTiled output differed in %i flushes (%i pixels in total)!", &mismatches, &pixels);
+	} else {
+		Chat_AddRaw("&e  Framebuffers are identical");
+	}
+}
+#endif
+
+static void BenchCommand_Execute(const cc_string* args, int argsCount) {
+	if (!argsCount) {
+		Chat_AddRaw("&e/client bench: &cYou didn't specify what to benchmark.");
+	} else if (String_CaselessEqualsConst(&args[0], "gen")) {
+		BenchCommand_Gen();
+#if !defined CC_BUILD_NOMUSIC
+	} else if (String_CaselessEqualsConst(&args[0], "vorbis")) {
+		BenchCommand_Vorbis();
+#endif
+	} else if (String_CaselessEqualsConst(&args[0], "png")) {
+		BenchCommand_Png();
+#ifdef BENCH_HTTP_SUPPORTED
+	} else if (String_CaselessEqualsConst(&args[0], "http")) {
+		BenchCommand_Http(argsCount > 1 ? &args[1] : &bench_httpPort);
+#endif
+#if CC_GFX_BACKEND == CC_GFX_BACKEND_SOFTGPU
+	} else if (String_CaselessEqualsConst(&args[0], "raster")) {
+		BenchCommand_Raster();
+#endif
+	} else {
+		Chat_Add1("&e/client bench: &cUnknown benchmark &f\"%s\"&c.", &args[0]);
+	}
+}
+
+static struct ChatCommand BenchCommand = {
+	"Bench", BenchCommand_Execute,
+	0,
+	{
+		"&a/client bench [gen/vorbis/png/http/raster]",
+		"&egen: &fTimes generating a map, checks it matches serial generator",
+		"&evorbis/png: &fTimes decoding first .ogg in audio folder/default pack images",
+		"&ehttp [port]: &fChecks keep-alive, host limit with misc/http_test_server.py",
+		"&eraster: &fToggles comparing SoftGPU tiled and scanline rasteriser output",
+	}
+};
+
+#ifdef CC_BUILD_PROFILER
+static void ProfileCommand_Execute(const cc_string* args, int argsCount) {
+	static const cc_string path = String_FromConst("profile.json");
+	cc_result res;
+
+	if (!argsCount) {
+		Chat_AddRaw("&e/client profile: &cYou didn't specify show, hide or dump.");
+	} else if (String_CaselessEqualsConst(&args[0], "show")) {
+		Profiler_SetOverlay(true);
+	} else if (String_CaselessEqualsConst(&args[0], "hide")) {
+		Profiler_SetOverlay(false);
+	} else if (String_CaselessEqualsConst(&args[0], "dump")) {
+		res = Profiler_DumpTrace(&path);
+		if (res) { Logger_SysWarn2(res, "writing", &path); return; }
+		Chat_Add1("&e/client profile: &fSaved recent frames to %s", &path);
+	} else {
+		Chat_Add1("&e/client profile: &cUnknown option &f\"%s\"&c.", &args[0]);
+	}
+}
+
+static struct ChatCommand ProfileCommand = {
+	"Profile", ProfileCommand_Execute,
+	0,
+	{
+		"&a/client profile [show/hide/dump]",
+		"&eshow: &fShows average time taken by each stage of recent frames",
+		"&ehide: &fHides the profiler overlay",
+		"&edump: &fSaves recent frames to profile.json in Chrome trace format",
+		"&f  (open in chrome://tracing or ui.perfetto.dev)",
+	}
+};
+#endif
+
+
 /*########################################################################################################################*
 *------------------------------------------------------Commands component-------------------------------------------------*
 *#########################################################################################################################*/
@@ -810,6 +1329,10 @@ static void OnInit(void) {
 	Commands_Register(&BlockEditCommand);
 	Commands_Register(&CuboidCommand);
 	Commands_Register(&ReplaceCommand);
+	Commands_Register(&BenchCommand);
+#ifdef CC_BUILD_PROFILER
+	Commands_Register(&ProfileCommand);
+#endif
 }
 
 static void OnFree(void) {
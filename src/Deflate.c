@@ -867,7 +867,8 @@ static cc_result Deflate_FlushBlock(struct DeflateState* state, int len) {
 
 	if (!state->WroteHeader) {
 		state->WroteHeader = true;
-		Deflate_PushBits(state, 3, 3); /* final block TRUE, block type FIXED */
+		/* final block TRUE (unless a segment), block type FIXED */
+		Deflate_PushBits(state, state->IsSegment ? 2 : 3, 3);
 	}
 
 	/* Based off descriptions from http://www.gzip.org/algorithm.txt and
@@ -986,6 +987,17 @@ static cc_result Deflate_StreamClose(struct Stream* stream) {
 	Deflate_PushLit(state, 256);
 	Deflate_FlushBits(state);
 
+	/* Empty stored block aligns the output to a byte boundary */
+	if (state->IsSegment) {
+		Deflate_PushBits(state, 0, 3); /* final block FALSE, block type STORED */
+		while (state->NumBits & 7) { Deflate_PushBits(state, 0, 1); }
+		Deflate_FlushBits(state);
+
+		Deflate_PushBits(state, 0x0000, 16); /* LEN  */
+		Deflate_PushBits(state, 0xFFFF, 16); /* NLEN */
+		Deflate_FlushBits(state);
+	}
+
 	/* In case last byte still has a few extra bits */
 	if (state->NumBits) {
 		while (state->NumBits < 8) { Deflate_PushBits(state, 0, 1); }
@@ -1030,12 +1042,18 @@ void Deflate_MakeStream(struct Stream* stream, struct DeflateState* state, struc
 	state->AvailOut = DEFLATE_OUT_SIZE;
 	state->Dest     = underlying;
 	state->WroteHeader = false;
+	state->IsSegment   = false;
 
 	Mem_Set(state->Head, 0, sizeof(state->Head));
 	Mem_Set(state->Prev, 0, sizeof(state->Prev));
 	Deflate_BuildTable(fixed_lits, INFLATE_MAX_LITS, state->LitsCodewords, state->LitsLens);
 }
 
+void Deflate_MakeSegment(struct Stream* stream, struct DeflateState* state, struct Stream* underlying) {
+	Deflate_MakeStream(stream, state, underlying);
+	state->IsSegment = true;
+}
+
 
 /*########################################################################################################################*
 *-----------------------------------------------------GZip (compress)-----------------------------------------------------*
@@ -1097,19 +1115,48 @@ static cc_result ZLib_StreamClose(struct Stream* stream) {
 	return Stream_Write(state->Base.Dest, data, sizeof(data));
 }
 
-static cc_result ZLib_StreamWrite(struct Stream* stream, const cc_uint8* data, cc_uint32 count, cc_uint32* modified) {
-	struct ZLibState* state = (struct ZLibState*)stream->meta.inflate;
-	cc_uint32 i, adler32 = state->Adler32;
+#define ADLER32_BASE 65521
+/* Max bytes that can be summed before s2 could overflow 32 bits */
+#define ADLER32_NMAX 5552
+
+cc_uint32 ZLib_Adler32(cc_uint32 adler32, const cc_uint8* data, cc_uint32 count) {
 	cc_uint32 s1 = adler32 & 0xFFFF, s2 = (adler32 >> 16) & 0xFFFF;
+	cc_uint32 i, len;
 
-	/* TODO: Optimise this calculation */
-	for (i = 0; i < count; i++) {
-		#define ADLER32_BASE 65521
-		s1 = (s1 + data[i]) % ADLER32_BASE;
-		s2 = (s2 + s1)      % ADLER32_BASE;
+	while (count) 
+	{
+		/* Only need to apply modulo once every NMAX bytes */
+		len    = min(count, ADLER32_NMAX);
+		count -= len;
+
+		for (i = 0; i < len; i++) {
+			s1 += data[i]; s2 += s1;
+		}
+		data += len;
+		s1 %= ADLER32_BASE; s2 %= ADLER32_BASE;
 	}
+	return (s2 << 16) | s1;
+}
+
+/* Based on adler32_combine from zlib */
+cc_uint32 ZLib_CombineAdler32(cc_uint32 adler1, cc_uint32 adler2, cc_uint32 len2) {
+	cc_uint32 rem = len2 % ADLER32_BASE;
+	cc_uint32 s1  = adler1 & 0xFFFF;
+	cc_uint32 s2  = (rem * s1) % ADLER32_BASE;
 
-	state->Adler32 = (s2 << 16) | s1;
+	s1 += (adler2 & 0xFFFF) + ADLER32_BASE - 1;
+	s2 += ((adler1 >> 16) & 0xFFFF) + ((adler2 >> 16) & 0xFFFF) + ADLER32_BASE - rem;
+
+	if (s1 >= ADLER32_BASE)       s1 -= ADLER32_BASE;
+	if (s1 >= ADLER32_BASE)       s1 -= ADLER32_BASE;
+	if (s2 >= (ADLER32_BASE * 2)) s2 -= (ADLER32_BASE * 2);
+	if (s2 >= ADLER32_BASE)       s2 -= ADLER32_BASE;
+	return (s2 << 16) | s1;
+}
+
+static cc_result ZLib_StreamWrite(struct Stream* stream, const cc_uint8* data, cc_uint32 count, cc_uint32* modified) {
+	struct ZLibState* state = (struct ZLibState*)stream->meta.inflate;
+	state->Adler32 = ZLib_Adler32(state->Adler32, data, count);
 	return Deflate_StreamWrite(stream, data, count, modified);
 }
 
@@ -104,10 +104,15 @@ struct DeflateState {
 	/* NOTE: The largest possible value that can get */
 	/*  stored in Head/Prev is <= DEFLATE_BUFFER_SIZE */
 	cc_bool WroteHeader;
+	cc_bool IsSegment; /* Whether output is a non final part of a larger DEFLATE stream */
 };
 /* Compresses input data using DEFLATE, then writes compressed output to another stream. Write only stream. */
 /* DEFLATE compression is pure compressed data, there is no header or footer. */
 CC_API void Deflate_MakeStream(struct Stream* stream, struct DeflateState* state, struct Stream* underlying);
+/* Same as Deflate_MakeStream, except that compressed output is not marked as the final block, */
+/*  and is padded to end on a byte boundary. This means that more independently compressed DEFLATE */
+/*  data can be appended afterwards. (e.g. from separately compressing parts of the data in parallel) */
+void Deflate_MakeSegment(struct Stream* stream, struct DeflateState* state, struct Stream* underlying);
 
 struct GZipState { struct DeflateState Base; cc_uint32 Crc32, Size; };
 /* Compresses input data using GZIP, then writes compressed output to another stream. Write only stream. */
@@ -120,6 +125,10 @@ struct ZLibState { struct DeflateState Base; cc_uint32 Adler32; };
 /* ZLIB compression is ZLIB header, followed by DEFLATE compressed data, followed by ZLIB footer. */
 CC_API  void ZLib_MakeStream(      struct Stream* stream, struct ZLibState* state, struct Stream* underlying);
 typedef void (*FP_ZLib_MakeStream)(struct Stream* stream, struct ZLibState* state, struct Stream* underlying);
+/* Updates the given adler32 checksum with the given data. (checksum starts at 1) */
+cc_uint32 ZLib_Adler32(cc_uint32 adler32, const cc_uint8* data, cc_uint32 count);
+/* Combines the adler32 checksums of two consecutive blocks of data, where len2 is length of the second block */
+cc_uint32 ZLib_CombineAdler32(cc_uint32 adler1, cc_uint32 adler2, cc_uint32 len2);
 
 /* Minimal data needed to describe an entry in a .zip archive */
 struct ZipEntry { cc_uint32 CompressedSize, UncompressedSize, LocalHeaderOffset; };
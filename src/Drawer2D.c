@@ -655,6 +655,210 @@ void Drawer2D_DrawClippedText(struct Context2D* ctx, struct DrawTextArgs* args,
 }
 
 
+/*########################################################################################################################*
+*-------------------------------------------------------Glyph atlas-------------------------------------------------------*
+*#########################################################################################################################*/
+/* NOTE: Only bitmapped fonts are cached, as the atlas is only used for entity nametags */
+#define GLYPH_ATLAS_SIZE  512
+#define GLYPH_ATLAS_FONTS 8
+
+struct GlyphCell { cc_int16 x, y, width, height, advance; cc_bool cached; };
+struct GlyphFont { int size, flags, height; struct GlyphCell cells[256]; };
+
+static struct GlyphFont glyphFonts[GLYPH_ATLAS_FONTS];
+static int glyphFontsCount;
+static struct Bitmap glyphBmp;
+static GfxResourceID glyphTex;
+/* Glyphs are packed left to right into rows ('shelves') */
+static int shelfX, shelfY, shelfHeight;
+/* Range of rows changed since the atlas texture was last updated */
+static int dirtyMinY, dirtyMaxY;
+int GlyphAtlas_Generation = 1;
+void (*GlyphAtlas_BeforeReset)(void);
+
+static void GlyphAtlas_Reset(void) {
+	if (GlyphAtlas_BeforeReset) GlyphAtlas_BeforeReset();
+	GlyphAtlas_Generation++;
+
+	glyphFontsCount = 0;
+	shelfX = 0; shelfY = 0; shelfHeight = 0;
+	dirtyMinY = 0; dirtyMaxY = GLYPH_ATLAS_SIZE;
+
+	if (!glyphBmp.scan0) return;
+	Mem_Set(glyphBmp.scan0, 0, Bitmap_DataSize(GLYPH_ATLAS_SIZE, GLYPH_ATLAS_SIZE));
+}
+
+static struct GlyphFont* GlyphAtlas_GetFont(struct FontDesc* desc) {
+	struct GlyphFont* font;
+	int i;
+
+	for (i = 0; i < glyphFontsCount; i++) 
+	{
+		font = &glyphFonts[i];
+		if (font->size == desc->size && font->flags == desc->flags 
+			&& font->height == desc->height) return font;
+	}
+	if (glyphFontsCount == GLYPH_ATLAS_FONTS) GlyphAtlas_Reset();
+
+	font = &glyphFonts[glyphFontsCount++];
+	Mem_Set(font, 0, sizeof(*font));
+	font->size   = desc->size;   font->flags = desc->flags;
+	font->height = desc->height;
+	return font;
+}
+
+/* Draws the glyph in white into the next free space in the atlas */
+/* Returns false if the atlas has no space left for the glyph */
+static cc_bool GlyphAtlas_AddGlyph(struct FontDesc* desc, struct GlyphCell* cell, char c) {
+	char strBuffer[2];
+	cc_string str = String_FromArray(strBuffer);
+	struct DrawTextArgs args;
+	struct Context2D ctx;
+	BitmapCol origWhiteColor;
+	int y, width, height;
+
+	strBuffer[0] = c; strBuffer[1] = c;
+	str.length   = 2;
+	DrawTextArgs_Make(&args, &str, desc, false);
+	width = Drawer2D_TextWidth(&args);
+
+	args.text.length = 1;
+	cell->width   = Drawer2D_TextWidth(&args);
+	cell->height  = Drawer2D_TextHeight(&args);
+	cell->advance = width - cell->width;
+	width = cell->width; height = cell->height;
+
+	if (width) {
+		if (shelfX + width > GLYPH_ATLAS_SIZE) {
+			shelfX = 0; shelfY += shelfHeight + 1; shelfHeight = 0;
+		}
+		if (shelfY + height > GLYPH_ATLAS_SIZE) return false;
+
+		Context2D_Alloc(&ctx, width, height);
+		{
+			origWhiteColor = Drawer2D.Colors['f'];
+			Drawer2D.Colors['f'] = BITMAPCOLOR_WHITE;
+			Context2D_DrawText(&ctx, &args, 0, 0);
+			Drawer2D.Colors['f'] = origWhiteColor;
+		}
+
+		for (y = 0; y < height; y++) 
+		{
+			Mem_Copy(Bitmap_GetRow(&glyphBmp, shelfY + y) + shelfX, 
+					Bitmap_GetRow(&ctx.bmp, y), width * BITMAPCOLOR_SIZE);
+		}
+		Context2D_Free(&ctx);
+
+		cell->x = shelfX; cell->y = shelfY;
+		dirtyMinY = min(dirtyMinY, shelfY);
+		dirtyMaxY = max(dirtyMaxY, shelfY + height);
+
+		shelfX     += width + 1;
+		shelfHeight = max(shelfHeight, height);
+	}
+	cell->cached = true;
+	return true;
+}
+
+/* Returns -1 if the atlas ran out of space */
+static int GlyphAtlas_Layout(struct DrawTextArgs* args, struct GlyphFont* font,
+							struct GlyphQuad* quads, int maxQuads) {
+	cc_string text = args->text;
+	struct GlyphCell* cell;
+	struct GlyphQuad* q;
+	BitmapCol color;
+	int pass, i, x, offset, count = 0;
+	char c;
+
+	offset = Drawer2D_ShadowOffset(args->font->size);
+
+	/* Shadows are output first, so the text is then drawn over them */
+	for (pass = args->useShadow ? 0 : 1; pass < 2; pass++) 
+	{
+		color = Drawer2D.Colors['f'];
+		x     = pass ? 0 : offset;
+
+		for (i = 0; i < text.length; i++) 
+		{
+			c = text.buffer[i];
+			if (c == '&' && Drawer2D_ValidColorCodeAt(&text, i + 1)) {
+				color = Drawer2D_GetColor(text.buffer[i + 1]);
+				i++; continue; /* skip over the color code */
+			}
+
+			cell = &font->cells[(cc_uint8)c];
+			if (!cell->cached && !GlyphAtlas_AddGlyph(args->font, cell, c)) return -1;
+
+			if (cell->width && count < maxQuads) {
+				q = &quads[count++];
+				q->x = x; q->y = pass ? 0 : offset;
+				q->width = cell->width; q->height = cell->height;
+				q->color = pass ? color : GetShadowColor(color);
+
+				q->uv.u1 = cell->x                  / (float)GLYPH_ATLAS_SIZE;
+				q->uv.v1 = cell->y                  / (float)GLYPH_ATLAS_SIZE;
+				q->uv.u2 = (cell->x + cell->width)  / (float)GLYPH_ATLAS_SIZE;
+				q->uv.v2 = (cell->y + cell->height) / (float)GLYPH_ATLAS_SIZE;
+			}
+			x += cell->advance;
+		}
+	}
+	return count;
+}
+
+int GlyphAtlas_MakeQuads(struct DrawTextArgs* args, struct GlyphQuad* quads, int maxQuads) {
+	int count;
+	if (!Font_IsBitmap(args->font)) return 0;
+
+	if (!glyphBmp.scan0) {
+		glyphBmp.scan0  = (BitmapCol*)Mem_AllocCleared(GLYPH_ATLAS_SIZE * GLYPH_ATLAS_SIZE, BITMAPCOLOR_SIZE, "glyph atlas");
+		glyphBmp.width  = GLYPH_ATLAS_SIZE;
+		glyphBmp.height = GLYPH_ATLAS_SIZE;
+		GlyphAtlas_Reset();
+	}
+
+	count = GlyphAtlas_Layout(args, GlyphAtlas_GetFont(args->font), quads, maxQuads);
+	if (count >= 0) return count;
+
+	/* Out of space, so start over with an empty atlas */
+	/*  (GlyphAtlas_BeforeReset draws quads queued from the old atlas contents first) */
+	GlyphAtlas_Reset();
+	count = GlyphAtlas_Layout(args, GlyphAtlas_GetFont(args->font), quads, maxQuads);
+	return max(count, 0);
+}
+
+void GlyphAtlas_Bind(void) {
+	struct Bitmap part;
+	if (!glyphBmp.scan0) return;
+
+	if (!glyphTex) {
+		glyphTex = Gfx_CreateTexture(&glyphBmp, TEXTURE_FLAG_DYNAMIC, false);
+	} else if (dirtyMinY < dirtyMaxY) {
+		Bitmap_Init(part, GLYPH_ATLAS_SIZE, dirtyMaxY - dirtyMinY, Bitmap_GetRow(&glyphBmp, dirtyMinY));
+		Gfx_UpdateTexture(glyphTex, 0, dirtyMinY, &part, GLYPH_ATLAS_SIZE, false);
+	}
+
+	dirtyMinY = GLYPH_ATLAS_SIZE; dirtyMaxY = 0;
+	Gfx_BindTexture(glyphTex);
+}
+
+static void GlyphAtlas_FontChanged(void* obj) { GlyphAtlas_Reset(); }
+/* Glyphs are white so don't need redrawing, but quad colors do need updating */
+static void GlyphAtlas_ColCodeChanged(void* obj, int code) { GlyphAtlas_Generation++; }
+
+static void GlyphAtlas_ContextLost(void* obj) {
+	/* Whole atlas is reuploaded the next time it is bound */
+	Gfx_DeleteTexture(&glyphTex);
+}
+
+static void GlyphAtlas_Free(void) {
+	Gfx_DeleteTexture(&glyphTex);
+	Mem_Free(glyphBmp.scan0);
+	glyphBmp.scan0  = NULL;
+	glyphFontsCount = 0;
+}
+
+
 /*########################################################################################################################*
 *---------------------------------------------------Drawer2D component----------------------------------------------------*
 *#########################################################################################################################*/
@@ -715,11 +919,16 @@ static void OnInit(void) {
 
 	Drawer2D.BitmappedText    = true;
 	Drawer2D.BlackTextShadows = Options_GetBool(OPT_BLACK_TEXT, false);
+
+	Event_Register_(&ChatEvents.FontChanged,    NULL, GlyphAtlas_FontChanged);
+	Event_Register_(&ChatEvents.ColCodeChanged, NULL, GlyphAtlas_ColCodeChanged);
+	Event_Register_(&GfxEvents.ContextLost,     NULL, GlyphAtlas_ContextLost);
 }
 
 static void OnFree(void) { 
 	FreeFontBitmap();
 	fontBitmap.scan0 = NULL;
+	GlyphAtlas_Free();
 }
 
 struct IGameComponent Drawer2D_Component = {
@@ -122,6 +122,21 @@ void Drawer2D_ReducePadding_Height(int* height, int point, int scale);
 /* Quickly fills the given box region */
 void Drawer2D_Fill(struct Bitmap* bmp, int x, int y, int width, int height, BitmapCol color);
 
+/* Textured quad for a single glyph of text, positioned relative to the top left of the text */
+struct GlyphQuad { cc_int16 x, y, width, height; TextureRec uv; BitmapCol color; };
+/* Lays out the given text as quads of glyphs, caching any new glyphs in the shared glyph atlas */
+/*  Returns number of quads output (shadow quads come first, if args->useShadow is set) */
+/*  NOTE: Glyphs are drawn in white, so quads should be tinted using their color */
+/*  NOTE: Only bitmapped fonts are supported (i.e. Font_MakeBitmapped), returns 0 for system fonts */
+int GlyphAtlas_MakeQuads(struct DrawTextArgs* args, struct GlyphQuad* quads, int maxQuads);
+/* Uploads any newly cached glyphs, then binds the glyph atlas texture */
+void GlyphAtlas_Bind(void);
+/* Incremented whenever quads made earlier by GlyphAtlas_MakeQuads are no longer valid */
+/*  (i.e. the glyph atlas was reset, or a colour code changed) */
+extern int GlyphAtlas_Generation;
+/* Called just before the glyph atlas is reset, so that quads already queued can be drawn first */
+extern void (*GlyphAtlas_BeforeReset)(void);
+
 /* Sets the bitmap used for drawing bitmapped fonts. (i.e. default.png) */
 /* The bitmap must be square and consist of a 16x16 tile layout */
 cc_bool Font_SetBitmapAtlas(struct Bitmap* bmp);
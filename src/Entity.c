@@ -492,28 +492,280 @@ void Entity_LerpAngles(struct Entity* e, float t) {
 }
 
 
+/*########################################################################################################################*
+*---------------------------------------------------Entities broadphase---------------------------------------------------*
+*#########################################################################################################################*/
+/* Entities are bucketed by the 4x4 block column their position lies in */
+/*  Occupied columns are stored in an open addressing hash table (using linear probing) */
+#define GRID_SHIFT 2
+#define GRID_SIZE  (1 << GRID_SHIFT)
+#define GRID_CELLS 512 /* must be a power of two, and greater than ENTITIES_MAX_COUNT */
+/* Extra distance an entity may move from its column before it is next rebucketed */
+/*  (spawned or teleported entities are rebucketed immediately, see Grid_Moved) */
+#define GRID_SLACK 1.0f
+#define GRID_LARGE_Y 1000000.0f
+
+struct GridCell { int x, z; cc_int16 head, count; };
+static struct GridCell grid_cells[GRID_CELLS];
+static cc_int16 grid_next[ENTITIES_MAX_COUNT], grid_prev[ENTITIES_MAX_COUNT];
+static int grid_cellX[ENTITIES_MAX_COUNT], grid_cellZ[ENTITIES_MAX_COUNT];
+static cc_bool grid_linked[ENTITIES_MAX_COUNT];
+static int grid_entities;
+/* Furthest any entity's bounds extend horizontally from its position */
+static float grid_maxExtent;
+
+static int Grid_Hash(int x, int z) {
+	return (int)(((cc_uint32)x * 73856093u) ^ ((cc_uint32)z * 19349663u)) & (GRID_CELLS - 1);
+}
+
+/* Returns index of the cell for the given column, or of the empty slot it would go in */
+static int Grid_Slot(int x, int z) {
+	int i = Grid_Hash(x, z);
+	while (grid_cells[i].count && (grid_cells[i].x != x || grid_cells[i].z != z)) 
+	{
+		i = (i + 1) & (GRID_CELLS - 1);
+	}
+	return i;
+}
+
+/* Removes an empty cell, shifting back later cells in its probe chain to fill the gap */
+static void Grid_RemoveCell(int i) {
+	int j = i, home;
+
+	for (;;) 
+	{
+		j = (j + 1) & (GRID_CELLS - 1);
+		if (!grid_cells[j].count) return;
+		home = Grid_Hash(grid_cells[j].x, grid_cells[j].z);
+
+		/* Cell can only move back if its home slot isn't cyclically within (i, j] */
+		if (i <= j ? (home > i && home <= j) : (home > i || home <= j)) continue;
+		grid_cells[i] = grid_cells[j];
+		grid_cells[j].count = 0;
+		i = j;
+	}
+}
+
+static void Grid_Link(int id, int x, int z) {
+	struct GridCell* cell = &grid_cells[Grid_Slot(x, z)];
+	if (!cell->count) { cell->x = x; cell->z = z; cell->head = -1; }
+
+	grid_prev[id] = -1;
+	grid_next[id] = cell->head;
+	if (cell->head >= 0) grid_prev[cell->head] = id;
+	cell->head = id;
+	cell->count++;
+
+	grid_cellX[id]  = x;
+	grid_cellZ[id]  = z;
+	grid_linked[id] = true;
+	grid_entities++;
+}
+
+static void Grid_Unlink(int id) {
+	int i = Grid_Slot(grid_cellX[id], grid_cellZ[id]);
+	struct GridCell* cell = &grid_cells[i];
+
+	if (grid_prev[id] >= 0) { grid_next[grid_prev[id]] = grid_next[id]; } 
+	else { cell->head = grid_next[id]; }
+	if (grid_next[id] >= 0) { grid_prev[grid_next[id]] = grid_prev[id]; }
+
+	grid_linked[id] = false;
+	if (!--cell->count) Grid_RemoveCell(i);
+	if (!--grid_entities) grid_maxExtent = 0.0f;
+}
+
+static void Grid_Update(int id) {
+	struct Entity* e = Entities.List[id];
+	struct AABB* bb;
+	float extent;
+	int x, z;
+
+	if (!e) { 
+		if (grid_linked[id]) Grid_Unlink(id);
+		return;
+	}
+
+	/* Picking bounds may be rotated, so allow for the diagonal of the model's box too */
+	bb     = &e->ModelAABB;
+	extent = max(max(Math_AbsF(bb->Min.x), Math_AbsF(bb->Max.x)), max(Math_AbsF(bb->Min.z), Math_AbsF(bb->Max.z)));
+	extent = max(extent * 1.5f, max(e->Size.x, e->Size.z) * 0.5f);
+	grid_maxExtent = max(grid_maxExtent, extent);
+
+	x = Math_Floor(e->Position.x / GRID_SIZE);
+	z = Math_Floor(e->Position.z / GRID_SIZE);
+	if (grid_linked[id]) {
+		if (grid_cellX[id] == x && grid_cellZ[id] == z) return;
+		Grid_Unlink(id);
+	}
+	Grid_Link(id, x, z);
+}
+
+/* Rebuckets an entity straight away, instead of waiting until it is next ticked */
+static void Grid_Moved(int id, struct Entity* e) {
+	if (Entities.List[id] == e) Grid_Update(id);
+}
+
+static void Grid_EntityAdded(void* obj, int id) { Grid_Update(id); }
+
+static int Grid_AddCell(struct GridCell* cell, cc_uint16* ids, int count) {
+	int id;
+	for (id = cell->head; id >= 0; id = grid_next[id]) 
+	{
+		if (Entities.List[id]) ids[count++] = id;
+	}
+	return count;
+}
+
+/* Finds all entities in the columns that might overlap the given horizontal area */
+static int Grid_Collect(float minX, float minZ, float maxX, float maxZ, cc_uint16* ids) {
+	float pad = grid_maxExtent + GRID_SLACK;
+	int x1, z1, x2, z2, x, z, i, count = 0;
+	struct GridCell* cell;
+
+	x1 = Math_Floor((minX - pad) / GRID_SIZE); x2 = Math_Floor((maxX + pad) / GRID_SIZE);
+	z1 = Math_Floor((minZ - pad) / GRID_SIZE); z2 = Math_Floor((maxZ + pad) / GRID_SIZE);
+
+	/* Looking through all occupied cells is cheaper for large areas */
+	if (x2 - x1 >= GRID_CELLS || z2 - z1 >= GRID_CELLS || (x2 - x1 + 1) * (z2 - z1 + 1) > GRID_CELLS) {
+		for (i = 0; i < GRID_CELLS; i++) 
+		{
+			cell = &grid_cells[i];
+			if (!cell->count) continue;
+			if (cell->x < x1 || cell->x > x2 || cell->z < z1 || cell->z > z2) continue;
+			count = Grid_AddCell(cell, ids, count);
+		}
+		return count;
+	}
+
+	for (z = z1; z <= z2; z++) 
+	{
+		for (x = x1; x <= x2; x++) 
+		{
+			cell = &grid_cells[Grid_Slot(x, z)];
+			if (cell->count) count = Grid_AddCell(cell, ids, count);
+		}
+	}
+	return count;
+}
+
+int Entities_QueryBox(const struct AABB* bb, cc_uint16* ids) {
+	struct AABB entityBB;
+	int i, count, found = 0;
+
+	count = Grid_Collect(bb->Min.x, bb->Min.z, bb->Max.x, bb->Max.z, ids);
+	for (i = 0; i < count; i++) 
+	{
+		Entity_GetBounds(Entities.List[ids[i]], &entityBB);
+		if (AABB_Intersects(&entityBB, bb)) ids[found++] = ids[i];
+	}
+	return found;
+}
+
+int Entities_QueryRange(const Vec3* pos, float range, cc_uint16* ids) {
+	struct Entity* e;
+	float dx, dz;
+	int i, count, found = 0;
+
+	count = Grid_Collect(pos->x - range, pos->z - range, pos->x + range, pos->z + range, ids);
+	for (i = 0; i < count; i++) 
+	{
+		e  = Entities.List[ids[i]];
+		dx = e->Position.x - pos->x;
+		dz = e->Position.z - pos->z;
+		if (dx * dx + dz * dz <= range * range) ids[found++] = ids[i];
+	}
+	return found;
+}
+
+
 /*########################################################################################################################*
 *--------------------------------------------------------Entities---------------------------------------------------------*
 *#########################################################################################################################*/
 struct _EntitiesData Entities;
 
+/* Entities with ENTITY_FLAG_TICK_LOD that are out of sight and far away from the player */
+/*  are ticked less often, with the elapsed time passed to the next tick they do run in */
+#define ENTITY_LOD_NEAR_DIST 32.0f
+#define ENTITY_LOD_FAR_DIST  64.0f
+static float entities_lodDelta[ENTITIES_MAX_COUNT];
+static cc_uint32 entities_ticks;
+
+static int Entities_TickInterval(struct Entity* e) {
+	Vec3 delta;
+	float distSqr;
+	if (!(e->Flags & ENTITY_FLAG_TICK_LOD) || e->ShouldRender) return 1;
+	if (!Entities.CurPlayer) return 1;
+
+	Vec3_Sub(&delta, &e->Position, &Entities.CurPlayer->Base.Position);
+	distSqr = Vec3_LengthSquared(&delta);
+
+	if (distSqr >= ENTITY_LOD_FAR_DIST  * ENTITY_LOD_FAR_DIST)  return 4;
+	if (distSqr >= ENTITY_LOD_NEAR_DIST * ENTITY_LOD_NEAR_DIST) return 2;
+	return 1;
+}
+
 void Entities_Tick(struct ScheduledTask* task) {
-	int i;
+	struct Entity* e;
+	int i, interval;
+	entities_ticks++;
+
 	for (i = 0; i < ENTITIES_MAX_COUNT; i++)
 	{
-		if (!Entities.List[i]) continue;
-		Entities.List[i]->VTABLE->Tick(Entities.List[i], task->interval);
+		e = Entities.List[i];
+		if (!e) continue;
+
+		interval = Entities_TickInterval(e);
+		entities_lodDelta[i] += (float)task->interval;
+		/* Offset by ID, so that skipped entities don't all tick at once */
+		if ((entities_ticks + i) % interval) continue;
+
+		e->VTABLE->Tick(e, entities_lodDelta[i]);
+		entities_lodDelta[i] = 0.0f;
+		Grid_Update(i);
 	}
 }
 
+/* Whether entity a should be rendered before entity b */
+static cc_bool Entities_RenderBefore(struct Entity* a, struct Entity* b) {
+	if (a->Model != b->Model) return (cc_uintptr)a->Model < (cc_uintptr)b->Model;
+	return (cc_uintptr)a->TextureId < (cc_uintptr)b->TextureId;
+}
+
+/* Entities are rendered grouped by model and skin, so consecutive entities */
+/*  reuse the same model state (e.g. cached texture coordinates, bound texture) */
+static cc_uint16 render_order[ENTITIES_MAX_COUNT];
+
+static int Entities_SortRenderOrder(void) {
+	struct Entity* e;
+	int i, j, count = 0;
+
+	for (i = 0; i < ENTITIES_MAX_COUNT; i++)
+	{
+		e = Entities.List[i];
+		if (!e) continue;
+
+		/* Insertion sort, as most entities will usually be using the same few models */
+		for (j = count; j > 0 && Entities_RenderBefore(e, Entities.List[render_order[j - 1]]); j--)
+		{
+			render_order[j] = render_order[j - 1];
+		}
+		render_order[j] = i;
+		count++;
+	}
+	return count;
+}
+
 void Entities_RenderModels(float delta, float t) {
-	int i;
+	struct Entity* e;
+	int i, count;
 	Gfx_SetAlphaTest(true);
+	count = Entities_SortRenderOrder();
 	
-	for (i = 0; i < ENTITIES_MAX_COUNT; i++)
+	for (i = 0; i < count; i++)
 	{
-		if (!Entities.List[i]) continue;
-		Entities.List[i]->VTABLE->RenderModel(Entities.List[i], delta, t);
+		e = Entities.List[render_order[i]];
+		e->VTABLE->RenderModel(e, delta, t);
 	}
 	Gfx_SetAlphaTest(false);
 }
@@ -543,6 +795,8 @@ void Entities_Remove(int id) {
 	Event_RaiseInt(&EntityEvents.Removed, id);
 	e->VTABLE->Despawn(e);
 	Entities.List[id] = NULL;
+	entities_lodDelta[id] = 0.0f;
+	Grid_Update(id);
 
 	/* TODO: Move to EntityEvents.Removed callback instead */
 	if (id < TABLIST_MAX_NAMES && TabList_EntityLinked_Get(id)) {
@@ -557,18 +811,38 @@ int Entities_GetClosest(struct Entity* src) {
 	float closestDist = -200; /* NOTE: was previously positive infinity */
 	int targetID = -1;
 
-	float t0, t1;
-	int i;
+	struct GridCell* cell;
+	Vec3 invDir, min, max;
+	float t0, t1, pad;
+	int i, id;
 
-	for (i = 0; i < ENTITIES_MAX_COUNT; i++) /* because we don't want to pick against local player */
-	{
-		struct Entity* e = Entities.List[i];
-		if (!e || e == &Entities.CurPlayer->Base) continue;
-		if (!Intersection_RayIntersectsRotatedBox(eyePos, dir, e, &t0, &t1)) continue;
+	invDir.x = Math_SafeDiv(1.0f, dir.x);
+	invDir.y = Math_SafeDiv(1.0f, dir.y);
+	invDir.z = Math_SafeDiv(1.0f, dir.z);
+	pad      = grid_maxExtent + GRID_SLACK;
 
-		if (targetID < 0 || t0 < closestDist) {
-			closestDist = t0;
-			targetID    = i;
+	for (i = 0; i < GRID_CELLS; i++)
+	{
+		/* Skip over columns that the ray doesn't pass through */
+		cell = &grid_cells[i];
+		if (!cell->count) continue;
+
+		min.x = cell->x * GRID_SIZE - pad;             min.y = -GRID_LARGE_Y;
+		min.z = cell->z * GRID_SIZE - pad;             max.y =  GRID_LARGE_Y;
+		max.x = (cell->x + 1) * GRID_SIZE + pad;
+		max.z = (cell->z + 1) * GRID_SIZE + pad;
+		if (!Intersection_RayIntersectsBox(eyePos, invDir, min, max, &t0, &t1)) continue;
+
+		for (id = cell->head; id >= 0; id = grid_next[id]) /* because we don't want to pick against local player */
+		{
+			struct Entity* e = Entities.List[id];
+			if (!e || e == &Entities.CurPlayer->Base) continue;
+			if (!Intersection_RayIntersectsRotatedBox(eyePos, dir, e, &t0, &t1)) continue;
+
+			if (targetID < 0 || t0 < closestDist) {
+				closestDist = t0;
+				targetID    = id;
+			}
 		}
 	}
 	return targetID;
@@ -716,6 +990,7 @@ static void LocalPlayer_HandleInput(struct LocalPlayer* p, float* xMoving, float
 static void LocalPlayer_SetLocation(struct Entity* e, struct LocationUpdate* update) {
 	struct LocalPlayer* p = (struct LocalPlayer*)e;
 	LocalInterpComp_SetLocation(&p->Interp, update, e);
+	Grid_Moved(MAX_NET_PLAYERS + (int)(p - LocalPlayer_Instances), e);
 }
 
 static void LocalPlayer_Tick(struct Entity* e, float delta) {
@@ -1129,6 +1404,7 @@ struct NetPlayer NetPlayers_List[MAX_NET_PLAYERS];
 static void NetPlayer_SetLocation(struct Entity* e, struct LocationUpdate* update) {
 	struct NetPlayer* p = (struct NetPlayer*)e;
 	NetInterpComp_SetLocation(&p->Interp, update, e);
+	Grid_Moved((int)(p - NetPlayers_List), e);
 }
 
 static void NetPlayer_Tick(struct Entity* e, float delta) {
@@ -1179,6 +1455,7 @@ void NetPlayer_Init(struct NetPlayer* p) {
 static void Entities_Init(void) {
 	int i;
 	Event_Register_(&GfxEvents.ContextLost, NULL, Entities_ContextLost);
+	Event_Register_(&EntityEvents.Added,    NULL, Grid_EntityAdded);
 
 	Entities.NamesMode = Options_GetEnum(OPT_NAMES_MODE, NAME_MODE_HOVERED,
 		NameMode_Names, Array_Elems(NameMode_Names));
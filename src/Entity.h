@@ -11,6 +11,7 @@ CC_BEGIN_HEADER
    Copyright 2014-2025 ClassiCube | Licensed under BSD-3
 */
 struct Model;
+struct GlyphQuad;
 struct IGameComponent;
 struct ScheduledTask;
 struct LocalPlayer;
@@ -105,6 +106,9 @@ struct EntityVTABLE {
 /* Whether in classic mode, to slightly adjust this entity downwards when rendering it */
 /*  to replicate the behaviour of the original vanilla classic client */
 #define ENTITY_FLAG_CLASSIC_ADJUST 0x04
+/* Whether this entity can be ticked less often when far away and out of sight */
+/*  (only suitable for entities simulated locally, such as mobs and dropped items) */
+#define ENTITY_FLAG_TICK_LOD 0x08
 
 /* Contains a model, along with position, velocity, and rotation. May also contain other fields and properties. */
 struct Entity {
@@ -133,7 +137,10 @@ struct Entity {
 	struct AnimatedComp Anim;
 	char SkinRaw[STRING_SIZE];
 	char NameRaw[STRING_SIZE];
-	struct Texture NameTex;
+	/* Glyph layout of the name, cached until the name changes or the glyph atlas is reset */
+	struct GlyphQuad* NameQuads;
+	int NameQuadsCount, NameAtlasGen;
+	cc_int16 NameWidth, NameHeight;
 
 	/* Previous and next intended location of the entity */
 	/*  Current state is linearly interpolated between prev and next */
@@ -193,6 +200,15 @@ void Entities_Remove(int id);
 /* Returns -1 if there is no other entity nearby */
 int Entities_GetClosest(struct Entity* src);
 
+/* Finds all entities whose bounding box (see Entity_GetBounds) intersects the given box */
+/*  Returns number of IDs written, ids must have room for ENTITIES_MAX_COUNT IDs */
+/*  NOTE: Entities are rebucketed when added, removed, ticked, or moved via SetLocation */
+/*   (so positions changed directly may lag behind by up to a tick) */
+int Entities_QueryBox(const struct AABB* bb, cc_uint16* ids);
+/* Finds all entities whose position is within the given horizontal (X/Z) distance of pos */
+/*  Returns number of IDs written, ids must have room for ENTITIES_MAX_COUNT IDs */
+int Entities_QueryRange(const Vec3* pos, float range, cc_uint16* ids);
+
 #define TABLIST_MAX_NAMES 256
 /* Data for all entries in tab list */
 CC_VAR extern struct _TabListData {
@@ -1025,16 +1025,24 @@ float PhysicsComp_CalcJumpVelocity(float jumpHeight) {
 }
 
 void PhysicsComp_DoEntityPush(struct Entity* entity) {
+	cc_uint16 ids[ENTITIES_MAX_COUNT];
 	struct Entity* other;
 	cc_bool yIntersects;
+	struct AABB area;
 	Vec3 dir;
 	float dist, pushStrength;
-	int id;
+	int i, count;
 	dir.y = 0.0f;
 
-	for (id = 0; id < ENTITIES_MAX_COUNT; id++) {
-		other = Entities.List[id];
-		if (!other || other == entity) continue;
+	/* Only entities within 1 block horizontally can push */
+	area.Min.x = entity->Position.x - 1.0f; area.Max.x = entity->Position.x + 1.0f;
+	area.Min.z = entity->Position.z - 1.0f; area.Max.z = entity->Position.z + 1.0f;
+	area.Min.y = entity->Position.y;        area.Max.y = entity->Position.y + entity->Size.y;
+	count = Entities_QueryBox(&area, ids);
+
+	for (i = 0; i < count; i++) {
+		other = Entities.List[ids[i]];
+		if (other == entity) continue;
 		if (!other->Model->pushes)     continue;
 
 		yIntersects =
@@ -12,6 +12,7 @@
 #include "Particle.h"
 #include "Drawer2D.h"
 #include "Server.h"
+#include "Platform.h"
 
 /*########################################################################################################################*
 *------------------------------------------------------Entity Shadow------------------------------------------------------*
@@ -280,19 +281,64 @@ void EntityShadows_Render(void) {
 *-----------------------------------------------------Entity nametag------------------------------------------------------*
 *#########################################################################################################################*/
 static GfxResourceID names_VB;
-#define NAME_IS_EMPTY -30000
+static struct VertexTextured* names_vertices;
+static int names_count;
+
 #define NAME_OFFSET 3 /* offset of back layer of name above an entity */
+#define NAMES_MAX_QUADS 512
+
+/* Draws all the name quads batched so far */
+static void FlushNames(void) {
+	if (!names_vertices) return;
+	Gfx_UnlockDynamicVb(names_VB);
+	names_vertices = NULL;
 
-static void MakeNameTexture(struct Entity* e) {
-	cc_string colorlessName; char colorlessBuffer[STRING_SIZE];
-	BitmapCol shadowColor = BitmapCol_Make(80, 80, 80, 255);
-	BitmapCol origWhiteColor;
+	if (!names_count) return;
+	GlyphAtlas_Bind();
+	Gfx_DrawVb_IndexedTris(names_count * 4);
+	names_count = 0;
+}
+
+static void BeginNames(void) {
+	if (!names_VB)
+		names_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, NAMES_MAX_QUADS * 4);
+
+	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
+	names_vertices = (struct VertexTextured*)Gfx_LockDynamicVb(names_VB, 
+						VERTEX_FORMAT_TEXTURED, NAMES_MAX_QUADS * 4);
+	names_count = 0;
+}
+
+/* Adds a billboarded quad for a glyph, where x/y are pixel offsets from the centre of the name */
+static void AddNameQuad(const struct GlyphQuad* q, float x1, float y1, PackedCol col,
+						const Vec3* centre, const Vec3* right, const Vec3* up) {
+	struct VertexTextured* v = names_vertices + names_count * 4;
+	float x2 = x1 + q->width, y2 = y1 - q->height;
+
+	v->x = centre->x + right->x * x1 + up->x * y2; v->y = centre->y + right->y * x1 + up->y * y2; v->z = centre->z + right->z * x1 + up->z * y2;
+	v->Col = col; v->U = q->uv.u1; v->V = q->uv.v2; v++;
+	v->x = centre->x + right->x * x1 + up->x * y1; v->y = centre->y + right->y * x1 + up->y * y1; v->z = centre->z + right->z * x1 + up->z * y1;
+	v->Col = col; v->U = q->uv.u1; v->V = q->uv.v1; v++;
+	v->x = centre->x + right->x * x2 + up->x * y1; v->y = centre->y + right->y * x2 + up->y * y1; v->z = centre->z + right->z * x2 + up->z * y1;
+	v->Col = col; v->U = q->uv.u2; v->V = q->uv.v1; v++;
+	v->x = centre->x + right->x * x2 + up->x * y2; v->y = centre->y + right->y * x2 + up->y * y2; v->z = centre->z + right->z * x2 + up->z * y2;
+	v->Col = col; v->U = q->uv.u2; v->V = q->uv.v2; v++;
+	names_count++;
+}
 
+void EntityNames_Delete(struct Entity* e) {
+	Mem_Free(e->NameQuads);
+	e->NameQuads      = NULL;
+	e->NameQuadsCount = 0;
+	e->NameAtlasGen   = 0;
+}
+
+static void MakeNameQuads(struct Entity* e) {
+	struct GlyphQuad quads[STRING_SIZE];
 	struct DrawTextArgs args;
 	struct FontDesc font;
-	struct Context2D ctx;
-	int width, height;
 	cc_string name;
+	int count;
 
 	/* Names are always drawn using default.png font */
 	Font_MakeBitmapped(&font, 24, FONT_FLAGS_NONE);
@@ -301,77 +347,75 @@ static void MakeNameTexture(struct Entity* e) {
 
 	name = String_FromRawArray(e->NameRaw);
 	DrawTextArgs_Make(&args, &name, &font, false);
-	width = Drawer2D_TextWidth(&args);
-
-	if (!width) {
-		e->NameTex.ID = 0;
-		e->NameTex.x  = NAME_IS_EMPTY;
-	} else {
-		String_InitArray(colorlessName, colorlessBuffer);
-		width  += NAME_OFFSET; 
-		height = Drawer2D_TextHeight(&args) + NAME_OFFSET;
+	/* NOTE: This may reset the glyph atlas, which flushes names queued so far */
+	count = GlyphAtlas_MakeQuads(&args, quads, STRING_SIZE);
 
-		Context2D_Alloc(&ctx, width, height);
-		{
-			origWhiteColor = Drawer2D.Colors['f'];
-
-			Drawer2D.Colors['f'] = shadowColor;
-			Drawer2D_WithoutColors(&colorlessName, &name);
-			args.text = colorlessName;
-			Context2D_DrawText(&ctx, &args, NAME_OFFSET, NAME_OFFSET);
+	EntityNames_Delete(e);
+	e->NameWidth  = Drawer2D_TextWidth(&args);
+	e->NameHeight = Drawer2D_TextHeight(&args);
 
-			Drawer2D.Colors['f'] = origWhiteColor;
-			args.text = name;
-			Context2D_DrawText(&ctx, &args, 0, 0);
-		}
-		Context2D_MakeTexture(&e->NameTex, &ctx);
-		Context2D_Free(&ctx);
+	if (count && (e->NameQuads = (struct GlyphQuad*)Mem_TryAlloc(count, sizeof(struct GlyphQuad)))) {
+		Mem_Copy(e->NameQuads, quads, count * sizeof(struct GlyphQuad));
+		e->NameQuadsCount = count;
 	}
+	e->NameAtlasGen = GlyphAtlas_Generation;
 }
 
 static void DrawName(struct Entity* e) {
-	struct VertexTextured* vertices;
+	PackedCol shadowColor = PackedCol_Make(80, 80, 80, 255);
+	struct GlyphQuad* quads;
+	struct GlyphQuad* q;
 	struct Model* model;
+	struct Matrix* view;
 	struct Matrix mat, transform;
-	Vec3 pos;
-	float scale;
-	Vec2 size;
+	Vec3 pos, right, up;
+	float scale, halfWidth, halfHeight;
+	int i, count;
 
 	if (!e->VTABLE->ShouldRenderName(e)) return;
-	if (e->NameTex.x == NAME_IS_EMPTY)   return;
-	if (!e->NameTex.ID) MakeNameTexture(e);
-	Gfx_BindTexture(e->NameTex.ID);
+	if (e->NameAtlasGen != GlyphAtlas_Generation) MakeNameQuads(e);
 
-	if (!names_VB)
-		names_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, 4);
+	quads = e->NameQuads;
+	count = e->NameQuadsCount;
+	if (!count) return;
+
+	halfWidth  = (e->NameWidth  + NAME_OFFSET) * 0.5f;
+	halfHeight = (e->NameHeight + NAME_OFFSET) * 0.5f;
 
 	model = e->Model;
 	Model_GetEntityTransform(model, e, &transform);
 	Vec3_TransformY(&pos, model->GetNameY(e), &transform);
 
-	scale  = e->ModelScale.y;
-	scale  = scale > 1.0f ? (1.0f/70.0f) : (scale/70.0f);
-	size.x = e->NameTex.width * scale; size.y = e->NameTex.height * scale;
+	scale = e->ModelScale.y;
+	scale = scale > 1.0f ? (1.0f/70.0f) : (scale/70.0f);
 
 	if (Entities.NamesMode == NAME_MODE_ALL_UNSCALED && Entities.CurPlayer->Hacks.CanSeeAllNames) {
 		Matrix_Mul(&mat, &Gfx.View, &Gfx.Projection); /* TODO: This mul is slow, avoid it */
 		/* Get W component of transformed position */
-		scale = pos.x * mat.row1.w + pos.y * mat.row2.w + pos.z * mat.row3.w + mat.row4.w;
-		size.x *= scale * 0.2f; size.y *= scale * 0.2f;
+		scale *= (pos.x * mat.row1.w + pos.y * mat.row2.w + pos.z * mat.row3.w + mat.row4.w) * 0.2f;
 	}
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-
-	vertices = (struct VertexTextured*)Gfx_LockDynamicVb(names_VB, VERTEX_FORMAT_TEXTURED, 4);
-	Particle_DoRender(&size, &pos, &e->NameTex.uv, PACKEDCOL_WHITE, vertices);
-	Gfx_UnlockDynamicVb(names_VB);
+	/* right/up are one pixel of the name along the camera's right/up axes */
+	view = &Gfx.View;
+	right.x = view->row1.x * scale; right.y = view->row2.x * scale; right.z = view->row3.x * scale;
+	up.x    = view->row1.y * scale; up.y    = view->row2.y * scale; up.z    = view->row3.y * scale;
+	pos.y  += halfHeight * scale;
 
-	Gfx_DrawVb_IndexedTris(4);
-}
+	if (!names_vertices) BeginNames();
+	if (names_count + count * 2 > NAMES_MAX_QUADS) { FlushNames(); BeginNames(); }
 
-void EntityNames_Delete(struct Entity* e) {
-	Gfx_DeleteTexture(&e->NameTex.ID);
-	e->NameTex.x = 0; /* X is used as an 'empty name' flag */
+	/* Back layer is the name offset down and right in a single grey color */
+	for (i = 0, q = quads; i < count; i++, q++) 
+	{
+		AddNameQuad(q, q->x + NAME_OFFSET - halfWidth, halfHeight - q->y - NAME_OFFSET, 
+					shadowColor, &pos, &right, &up);
+	}
+	for (i = 0, q = quads; i < count; i++, q++) 
+	{
+		AddNameQuad(q, q->x - halfWidth, halfHeight - q->y,
+					PackedCol_Make(BitmapCol_R(q->color), BitmapCol_G(q->color), BitmapCol_B(q->color), 255),
+					&pos, &right, &up);
+	}
 }
 
 
@@ -400,6 +444,7 @@ void EntityNames_Render(void) {
 		if (!Entities.List[i]) continue;
 		if (i != closestEntityId) DrawName(Entities.List[i]);
 	}
+	FlushNames();
 
 	Gfx_SetAlphaTest(false);
 	if (hadFog) Gfx_SetFog(true);
@@ -438,26 +483,14 @@ void EntityNames_RenderHovered(void) {
 	}
 
 	if (!setupState) return;
+	FlushNames();
+
 	Gfx_SetAlphaTest(false);
 	Gfx_SetDepthTest(true);
 	Gfx_SetDepthWrite(true);
 	if (hadFog) Gfx_SetFog(true);
 }
 
-static void DeleteAllNameTextures(void) {
-	int i;
-	for (i = 0; i < ENTITIES_MAX_COUNT; i++) 
-	{
-		if (!Entities.List[i]) continue;
-		EntityNames_Delete(Entities.List[i]);
-	}
-}
-
-static void EntityNames_ChatFontChanged(void* obj) {
-	DeleteAllNameTextures();
-}
-
-
 /*########################################################################################################################*
 *-----------------------------------------------Entity renderers component------------------------------------------------*
 *#########################################################################################################################*/
@@ -466,12 +499,12 @@ static void EntityRenderers_ContextLost(void* obj) {
 	Gfx_DeleteDynamicVb(&shadows_VB);
 	
 	Gfx_DeleteDynamicVb(&names_VB);
-	DeleteAllNameTextures();
 }
 
 static void EntityRenderers_Init(void) {
 	Event_Register_(&GfxEvents.ContextLost,  NULL, EntityRenderers_ContextLost);
-	Event_Register_(&ChatEvents.FontChanged, NULL, EntityNames_ChatFontChanged);
+	/* Names queued so far use the old glyph atlas contents */
+	GlyphAtlas_BeforeReset = FlushNames;
 }
 
 static void EntityRenderers_Free(void) {
@@ -13,12 +13,12 @@ struct Entity;
 /* Draws shadows under entities, depending on Entities.ShadowsMode */
 void EntityShadows_Render(void);
 
-/* Deletes the texture containing the entity's nametag */
-void EntityNames_Delete(struct Entity* e);
 /* Renders the name tags of entities, depending on Entities.NamesMode */
 void EntityNames_Render(void);
 /* Renders hovered entity name tags (these appears through blocks) */
 void EntityNames_RenderHovered(void);
+/* Frees the cached glyph layout of the given entity's name */
+void EntityNames_Delete(struct Entity* e);
 
 CC_END_HEADER
 #endif
@@ -120,9 +120,11 @@ float sqrtf(float x) {
 #define RND_VALUE (0x5DEECE66DULL)
 #define RND_MASK ((1ULL << 48) - 1)
 
+int Random_FixedSeed;
+
 void Random_SeedFromCurrentTime(RNGState* rnd) {
 	cc_uint64 now = Stopwatch_Measure();
-	Random_Seed(rnd, (int)now);
+	Random_Seed(rnd, Random_FixedSeed ? Random_FixedSeed : (int)now);
 }
 
 void Random_Seed(RNGState* seed, int seedInit) {
@@ -76,6 +76,8 @@ cc_bool Math_IsPowOf2(int value);
 #define Math_Clamp(val, min, max) val = val < (min) ? (min) : val;  val = val > (max) ? (max) : val;
 
 typedef cc_uint64 RNGState;
+/* If non-zero, Random_SeedFromCurrentTime uses this seed instead (e.g. for reproducible benchmarks) */
+extern int Random_FixedSeed;
 /* Initialises RNG using seed from current UTC time. */
 void Random_SeedFromCurrentTime(RNGState* rnd);
 /* Initialised RNG using the given seed. */
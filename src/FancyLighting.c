@@ -343,6 +343,7 @@ static void CalculateChunkLightingAll(int chunkIndex, int cx, int cy, int cz) {
 	if (chunkEndY == World.ChunksY) { chunkEndY--; }
 	if (chunkEndZ == World.ChunksZ) { chunkEndZ--; }
 
+	Profiler_Begin("Lighting_CalcChunk");
 	for (y = chunkStartY; y <= chunkEndY; y++) {
 		for (z = chunkStartZ; z <= chunkEndZ; z++) {
 			for (x = chunkStartX; x <= chunkEndX; x++) {
@@ -354,6 +355,7 @@ static void CalculateChunkLightingAll(int chunkIndex, int cx, int cy, int cz) {
 			}
 		}
 	}
+	Profiler_End();
 	chunkLightingDataFlags[chunkIndex] = CHUNK_ALL_CALCULATED;
 }
 
@@ -464,10 +466,12 @@ static void OnBlockChanged(int x, int y, int z, BlockID oldBlock, BlockID newBlo
 	/* For some reason this is a possible case */
 	if (oldBlock == newBlock) { return; }
 
+	Profiler_Begin("Lighting_BlockChanged");
 	ClassicLighting_OnBlockChanged(x, y, z, oldBlock, newBlock);
 
 	CalcBlockChange(x, y, z, oldBlock, newBlock, false);
 	CalcBlockChange(x, y, z, oldBlock, newBlock, true);
+	Profiler_End();
 }
 /* Invalidates/Resets lighting state for all of the blocks in the world */
 /*  (e.g. because a block changed whether it is full bright or not) */
@@ -41,6 +41,8 @@
 #include "SystemFonts.h"
 #include "Formats.h"
 #include "EntityRenderers.h"
+#include "BlockPhysics.h"
+#include "Platform.h"
 
 struct _GameData Game;
 static cc_uint64 frameStart;
@@ -51,7 +53,7 @@ int Game_ViewDistance     = DEFAULT_VIEWDIST;
 int Game_UserViewDistance = DEFAULT_VIEWDIST;
 int Game_MaxViewDistance  = DEFAULT_MAX_VIEWDIST;
 
-int     Game_FpsLimit, Game_Vertices;
+int     Game_FpsLimit, Game_Vertices, Game_DrawCalls;
 cc_bool Game_SimpleArmsAnim;
 static float gfx_minFrameMs;
 static cc_bool autoPause;
@@ -104,10 +106,15 @@ static int tasksCapacity = TASKS_DEF_ELEMS, tasksCount, entTaskI;
 static struct ScheduledTask* tasks = defaultTasks;
 
 int ScheduledTask_Add(double interval, ScheduledTaskCallback callback) {
+	return ScheduledTask_AddNamed(interval, callback, "ScheduledTask");
+}
+
+int ScheduledTask_AddNamed(double interval, ScheduledTaskCallback callback, const char* name) {
 	struct ScheduledTask task;
 	task.accumulator = 0.0;
 	task.interval    = interval;
 	task.Callback    = callback;
+	task.name        = name;
 
 	if (tasksCount == tasksCapacity) {
 		Utils_Resize((void**)&tasks, &tasksCapacity,
@@ -235,6 +242,7 @@ void Game_UpdateBlock(int x, int y, int z, BlockID block) {
 	}
 	Lighting.OnBlockChanged(x, y, z, old, block);
 	MapRenderer_OnBlockChanged(x, y, z, block);
+	Mob_OnBlockChanged(x, y, z);
 }
 
 void Game_ChangeBlock(int x, int y, int z, BlockID block) {
@@ -331,11 +339,422 @@ static void HandleOnNewMap(void* obj) {
 	}
 }
 
+/*########################################################################################################################*
+*--------------------------------------------------------Benchmark--------------------------------------------------------*
+*#########################################################################################################################*/
+int Game_BenchmarkFrames;
+/* Benchmark always advances by 1/60th of a second per frame, so runs are reproducible */
+#define BENCH_FRAME_MICROS (1000 * 1000 / 60)
+#define BENCH_MOBS_COUNT    24
+#define BENCH_TNT_CLUSTERS  4
+/* Number of frames between each TNT cluster being lit */
+#define BENCH_TNT_INTERVAL  120
+
+static const char* const bench_names[BENCH_TIMER_COUNT] = {
+	"MapRenderer_Update", "Builder_MakeChunk", "Physics_Tick", "Entities_Tick", "Particles_Render"
+};
+static struct BenchTimer { cc_uint64 total, max; int calls; } bench_timers[BENCH_TIMER_COUNT];
+static cc_uint64 bench_frameTotal, bench_frameMin, bench_frameMax;
+static IVec3 bench_tnt[BENCH_TNT_CLUSTERS];
+/* Number of frames benchmarked so far, or -1 when map has not finished loading yet */
+static int bench_frame = -1;
+#define Benchmark_IsActive() (bench_frame >= 0 && bench_frame < Game_BenchmarkFrames)
+
+void Benchmark_AddTime(int timer, cc_uint64 beg) {
+	struct BenchTimer* t = &bench_timers[timer];
+	cc_uint64 elapsed    = Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
+
+	t->total += elapsed;
+	t->max    = max(t->max, elapsed);
+	t->calls++;
+}
+
+/* Returns the Y coordinate just above the highest non-air block */
+static int Benchmark_SurfaceY(int x, int z) {
+	int y = World.MaxY;
+	while (y > 0 && World_GetBlock(x, y, z) == BLOCK_AIR) y--;
+	return y + 1;
+}
+
+static void Benchmark_PlaceTNT(RNGState* rnd) {
+	int i, x, y, z, cx, cy, cz;
+
+	for (i = 0; i < BENCH_TNT_CLUSTERS; i++)
+	{
+		cx = Random_Range(rnd, 8, World.Width  - 8);
+		cz = Random_Range(rnd, 8, World.Length - 8);
+		cy = min(Benchmark_SurfaceY(cx, cz), World.MaxY - 2);
+
+		/* 3x3x3 cube of TNT, which chain reacts once the centre is lit */
+		for (y = cy; y < cy + 3; y++)
+			for (z = cz - 1; z <= cz + 1; z++)
+				for (x = cx - 1; x <= cx + 1; x++)
+		{
+			Game_UpdateBlock(x, y, z, BLOCK_TNT);
+		}
+		bench_tnt[i].x = cx; bench_tnt[i].y = cy + 1; bench_tnt[i].z = cz;
+	}
+}
+
+static void Benchmark_SpawnMobs(RNGState* rnd) {
+	int i, x, z;
+
+	for (i = 0; i < BENCH_MOBS_COUNT; i++)
+	{
+		x = Random_Range(rnd, 4, World.Width  - 4);
+		z = Random_Range(rnd, 4, World.Length - 4);
+		Mob_SpawnAt(x + 0.5f, (float)Benchmark_SurfaceY(x, z), z + 0.5f, i % MOB_TYPES_COUNT);
+	}
+}
+
+static void Benchmark_Start(void) {
+	struct LocalPlayer* p = Entities.CurPlayer;
+	RNGState rnd;
+	if (!Game_BenchmarkFrames || bench_frame >= 0) return;
+
+	/* Natural spawning would make mob counts depend on the user's options */
+	Game_MobSpawnRate = 0;
+	Physics_SetEnabled(true);
+	p->Hacks.Flying = true;
+	p->Hacks.Noclip = true;
+
+	Random_Seed(&rnd, BENCHMARK_SEED);
+	Benchmark_PlaceTNT(&rnd);
+	Benchmark_SpawnMobs(&rnd);
+
+	Mem_Set(bench_timers, 0, sizeof(bench_timers));
+	bench_frameTotal = 0; bench_frameMax = 0;
+	bench_frameMin   = (cc_uint64)-1;
+	bench_frame      = 0;
+}
+
+/* Flies the camera in a circle around the map, looking towards the centre */
+static void Benchmark_MoveCamera(void) {
+	struct LocalPlayer* p = Entities.CurPlayer;
+	struct LocationUpdate update;
+	float angle  = (2 * MATH_PI * bench_frame) / Game_BenchmarkFrames;
+	float radius = min(World.Width, World.Length) * 0.4f;
+	float dirX   = -Math_CosF(angle), dirZ = -Math_SinF(angle);
+
+	update.pos.x = World.Width  * 0.5f - dirX * radius;
+	update.pos.y = World.Height * 0.75f + 4.0f;
+	update.pos.z = World.Length * 0.5f - dirZ * radius;
+	/* Forward vector is (sin(yaw), -cos(yaw)) */
+	update.yaw   = Math_Atan2f(-dirZ, dirX) * MATH_RAD2DEG;
+	update.pitch = 20.0f;
+
+	update.flags = LU_HAS_POS | LU_HAS_YAW | LU_HAS_PITCH;
+	p->Base.VTABLE->SetLocation(&p->Base, &update);
+}
+
+static void Benchmark_Tick(void) {
+	int i;
+	if (!Benchmark_IsActive()) return;
+	Benchmark_MoveCamera();
+
+	for (i = 0; i < BENCH_TNT_CLUSTERS; i++)
+	{
+		if (bench_frame != (i + 1) * BENCH_TNT_INTERVAL) continue;
+		TNT_ScheduleFuse(bench_tnt[i].x, bench_tnt[i].y, bench_tnt[i].z);
+	}
+}
+
+static void Benchmark_AppendTimer(cc_string* str, int i) {
+	struct BenchTimer* t = &bench_timers[i];
+	float totalMs = (int)t->total / 1000.0f;
+	float avgUs   = t->calls ? (int)t->total / (float)t->calls : 0.0f;
+	int maxUs     = (int)t->max;
+
+	String_Format2(str, "    \"%c\": { \"calls\": %i, ", bench_names[i], &t->calls);
+	String_Format3(str, "\"total_ms\": %f3, \"avg_us\": %f1, \"max_us\": %i }", &totalMs, &avgUs, &maxUs);
+	String_AppendConst(str, i < BENCH_TIMER_COUNT - 1 ? ",\n" : "\n");
+}
+
+static void Benchmark_Finish(void) {
+	static const cc_string path = String_FromConst("benchmark.json");
+#ifdef CC_BUILD_PROFILER
+	static const cc_string tracePath = String_FromConst("benchmark_trace.json");
+#endif
+	cc_string str; char strBuffer[2048];
+	float avgMs, minMs, maxMs;
+	int i, seed = BENCHMARK_SEED;
+	cc_result res;
+
+	avgMs = (int)bench_frameTotal / (1000.0f * bench_frame);
+	minMs = (int)bench_frameMin   / 1000.0f;
+	maxMs = (int)bench_frameMax   / 1000.0f;
+
+	String_InitArray(str, strBuffer);
+	String_AppendConst(&str, "{\n");
+	String_Format2(&str, "  \"frames\": %i,\n  \"seed\": %i,\n", &bench_frame, &seed);
+	String_Format3(&str, "  \"map\": [%i, %i, %i],\n", &World.Width, &World.Height, &World.Length);
+	String_Format3(&str, "  \"frame_ms\": { \"avg\": %f3, \"min\": %f3, \"max\": %f3 },\n", &avgMs, &minMs, &maxMs);
+#ifndef CC_BUILD_NOSOUNDS
+	String_Format1(&str, "  \"mixer_check\": %c,\n", AudioMixer_Check() ? "true" : "false");
+#endif
+	String_AppendConst(&str, "  \"timers\": {\n");
+
+	for (i = 0; i < BENCH_TIMER_COUNT; i++) Benchmark_AppendTimer(&str, i);
+	String_AppendConst(&str, "  }\n}");
+
+	Platform_Log(str.buffer, str.length);
+	res = Stream_WriteAllTo(&path, (cc_uint8*)str.buffer, str.length);
+	if (res) Logger_SysWarn(res, "saving benchmark results");
+
+#ifdef CC_BUILD_PROFILER
+	res = Profiler_DumpTrace(&tracePath);
+	if (res) Logger_SysWarn(res, "saving benchmark trace");
+#endif
+}
+
+static void Benchmark_EndFrame(cc_uint64 beg) {
+	cc_uint64 elapsed;
+	if (!Benchmark_IsActive()) return;
+
+	elapsed = Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
+	bench_frameTotal += elapsed;
+	bench_frameMin    = min(bench_frameMin, elapsed);
+	bench_frameMax    = max(bench_frameMax, elapsed);
+
+	if (++bench_frame < Game_BenchmarkFrames) return;
+	Benchmark_Finish();
+	/* Game_Running = false isn't enough, as single process mode would just restart the game */
+	Window_RequestClose();
+}
+
+static void Game_TickEntities(struct ScheduledTask* task) {
+	cc_uint64 beg = Benchmark_Begin();
+	Entities_Tick(task);
+	Benchmark_End(BENCH_ENTITIES_TICK, beg);
+}
+
+
+/*########################################################################################################################*
+*--------------------------------------------------------Profiler---------------------------------------------------------*
+*#########################################################################################################################*/
+#ifdef CC_BUILD_PROFILER
+#define PROF_MAX_FRAMES  64
+#define PROF_MAX_SCOPES 512
+#define PROF_MAX_DEPTH   16
+/* Max number of distinct scope names aggregated for the overlay */
+#define PROF_MAX_NAMES   64
+/* Max number of distinct scopes shown in the overlay */
+#define PROF_MAX_OVERLAY 10
+
+struct ProfScope { const char* name; cc_uint64 beg, end; int depth; };
+static struct ProfFrame {
+	cc_uint64 beg, end;
+	int count;
+	struct ProfScope scopes[PROF_MAX_SCOPES];
+} prof_frames[PROF_MAX_FRAMES];
+
+/* Index of the frame currently being recorded, and number of completed frames in the ring buffer */
+static int prof_cur, prof_completed;
+/* Indices of currently open scopes, or -1 if scope wasn't recorded (frame had too many scopes) */
+static int prof_stack[PROF_MAX_DEPTH], prof_depth;
+static cc_uint64 prof_lastOverlay;
+static cc_bool prof_showOverlay;
+
+void Profiler_Begin(const char* name) {
+	struct ProfFrame* frame = &prof_frames[prof_cur];
+	struct ProfScope* scope;
+	int index = -1;
+
+	if (prof_depth < PROF_MAX_DEPTH && frame->count < PROF_MAX_SCOPES) {
+		index = frame->count++;
+		scope = &frame->scopes[index];
+
+		scope->name  = name;
+		scope->depth = prof_depth;
+		scope->beg   = Stopwatch_Measure();
+		scope->end   = scope->beg;
+	}
+
+	if (prof_depth < PROF_MAX_DEPTH) prof_stack[prof_depth] = index;
+	prof_depth++;
+}
+
+void Profiler_End(void) {
+	int index;
+	if (!prof_depth) return;
+
+	prof_depth--;
+	if (prof_depth >= PROF_MAX_DEPTH) return;
+
+	index = prof_stack[prof_depth];
+	if (index >= 0) prof_frames[prof_cur].scopes[index].end = Stopwatch_Measure();
+}
+
+/* Returns the i'th oldest completed frame in the ring buffer */
+static struct ProfFrame* Profiler_GetFrame(int i) {
+	return &prof_frames[(prof_cur - prof_completed + i + PROF_MAX_FRAMES) % PROF_MAX_FRAMES];
+}
+
+struct ProfTotal { const char* name; cc_uint64 total; };
+
+static void Profiler_AddTotal(struct ProfTotal* totals, int* count, struct ProfScope* scope) {
+	cc_uint64 elapsed = Stopwatch_ElapsedMicroseconds(scope->beg, scope->end);
+	int i;
+
+	for (i = 0; i < *count; i++)
+	{
+		if (totals[i].name != scope->name) continue;
+		totals[i].total += elapsed; return;
+	}
+
+	if (*count == PROF_MAX_NAMES) return;
+	totals[*count].name  = scope->name;
+	totals[*count].total = elapsed;
+	(*count)++;
+}
+
+static void Profiler_UpdateOverlay(void) {
+	static const int lineTypes[] = {
+		MSG_TYPE_STATUS_2, MSG_TYPE_STATUS_3,
+		MSG_TYPE_BOTTOMRIGHT_1, MSG_TYPE_BOTTOMRIGHT_2, MSG_TYPE_BOTTOMRIGHT_3
+	};
+	struct ProfTotal totals[PROF_MAX_NAMES], tmp;
+	cc_string str; char strBuffer[STRING_SIZE];
+	cc_uint64 frameTotal = 0, frameMax = 0, elapsed;
+	struct ProfFrame* frame;
+	int i, j, count = 0;
+	float avgMs, maxMs;
+
+	for (i = 0; i < prof_completed; i++)
+	{
+		frame   = Profiler_GetFrame(i);
+		elapsed = Stopwatch_ElapsedMicroseconds(frame->beg, frame->end);
+		frameTotal += elapsed;
+		frameMax    = max(frameMax, elapsed);
+
+		/* Only top two levels of scopes, otherwise the overlay gets too cluttered */
+		for (j = 0; j < frame->count; j++)
+		{
+			if (frame->scopes[j].depth <= 1) Profiler_AddTotal(totals, &count, &frame->scopes[j]);
+		}
+	}
+	if (!prof_completed) return;
+
+	/* Partial selection sort, as only the slowest few scopes are shown */
+	for (i = 0; i < min(count, PROF_MAX_OVERLAY); i++)
+	{
+		for (j = i + 1; j < count; j++)
+		{
+			if (totals[j].total <= totals[i].total) continue;
+			tmp = totals[i]; totals[i] = totals[j]; totals[j] = tmp;
+		}
+	}
+
+	String_InitArray(str, strBuffer);
+	avgMs = (int)frameTotal / (1000.0f * prof_completed);
+	maxMs = (int)frameMax   /  1000.0f;
+	String_Format2(&str, "&eFrame &f%f2 ms &e(max &f%f2 ms&e)", &avgMs, &maxMs);
+	Chat_AddOf(&str, MSG_TYPE_STATUS_1);
+
+	/* Two scopes per line */
+	for (i = 0; i < Array_Elems(lineTypes); i++)
+	{
+		str.length = 0;
+		for (j = i * 2; j < i * 2 + 2 && j < count; j++)
+		{
+			avgMs = (int)totals[j].total / (1000.0f * prof_completed);
+			String_Format2(&str, "&e%c &f%f2 ms  ", totals[j].name, &avgMs);
+		}
+		Chat_AddOf(&str, lineTypes[i]);
+	}
+}
+
+void Profiler_SetOverlay(cc_bool show) {
+	prof_showOverlay = show;
+	if (show) return;
+
+	Chat_AddOf(&String_Empty, MSG_TYPE_STATUS_1);
+	Chat_AddOf(&String_Empty, MSG_TYPE_STATUS_2);
+	Chat_AddOf(&String_Empty, MSG_TYPE_STATUS_3);
+	Chat_AddOf(&String_Empty, MSG_TYPE_BOTTOMRIGHT_1);
+	Chat_AddOf(&String_Empty, MSG_TYPE_BOTTOMRIGHT_2);
+	Chat_AddOf(&String_Empty, MSG_TYPE_BOTTOMRIGHT_3);
+}
+
+void Profiler_EndFrame(cc_uint64 frameStart) {
+	struct ProfFrame* frame = &prof_frames[prof_cur];
+	/* Close any scopes accidentally left open, so nesting is valid again next frame */
+	while (prof_depth) Profiler_End();
+
+	frame->beg = frameStart;
+	frame->end = Stopwatch_Measure();
+	prof_cur   = (prof_cur + 1) % PROF_MAX_FRAMES;
+	/* Frame currently being recorded doesn't count as completed */
+	prof_completed = min(prof_completed + 1, PROF_MAX_FRAMES - 1);
+	prof_frames[prof_cur].count = 0;
+
+	/* Overlay is only refreshed once a second, as remaking chat textures isn't free */
+	if (!prof_showOverlay) return;
+	if (Stopwatch_ElapsedMicroseconds(prof_lastOverlay, frame->end) < 1000 * 1000) return;
+
+	prof_lastOverlay = frame->end;
+	Profiler_UpdateOverlay();
+}
+
+/* Writes a Chrome trace 'complete' event, with timestamps relative to the oldest frame */
+static void Profiler_AppendEvent(cc_string* str, const char* name, cc_uint64 base, cc_uint64 beg, cc_uint64 end) {
+	String_Format1(str, ",\n{\"name\":\"%c\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":", name);
+	String_AppendUInt32(str, (cc_uint32)Stopwatch_ElapsedMicroseconds(base, beg));
+	String_AppendConst(str, ",\"dur\":");
+	String_AppendUInt32(str, (cc_uint32)Stopwatch_ElapsedMicroseconds(beg, end));
+	String_Append(str, '}');
+}
+
+cc_result Profiler_DumpTrace(const cc_string* path) {
+	cc_string str; char strBuffer[4096];
+	struct ProfFrame* frame;
+	struct ProfScope* scope;
+	struct Stream stream;
+	cc_uint64 base;
+	int i, j;
+	cc_result res;
+
+	res = Stream_CreateFile(&stream, path);
+	if (res) return res;
+
+	String_InitArray(str, strBuffer);
+	String_AppendConst(&str, "{\"traceEvents\":[\n");
+	String_AppendConst(&str, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ClassiCube\"}}");
+
+	base = Profiler_GetFrame(0)->beg;
+
+	for (i = 0; i < prof_completed && !res; i++)
+	{
+		frame = Profiler_GetFrame(i);
+		Profiler_AppendEvent(&str, "Frame", base, frame->beg, frame->end);
+
+		for (j = 0; j < frame->count && !res; j++)
+		{
+			scope = &frame->scopes[j];
+			Profiler_AppendEvent(&str, scope->name, base, scope->beg, scope->end);
+
+			/* Flush before buffer could overflow */
+			if (str.length < str.capacity - 256) continue;
+			res = Stream_Write(&stream, (cc_uint8*)str.buffer, str.length);
+			str.length = 0;
+		}
+	}
+
+	String_AppendConst(&str, "\n]}\n");
+	if (!res) res = Stream_Write(&stream, (cc_uint8*)str.buffer, str.length);
+
+	if (res) { stream.Close(&stream); return res; }
+	return stream.Close(&stream);
+}
+#endif
+
+
 static void HandleOnNewMapLoaded(void* obj) {
 	struct IGameComponent* comp;
 	for (comp = comps_head; comp; comp = comp->next) {
 		if (comp->OnNewMapLoaded) comp->OnNewMapLoaded();
 	}
+	Benchmark_Start();
 }
 
 static void HandleInactiveChanged(void* obj) {
@@ -456,6 +875,11 @@ static void LoadPlugins(void) { }
 #endif
 
 static void Game_PendingClose(void* obj) { Game_Running = false; }
+/* Starts the job worker threads on the main thread, see Jobs_Init */
+static struct IGameComponent Jobs_Component = {
+	Jobs_Init /* Init */
+};
+
 static void Game_Load(void) {
 	struct IGameComponent* comp;
 	Game_UpdateDimensions();
@@ -473,6 +897,8 @@ static void Game_Load(void) {
 	Event_Register_(&WindowEvents.Closing,         NULL, Game_PendingClose);
 	Event_Register_(&WindowEvents.InactiveChanged, NULL, HandleInactiveChanged);
 
+	/* Job workers must be started before anything else (e.g. http workers) can submit jobs */
+	Game_AddComponent(&Jobs_Component);
 	Game_AddComponent(&World_Component);
 	Game_AddComponent(&Textures_Component);
 	Game_AddComponent(&Input_Component);
@@ -521,7 +947,7 @@ static void Game_Load(void) {
 			"Both default.zip and classicube.zip are missing,\n try downloading resources first.\n\nClassiCube will still run, but without any textures.");
 	}
 
-	entTaskI = ScheduledTask_Add(GAME_DEF_TICKS, Entities_Tick);
+	entTaskI = ScheduledTask_AddNamed(GAME_DEF_TICKS, Game_TickEntities, "Entities_Tick");
 	Gfx_WarnIfNecessary();
 
 	if (Gfx.Limitations & GFX_LIMIT_VERTEX_ONLY_FOG)
@@ -560,6 +986,7 @@ void Game_SetMinFrameTime(float frameTimeMS) {
 
 static void Render3DFrame(float delta, float t) {
 	struct Matrix mvp;
+	cc_uint64 beg;
 	Vec3 pos;
 
 	Camera.Active->GetView(&Gfx.View);
@@ -571,15 +998,29 @@ static void Render3DFrame(float delta, float t) {
 
 	if (EnvRenderer_ShouldRenderSkybox()) EnvRenderer_RenderSkybox();
 	AxisLinesRenderer_Render();
+	Profiler_Begin("Entities_Render");
 	Entities_RenderModels(delta, t);
 	EntityNames_Render();
+	Profiler_End();
+
+	beg = Benchmark_Begin();
+	Profiler_Begin("Particles_Render");
+	Particles_Render(delta, t);
+	Profiler_End();
+	Benchmark_End(BENCH_PARTICLES_RENDER, beg);
 
-	Particles_Render(t);
 	EnvRenderer_RenderSky();
 	EnvRenderer_RenderClouds();
 
+	beg = Benchmark_Begin();
+	Profiler_Begin("MapRenderer_Update");
 	MapRenderer_Update(delta);
+	Profiler_End();
+	Benchmark_End(BENCH_MAPRENDERER_UPDATE, beg);
+
+	Profiler_Begin("MapRenderer_RenderNormal");
 	MapRenderer_RenderNormal(delta);
+	Profiler_End();
 	EnvRenderer_RenderMapSides();
 
 	EntityShadows_Render();
@@ -589,6 +1030,7 @@ static void Render3DFrame(float delta, float t) {
 
 	/* Render water over translucent blocks when under the water outside the map for proper alpha blending */
 	pos = Camera.CurrentPos;
+	Profiler_Begin("MapRenderer_RenderTranslucent");
 	if (pos.y < Env.EdgeHeight && (pos.x < 0 || pos.z < 0 || pos.x > World.Width || pos.z > World.Length)) {
 		MapRenderer_RenderTranslucent(delta);
 		EnvRenderer_RenderMapEdges();
@@ -596,6 +1038,7 @@ static void Render3DFrame(float delta, float t) {
 		EnvRenderer_RenderMapEdges();
 		MapRenderer_RenderTranslucent(delta);
 	}
+	Profiler_End();
 
 	/* Need to render again over top of translucent block, as the selection outline */
 	/* is drawn without writing to the depth buffer */
@@ -621,21 +1064,86 @@ static void Render3D_Anaglyph(float delta, float t) {
 	Gfx_End3D(&proj, &view);
 }
 
+/* Max amount of time (in seconds) that a scheduled task can catch up on in one frame */
+/* Otherwise after a long frame, the next frame has to run many ticks and so is also long, and so on */
+#define TASK_MAX_CATCHUP 0.25
+
 static void PerformScheduledTasks(double time) {
 	struct ScheduledTask* task;
-	int i;
+	double skipped, lag = 0.0;
+	int i, ticks, maxTicks;
 
 	for (i = 0; i < tasksCount; i++) {
 		task = &tasks[i];
 		task->accumulator += time;
 
+		/* Drop whole ticks past the cap, so the fractional part used for interpolation is kept */
+		maxTicks = max(1, (int)(TASK_MAX_CATCHUP / task->interval));
+		ticks    = (int)(task->accumulator / task->interval);
+
+		if (ticks > maxTicks) {
+			skipped = (ticks - maxTicks) * task->interval;
+			task->accumulator -= skipped;
+			lag = max(lag, skipped);
+		}
+
 		while (task->accumulator >= task->interval) {
+			Profiler_Begin(task->name);
 			task->Callback(task);
+			Profiler_End();
 			task->accumulator -= task->interval;
 		}
 	}
+	Game.SimulationLag += (float)lag;
+}
+
+#ifdef CC_BUILD_WEB
+static void Screenshot_CheckPending(cc_bool wait) { }
+#else
+/* Screenshot that is being encoded and saved on a background thread */
+static struct {
+	struct Stream stream;
+	struct Bitmap bmp;
+	cc_filepath path;
+	cc_string filename; char fileBuffer[STRING_SIZE];
+	cc_result res;
+	cc_bool pending;
+} screenshot;
+static struct JobCounter screenshotJob;
+
+static void Screenshot_Encode(void* arg) {
+	screenshot.res = Png_Encode(&screenshot.bmp, &screenshot.stream, NULL, false, NULL);
+}
+
+static void Screenshot_Finish(void) {
+	cc_result res = screenshot.res;
+	Mem_Free(screenshot.bmp.scan0);
+	screenshot.bmp.scan0 = NULL;
+	screenshot.pending   = false;
+
+	if (res) {
+		Logger_IOWarn2(res, "saving to", &screenshot.path); screenshot.stream.Close(&screenshot.stream); return;
+	}
+
+	res = screenshot.stream.Close(&screenshot.stream);
+	if (res) { Logger_IOWarn2(res, "closing", &screenshot.path); return; }
+	Chat_Add1("&eTaken screenshot as: %s", &screenshot.filename);
+
+#ifdef CC_BUILD_MOBILE
+	Platform_ShareScreenshot(&screenshot.filename);
+#endif
 }
 
+/* Finishes saving the screenshot being encoded in the background, if it has been encoded */
+static void Screenshot_CheckPending(cc_bool wait) {
+	if (!screenshot.pending) return;
+
+	if (wait) Jobs_Wait(&screenshotJob);
+	if (screenshotJob.pending) return;
+	Screenshot_Finish();
+}
+#endif
+
 void Game_TakeScreenshot(void) {
 	cc_string filename; char fileBuffer[STRING_SIZE];
 	cc_string path;     char pathBuffer[FILENAME_SIZE];
@@ -643,9 +1151,6 @@ void Game_TakeScreenshot(void) {
 	cc_filepath raw_path;
 	cc_result res;
 
-#ifndef CC_BUILD_WEB
-	struct Stream stream;
-#endif
 	Game_ScreenshotRequested = false;
 	DateTime_CurrentLocal(&now);
 
@@ -658,26 +1163,33 @@ void Game_TakeScreenshot(void) {
 	Platform_EncodePath(&raw_path, &filename);
 	interop_TakeScreenshot(raw_path.buffer);
 #else
+	/* Only one screenshot is saved in the background at a time */
+	Screenshot_CheckPending(true);
 	if (!Utils_EnsureDirectory("screenshots")) return;
 	String_InitArray(path, pathBuffer);
 	String_Format1(&path, "screenshots/%s", &filename);
 
 	Platform_EncodePath(&raw_path, &path);
-	res = Stream_CreatePath(&stream, &raw_path);
+	res = Stream_CreatePath(&screenshot.stream, &raw_path);
 	if (res) { Logger_IOWarn2(res, "creating", &raw_path); return; }
 
-	res = Gfx_TakeScreenshot(&stream);
-	if (res) {
-		Logger_IOWarn2(res, "saving to", &raw_path); stream.Close(&stream); return;
-	}
+	screenshot.path = raw_path;
+	String_InitArray(screenshot.filename, screenshot.fileBuffer);
+	String_Copy(&screenshot.filename, &filename);
 
-	res = stream.Close(&stream);
-	if (res) { Logger_IOWarn2(res, "closing", &raw_path); return; }
-	Chat_Add1("&eTaken screenshot as: %s", &filename);
+	/* Only read back the framebuffer now, and leave encoding it to a background thread */
+	Png_SetCapture(&screenshot.bmp);
+	res = Gfx_TakeScreenshot(&screenshot.stream);
+	Png_SetCapture(NULL);
 
-#ifdef CC_BUILD_MOBILE
-	Platform_ShareScreenshot(&filename);
-#endif
+	screenshot.res = res;
+	/* Some backends don't encode through Png_Encode, and so have already saved the screenshot */
+	if (!res && screenshot.bmp.scan0) {
+		screenshot.pending = true;
+		Jobs_Submit(Screenshot_Encode, NULL, &screenshotJob);
+	} else {
+		Screenshot_Finish();
+	}
 #endif
 }
 
@@ -733,21 +1245,27 @@ static CC_INLINE void Game_DrawFrame(float delta, float t) {
 		Camera_KeyLookUpdate(delta);
 		InputHandler_Tick(delta);
 
+		Profiler_Begin("Render3D");
 		if (Game_Anaglyph3D) {
 			Render3D_Anaglyph(delta, t);
 		} else {
 			Render3DFrame(delta, t);
 		}
+		Profiler_End();
 	} else {
 		RayTracer_SetInvalid(&Game_SelectedPos);
 	}
 
 	Gfx_Begin2D(Game.Width, Game.Height);
+	Profiler_Begin("Gui_Render");
 	Gui_RenderGui(delta);
+	Profiler_End();
+	Profiler_Begin("Draw2DHooks");
 	for (i = 0; i < Array_Elems(Game.Draw2DHooks); i++)
 	{
 		if (Game.Draw2DHooks[i]) Game.Draw2DHooks[i](delta);
 	}
+	Profiler_End();
 
 /* TODO find a better solution than this */
 #ifdef CC_BUILD_3DS
@@ -795,6 +1313,7 @@ void Game_RenderFrame(void) {
 	cc_uint64 elapsed = Stopwatch_ElapsedMicroseconds(frameStart, render);
 	/* avoid large delta with suspended process */
 	if (elapsed > 5000000) elapsed = 5000000;
+	if (Game_BenchmarkFrames) elapsed = BENCH_FRAME_MICROS;
 	
 	deltaD = (int)elapsed / (1000.0 * 1000.0);
 	delta  = (float)deltaD;
@@ -821,7 +1340,8 @@ void Game_RenderFrame(void) {
 	Gfx_BeginFrame();
 	Gfx_BindIb(Gfx.DefaultIb);
 	Game.Time += deltaD;
-	Game_Vertices = 0;
+	Game_Vertices  = 0;
+	Game_DrawCalls = 0;
 	Gamepad_Tick(delta);
 
 #ifdef CC_BUILD_SPLITSCREEN
@@ -838,14 +1358,18 @@ void Game_RenderFrame(void) {
 	Camera.Active->UpdateMouse(Entities.CurPlayer, delta);
 #endif
 
-	if (!Window_Main.Focused && !Gui.InputGrab && autoPause) 
+	if (!Window_Main.Focused && !Gui.InputGrab && autoPause && !Game_BenchmarkFrames) 
 		Gui_ShowPauseMenu();
 
 	if (Bind_IsTriggered[BIND_ZOOM_SCROLL] && !Gui.InputGrab) {
 		InputHandler_SetFOV(Camera.ZoomFov);
 	}
 
+	Benchmark_Tick();
+	Profiler_Begin("ScheduledTasks");
 	PerformScheduledTasks(deltaD);
+	Profiler_End();
+	TexturePack_Update();
 	entTask = tasks[entTaskI];
 	t = (float)(entTask.accumulator / entTask.interval);
 	LocalPlayer_SetInterpPosition(Entities.CurPlayer, t);
@@ -857,8 +1381,9 @@ void Game_RenderFrame(void) {
 
 #if !defined CC_BUILD_SYMBIAN
 	/* TODO: Not calling Gfx_EndFrame doesn't work with Direct3D9 */
-	if (Window_Main.Inactive) return;
+	if (Window_Main.Inactive) { Profiler_EndFrame(render); return; }
 #endif
+	Profiler_Begin("Game_DrawFrame");
 	Gfx_ClearBuffers(GFX_BUFFER_COLOR | GFX_BUFFER_DEPTH);
 	
 #ifdef CC_BUILD_SPLITSCREEN
@@ -884,10 +1409,20 @@ void Game_RenderFrame(void) {
 #else
 	Game_DrawFrame(delta, t);
 #endif
+	Profiler_End();
 
+	Screenshot_CheckPending(false);
 	if (Game_ScreenshotRequested) Game_TakeScreenshot();
+	Profiler_Begin("Gfx_EndFrame");
 	Gfx_EndFrame();
-	if (gfx_minFrameMs != 0.0f) LimitFPS();
+	Profiler_End();
+	Profiler_EndFrame(render);
+
+	if (Game_BenchmarkFrames) {
+		Benchmark_EndFrame(render);
+	} else if (gfx_minFrameMs != 0.0f) { 
+		LimitFPS(); 
+	}
 }
 
 void Game_Free(void) {
@@ -897,6 +1432,7 @@ void Game_Free(void) {
 	Gfx.ManagedTextures = false;
 	Event_UnregisterAll();
 	tasksCount = 0;
+	Screenshot_CheckPending(true);
 
 	for (comp = comps_head; comp; comp = comp->next)
 	{
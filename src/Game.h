@@ -21,6 +21,9 @@ CC_VAR extern struct _GameData {
 	/* Index of current game state being used (for splitscreen multiplayer) */
 	int CurrentState;
 	Game_Draw2DHook Draw2DHooks[4];
+	/* Time (in seconds) of scheduled ticks skipped within last second, due to falling too far behind. */
+	/* Resets to 0 after every second. */
+	float SimulationLag;
 } Game;
 
 extern struct RayTracer Game_SelectedPos;
@@ -56,6 +59,8 @@ extern int Game_UserViewDistance;
 extern int     Game_FpsLimit;
 extern cc_bool Game_SimpleArmsAnim;
 extern int     Game_Vertices;
+/* Number of draw calls used to render the world in the current frame */
+extern int     Game_DrawCalls;
 
 extern cc_bool Game_ClassicMode;
 extern cc_bool Game_ClassicHacks;
@@ -102,6 +107,43 @@ extern cc_bool Game_BreakableLiquids;
 extern cc_bool Game_ScreenshotRequested;
 extern cc_bool Game_HideGui;
 
+/* Subsystems timed while running the headless benchmark (see --benchmark) */
+enum BenchmarkTimer_ {
+	BENCH_MAPRENDERER_UPDATE, BENCH_BUILDER_MAKECHUNK, BENCH_PHYSICS_TICK,
+	BENCH_ENTITIES_TICK, BENCH_PARTICLES_RENDER, BENCH_TIMER_COUNT
+};
+/* Number of frames the benchmark runs for after the map has loaded */
+/* 0 when not running the benchmark */
+extern int Game_BenchmarkFrames;
+/* Fixed seed used for the map and all other random state when benchmarking */
+#define BENCHMARK_SEED 20240601
+#define BENCHMARK_DEF_FRAMES 1200
+/* Adds time elapsed since beg to the given benchmark timer */
+void Benchmark_AddTime(int timer, cc_uint64 beg);
+
+#define Benchmark_Begin()         (Game_BenchmarkFrames ? Stopwatch_Measure() : 0)
+#define Benchmark_End(timer, beg) (Game_BenchmarkFrames ? Benchmark_AddTime(timer, beg) : (void)0)
+
+/* Frame profiler, only compiled in when CC_BUILD_PROFILER is defined (e.g. make BUILD_PROFILER=1) */
+/* Scopes must be begun and ended in matching pairs on the main thread */
+#ifdef CC_BUILD_PROFILER
+/* Sets whether the profiler overlay is shown in the top/bottom right status lines */
+void Profiler_SetOverlay(cc_bool show);
+/* Starts timing a scope nested inside the currently open scope (if any) */
+/* NOTE: name must be a string literal, as only the pointer is stored */
+void Profiler_Begin(const char* name);
+/* Finishes timing the most recently begun scope */
+void Profiler_End(void);
+/* Moves onto the next frame in the profiler's ring buffer of frames */
+void Profiler_EndFrame(cc_uint64 frameStart);
+/* Writes all frames in the ring buffer to the given file in Chrome trace event format */
+cc_result Profiler_DumpTrace(const cc_string* path);
+#else
+#define Profiler_Begin(name)
+#define Profiler_End()
+#define Profiler_EndFrame(frameStart)
+#endif
+
 enum GAME_VERSION_ {
 	VERSION_0017 = 27, VERSION_0019 = 28, VERSION_0023 = 29, VERSION_0030 = 30, VERSION_CPE = 31
 };
@@ -195,11 +237,16 @@ struct ScheduledTask {
 	double interval;
 	/* Callback function that is periodically invoked */
 	void (*Callback)(struct ScheduledTask* task);
+	/* Name the callback is timed under by the frame profiler */
+	const char* name;
 };
 
 typedef void (*ScheduledTaskCallback)(struct ScheduledTask* task);
 /* Adds a task to list of scheduled tasks. (always at end) */
 CC_API int ScheduledTask_Add(double interval, ScheduledTaskCallback callback);
+/* Adds a task to list of scheduled tasks, which the profiler times under the given name. (always at end) */
+/* NOTE: name must be a string literal, as only the pointer is stored */
+CC_API int ScheduledTask_AddNamed(double interval, ScheduledTaskCallback callback, const char* name);
 
 CC_END_HEADER
 #endif
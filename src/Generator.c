@@ -13,6 +13,7 @@
 
 const struct MapGenerator* gen_active;
 BlockRaw* Gen_Blocks;
+cc_bool Gen_Parallel = true;
 int Gen_Theme;
 
 const struct GenThemeData Gen_Themes[GEN_THEME_COUNT - 1] = {
@@ -191,6 +192,12 @@ volatile float Gen_CurrentProgress;
 volatile const char* Gen_CurrentState;
 volatile static cc_bool gen_done;
 
+/* Logs how long a generation step took, to help find which steps dominate generation time */
+static void Gen_LogStep(const char* name, cc_uint64 beg) {
+	int ms = Stopwatch_ElapsedMS(beg, Stopwatch_Measure());
+	Platform_Log2("Gen step %c took %i ms", name, &ms);
+}
+
 /* There are two main types of multitasking: */
 /*  - Pre-emptive multitasking (system automatically switches between threads) */
 /*  - Cooperative multitasking (threads must be manually switched by the app) */
@@ -212,7 +219,9 @@ static cc_uint64 lastRender;
 
 #define GEN_COOP_STEP(index, step) \
 	case index: \
+		curTime = Stopwatch_Measure(); \
 		step; \
+		Gen_LogStep(#step, curTime); \
 		gen_step++; \
 		curTime = Stopwatch_Measure(); \
 		if (Stopwatch_ElapsedMS(lastRender, curTime) > 100) { lastRender = curTime; return; }
@@ -236,7 +245,8 @@ cc_bool Gen_IsDone(void) {
 /* For systems supporting preemptive threading, there's no point */
 /* bothering with all the cooperative tasking shenanigans */
 #define GEN_COOP_BEGIN
-#define GEN_COOP_STEP(index, step) step;
+#define GEN_COOP_STEP(index, step) \
+	{ cc_uint64 stepBeg = Stopwatch_Measure(); step; Gen_LogStep(#step, stepBeg); }
 #define GEN_COOP_END
 
 static void Gen_DoGen(void) {
@@ -278,6 +288,32 @@ void Gen_Start(const struct MapGenerator* gen, int seed,
 	GeneratingScreen_Show();
 }
 
+cc_bool Gen_RunBlocking(const struct MapGenerator* gen, int seed, BlockRaw* blocks) {
+	const struct MapGenerator* prevGen = gen_active;
+	BlockRaw* prevBlocks = Gen_Blocks;
+	cc_bool prepared;
+	if (!gen_done && prevGen) return false;
+
+	gen_active = gen;
+	Gen_Blocks = blocks;
+	Gen_Reset();
+
+	prepared = gen->Prepare(seed);
+	if (prepared) {
+#ifdef CC_BUILD_COOPTHREADED
+		gen_step = 0;
+		while (!gen_done) gen->Generate();
+#else
+		gen->Generate();
+#endif
+	}
+
+	gen_active = prevGen;
+	Gen_Blocks = prevBlocks;
+	gen_done   = true;
+	return prepared;
+}
+
 
 /*########################################################################################################################*
 *-----------------------------------------------------Flatgrass gen-------------------------------------------------------*
@@ -430,6 +466,92 @@ static float OctaveNoise_Calc(const struct OctaveNoise* n, float x, float y) {
 	return sum;
 }
 
+/* Calculates noise for 4 points at once, producing identical results to calling ImprovedNoise_Calc 4 times */
+/* Only x86-64 is guaranteed to use plain SSE float math (no x87 or fused multiply-add) for the scalar version */
+#if defined __x86_64__ || defined _M_X64
+#include <emmintrin.h>
+#define NOISE_SIMD
+cc_bool Gen_NoiseSIMD = true;
+
+static __m128 ImprovedNoise_Calc4(const cc_uint8* p, __m128 x, __m128 y) {
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	__m128i xFloor, yFloor;
+	__m128 u, v, c1, c2;
+	__m128 g22, g12, g21, g11;
+	int X[4], Y[4], gx[4][4], gy[4][4];
+	int i, A, B, hash;
+
+	/* (int)x - 1 for negative x, relying on comparisons producing -1 for true */
+	xFloor = _mm_add_epi32(_mm_cvttps_epi32(x), _mm_castps_si128(_mm_cmplt_ps(x, zero)));
+	yFloor = _mm_add_epi32(_mm_cvttps_epi32(y), _mm_castps_si128(_mm_cmplt_ps(y, zero)));
+	_mm_storeu_si128((__m128i*)X, _mm_and_si128(xFloor, mask));
+	_mm_storeu_si128((__m128i*)Y, _mm_and_si128(yFloor, mask));
+	x = _mm_sub_ps(x, _mm_cvtepi32_ps(xFloor));
+	y = _mm_sub_ps(y, _mm_cvtepi32_ps(yFloor));
+
+	u = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(x, x), x), _mm_add_ps(_mm_mul_ps(x, 
+		_mm_sub_ps(_mm_mul_ps(x, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f)));
+	v = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(y, y), y), _mm_add_ps(_mm_mul_ps(y, 
+		_mm_sub_ps(_mm_mul_ps(y, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f)));
+
+	/* Permutation table lookups can't be vectorised with SSE2 */
+	for (i = 0; i < 4; i++) {
+		A = p[X[i]] + Y[i]; B = p[X[i] + 1] + Y[i];
+
+		hash = (p[p[A]] & 0xF) << 1;
+		gx[0][i] = ((X_FLAGS >> hash) & 3) - 1; gy[0][i] = ((Y_FLAGS >> hash) & 3) - 1;
+		hash = (p[p[B]] & 0xF) << 1;
+		gx[1][i] = ((X_FLAGS >> hash) & 3) - 1; gy[1][i] = ((Y_FLAGS >> hash) & 3) - 1;
+		hash = (p[p[A + 1]] & 0xF) << 1;
+		gx[2][i] = ((X_FLAGS >> hash) & 3) - 1; gy[2][i] = ((Y_FLAGS >> hash) & 3) - 1;
+		hash = (p[p[B + 1]] & 0xF) << 1;
+		gx[3][i] = ((X_FLAGS >> hash) & 3) - 1; gy[3][i] = ((Y_FLAGS >> hash) & 3) - 1;
+	}
+
+#define Grad4(i, x, y) _mm_add_ps( \
+	_mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)gx[i])), x), \
+	_mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)gy[i])), y))
+
+	g22 = Grad4(0, x,                   y);
+	g12 = Grad4(1, _mm_sub_ps(x, one),  y);
+	c1  = _mm_add_ps(g22, _mm_mul_ps(u, _mm_sub_ps(g12, g22)));
+
+	g21 = Grad4(2, x,                  _mm_sub_ps(y, one));
+	g11 = Grad4(3, _mm_sub_ps(x, one), _mm_sub_ps(y, one));
+	c2  = _mm_add_ps(g21, _mm_mul_ps(u, _mm_sub_ps(g11, g21)));
+
+	return _mm_add_ps(c1, _mm_mul_ps(v, _mm_sub_ps(c2, c1)));
+}
+
+static __m128 OctaveNoise_CalcSIMD(const struct OctaveNoise* n, __m128 x, __m128 y) {
+	float amplitude = 1, freq = 1;
+	__m128 sum = _mm_setzero_ps();
+	int i;
+
+	for (i = 0; i < n->octaves; i++) {
+		sum = _mm_add_ps(sum, _mm_mul_ps(ImprovedNoise_Calc4(n->p[i], 
+				_mm_mul_ps(x, _mm_set1_ps(freq)), _mm_mul_ps(y, _mm_set1_ps(freq))), _mm_set1_ps(amplitude)));
+		amplitude *= 2.0f;
+		freq *= 0.5f;
+	}
+	return sum;
+}
+#else
+cc_bool Gen_NoiseSIMD = false;
+#endif
+
+static void OctaveNoise_Calc4(const struct OctaveNoise* n, const float* x, const float* y, float* out) {
+	int i;
+#ifdef NOISE_SIMD
+	if (Gen_NoiseSIMD) {
+		_mm_storeu_ps(out, OctaveNoise_CalcSIMD(n, _mm_loadu_ps(x), _mm_loadu_ps(y)));
+		return;
+	}
+#endif
+	for (i = 0; i < 4; i++) { out[i] = OctaveNoise_Calc(n, x[i], y[i]); }
+}
+
 
 struct CombinedNoise { struct OctaveNoise noise1, noise2; };
 static void CombinedNoise_Init(struct CombinedNoise* n, RNGState* rnd, int octaves1, int octaves2) {
@@ -442,6 +564,20 @@ static float CombinedNoise_Calc(const struct CombinedNoise* n, float x, float y)
 	return OctaveNoise_Calc(&n->noise1, x + offset, y);
 }
 
+static void CombinedNoise_Calc4(const struct CombinedNoise* n, const float* x, const float* y, float* out) {
+	int i;
+#ifdef NOISE_SIMD
+	__m128 xs, ys, offset;
+	if (Gen_NoiseSIMD) {
+		xs = _mm_loadu_ps(x); ys = _mm_loadu_ps(y);
+		offset = OctaveNoise_CalcSIMD(&n->noise2, xs, ys);
+		_mm_storeu_ps(out, OctaveNoise_CalcSIMD(&n->noise1, _mm_add_ps(xs, offset), ys));
+		return;
+	}
+#endif
+	for (i = 0; i < 4; i++) { out[i] = CombinedNoise_Calc(n, x[i], y[i]); }
+}
+
 
 /*########################################################################################################################*
 *----------------------------------------------------Notchy map gen-------------------------------------------------------*
@@ -450,13 +586,15 @@ static int waterLevel, minHeight;
 static cc_int16* heightmap;
 static RNGState rnd;
 
-static void NotchyGen_FillOblateSpheroid(int x, int y, int z, float radius, BlockRaw block) {
-	int xBeg = Math_Floor(max(x - radius, 0));
-	int xEnd = Math_Floor(min(x + radius, World.MaxX));
+/* Fills the part of the spheroid within the given X/Z bounds */
+static void NotchyGen_FillSpheroidPart(int x, int y, int z, float radius, BlockRaw block,
+										int minX, int minZ, int maxX, int maxZ) {
+	int xBeg = max(Math_Floor(max(x - radius, 0)),           minX);
+	int xEnd = min(Math_Floor(min(x + radius, World.MaxX)),  maxX);
 	int yBeg = Math_Floor(max(y - radius, 0));
 	int yEnd = Math_Floor(min(y + radius, World.MaxY));
-	int zBeg = Math_Floor(max(z - radius, 0));
-	int zEnd = Math_Floor(min(z + radius, World.MaxZ));
+	int zBeg = max(Math_Floor(max(z - radius, 0)),           minZ);
+	int zEnd = min(Math_Floor(min(z + radius, World.MaxZ)),  maxZ);
 
 	float radiusSq = radius * radius;
 	int index;
@@ -482,17 +620,160 @@ static void NotchyGen_FillOblateSpheroid(int x, int y, int z, float radius, Bloc
 	}
 }
 
+static void NotchyGen_FillOblateSpheroid(int x, int y, int z, float radius, BlockRaw block) {
+	NotchyGen_FillSpheroidPart(x, y, z, radius, block, 0, 0, World.MaxX, World.MaxZ);
+}
+
+
+/* Carving caves and ores only depends on the RNG, not on the blocks already in the map */
+/*  So the spheroids are first quickly recorded, then filled in afterwards on multiple threads */
+/* The map is split into tiles of columns, with each tile filling just its part of all the */
+/*  spheroids that overlap it in the same order they were recorded (so results are identical) */
+struct CarveOp { int x, y, z; float radius; BlockRaw block; };
+#define CARVE_MAX_OPS    (1024 * 64)
+#define CARVE_TILE_SHIFT 5
+#define CARVE_TILE_SIZE  (1 << CARVE_TILE_SHIFT)
+
+static struct CarveOp* carve_ops;
+static int carve_count, carve_tilesX;
+static int* carve_tileEnds; /* End of each tile's op indices in carve_tileOps */
+static int* carve_tileOps;  /* Indices of ops overlapping each tile, in recorded order */
+
+/* Returns false if the spheroid doesn't affect any blocks in the map */
+static cc_bool NotchyGen_CarveTiles(const struct CarveOp* op, int* x1, int* z1, int* x2, int* z2) {
+	int xBeg = Math_Floor(max(op->x - op->radius, 0));
+	int xEnd = Math_Floor(min(op->x + op->radius, World.MaxX));
+	int yBeg = Math_Floor(max(op->y - op->radius, 0));
+	int yEnd = Math_Floor(min(op->y + op->radius, World.MaxY));
+	int zBeg = Math_Floor(max(op->z - op->radius, 0));
+	int zEnd = Math_Floor(min(op->z + op->radius, World.MaxZ));
+	if (xBeg > xEnd || yBeg > yEnd || zBeg > zEnd) return false;
+
+	*x1 = xBeg >> CARVE_TILE_SHIFT; *x2 = xEnd >> CARVE_TILE_SHIFT;
+	*z1 = zBeg >> CARVE_TILE_SHIFT; *z2 = zEnd >> CARVE_TILE_SHIFT;
+	return true;
+}
+
+static void NotchyGen_CarveTileRange(void* arg, int beg, int end) {
+	const struct CarveOp* op;
+	int minX, minZ, maxX, maxZ;
+	int i, tile;
+
+	for (tile = beg; tile < end; tile++) {
+		minX = (tile % carve_tilesX) * CARVE_TILE_SIZE;
+		minZ = (tile / carve_tilesX) * CARVE_TILE_SIZE;
+		maxX = min(minX + CARVE_TILE_SIZE - 1, World.MaxX);
+		maxZ = min(minZ + CARVE_TILE_SIZE - 1, World.MaxZ);
+
+		for (i = tile ? carve_tileEnds[tile - 1] : 0; i < carve_tileEnds[tile]; i++) {
+			op = &carve_ops[carve_tileOps[i]];
+			NotchyGen_FillSpheroidPart(op->x, op->y, op->z, op->radius, op->block, minX, minZ, maxX, maxZ);
+		}
+	}
+}
+
+static cc_bool NotchyGen_BucketCarves(void) {
+	int tilesZ, numTiles, total = 0;
+	int i, tx, tz, x1, z1, x2, z2;
+
+	carve_tilesX = (World.Width  + CARVE_TILE_SIZE - 1) >> CARVE_TILE_SHIFT;
+	tilesZ       = (World.Length + CARVE_TILE_SIZE - 1) >> CARVE_TILE_SHIFT;
+	numTiles     = carve_tilesX * tilesZ;
+
+	carve_tileEnds = (int*)Mem_TryAllocCleared(numTiles, sizeof(int));
+	if (!carve_tileEnds) return false;
+
+	for (i = 0; i < carve_count; i++) {
+		if (!NotchyGen_CarveTiles(&carve_ops[i], &x1, &z1, &x2, &z2)) continue;
+
+		for (tz = z1; tz <= z2; tz++)
+			for (tx = x1; tx <= x2; tx++) { carve_tileEnds[tz * carve_tilesX + tx]++; total++; }
+	}
+
+	carve_tileOps = (int*)Mem_TryAlloc(max(total, 1), sizeof(int));
+	if (!carve_tileOps) return false;
+
+	/* Convert counts into starts, which become ends after adding each tile's ops */
+	for (i = 0, total = 0; i < numTiles; i++) {
+		tx = carve_tileEnds[i]; carve_tileEnds[i] = total; total += tx;
+	}
+	for (i = 0; i < carve_count; i++) {
+		if (!NotchyGen_CarveTiles(&carve_ops[i], &x1, &z1, &x2, &z2)) continue;
+
+		for (tz = z1; tz <= z2; tz++)
+			for (tx = x1; tx <= x2; tx++) { carve_tileOps[carve_tileEnds[tz * carve_tilesX + tx]++] = i; }
+	}
+	return true;
+}
+
+static void NotchyGen_FlushCarves(void) {
+	const struct CarveOp* op;
+	int i;
+
+	if (Gen_Parallel && NotchyGen_BucketCarves()) {
+		Jobs_ParallelFor(carve_tilesX * ((World.Length + CARVE_TILE_SIZE - 1) >> CARVE_TILE_SHIFT),
+						1, NotchyGen_CarveTileRange, NULL);
+	} else {
+		for (i = 0; i < carve_count; i++) {
+			op = &carve_ops[i];
+			NotchyGen_FillOblateSpheroid(op->x, op->y, op->z, op->radius, op->block);
+		}
+	}
+
+	Mem_Free(carve_tileEnds); carve_tileEnds = NULL;
+	Mem_Free(carve_tileOps);  carve_tileOps  = NULL;
+	carve_count = 0;
+}
+
+static void NotchyGen_Carve(int x, int y, int z, float radius, BlockRaw block) {
+	struct CarveOp* op;
+	if (!carve_ops) carve_ops = (struct CarveOp*)Mem_TryAlloc(CARVE_MAX_OPS, sizeof(struct CarveOp));
+
+	/* Fallback to filling straight away when out of memory */
+	if (!carve_ops) { NotchyGen_FillOblateSpheroid(x, y, z, radius, block); return; }
+
+	op = &carve_ops[carve_count++];
+	op->x = x; op->y = y; op->z = z;
+	op->radius = radius; op->block = block;
+	if (carve_count == CARVE_MAX_OPS) NotchyGen_FlushCarves();
+}
+
+/* Fills in all remaining recorded spheroids */
+static void NotchyGen_FinishCarving(void) {
+	if (carve_count) NotchyGen_FlushCarves();
+	Mem_Free(carve_ops);
+	carve_ops = NULL;
+}
+
 #if CC_BUILD_MAXSTACK <= (32 * 1024)
 	#define STACK_FAST 512
 #else
 	#define STACK_FAST 8192
 #endif
 
+/* Pushes the start of each run of air blocks in the given row between x1 and x2 */
+static void NotchyGen_PushSpans(int** stack, int* count, int* limit, int row, int x1, int x2) {
+	cc_bool inSpan = false;
+	int x;
+
+	for (x = x1; x <= x2; x++) {
+		if (Gen_Blocks[row + x] != BLOCK_AIR) { inSpan = false; continue; }
+		if (inSpan) continue;
+
+		if (*count == *limit) Utils_Resize((void**)stack, limit, 4, STACK_FAST, STACK_FAST);
+		(*stack)[(*count)++] = row + x;
+		inSpan = true;
+	}
+}
+
+/* Fills all air blocks reachable from the given block by moving along X, Z, or down */
+/* Whole runs of air along the X axis are filled at once, then only the start of each */
+/*  run of air in the rows beside and below the run are pushed to be filled later */
 static void NotchyGen_FloodFill(int index, BlockRaw block) {
 	int* stack;
 	int stack_default[STACK_FAST]; /* avoid allocating memory if possible */
 	int count = 0, limit = STACK_FAST;
-	int x, y, z;
+	int x1, x2, y, z, row;
 
 	stack = stack_default;
 	if (index < 0) return; /* y below map, don't bother starting */
@@ -500,77 +781,107 @@ static void NotchyGen_FloodFill(int index, BlockRaw block) {
 
 	while (count) {
 		index = stack[--count];
-
 		if (Gen_Blocks[index] != BLOCK_AIR) continue;
-		Gen_Blocks[index] = block;
 
-		x = index  % World.Width;
+		x1  = index % World.Width;
+		row = index - x1;
+		x2  = x1;
+		while (x1 > 0          && Gen_Blocks[row + x1 - 1] == BLOCK_AIR) x1--;
+		while (x2 < World.MaxX && Gen_Blocks[row + x2 + 1] == BLOCK_AIR) x2++;
+		Mem_Set(Gen_Blocks + row + x1, block, x2 - x1 + 1);
+
 		y = index  / World.OneY;
 		z = (index / World.Width) % World.Length;
 
-		/* need to increase stack */
-		if (count >= limit - FACE_COUNT) {
-			Utils_Resize((void**)&stack, &limit, 4, STACK_FAST, STACK_FAST);
-		}
-
-		if (x > 0)          { stack[count++] = index - 1; }
-		if (x < World.MaxX) { stack[count++] = index + 1; }
-		if (z > 0)          { stack[count++] = index - World.Width; }
-		if (z < World.MaxZ) { stack[count++] = index + World.Width; }
-		if (y > 0)          { stack[count++] = index - World.OneY; }
+		if (z > 0)          NotchyGen_PushSpans(&stack, &count, &limit, row - World.Width, x1, x2);
+		if (z < World.MaxZ) NotchyGen_PushSpans(&stack, &count, &limit, row + World.Width, x1, x2);
+		if (y > 0)          NotchyGen_PushSpans(&stack, &count, &limit, row - World.OneY,  x1, x2);
 	}
 	if (limit > STACK_FAST) Mem_Free(stack);
 }
 
 
-static void NotchyGen_CreateHeightmap(void) {
+struct HeightmapNoise { struct CombinedNoise n1, n2; struct OctaveNoise n3; };
+static volatile int gen_rowsDone;
+
+/* Rows may be generated on several threads at once, so progress is tracked by number of completed rows */
+/* (racy increments may lose a few rows, which only affects the progress bar) */
+static void Gen_RowCompleted(void) {
+	gen_rowsDone++;
+	Gen_CurrentProgress = (float)gen_rowsDone / World.Length;
+}
+
+/* Calls func for every Z row of the map, split across worker threads when possible */
+static void Gen_ForEachRow(Job_RangeFunc func, void* arg) {
+	gen_rowsDone = 0;
+	if (Gen_Parallel) {
+		Jobs_ParallelFor(World.Length, 4, func, arg);
+	} else {
+		func(arg, 0, World.Length);
+	}
+}
+
+static void NotchyGen_HeightmapRows(void* arg, int zBeg, int zEnd) {
+	struct HeightmapNoise* noise = (struct HeightmapNoise*)arg;
+	float xs[4], xsScaled[4], zs[4], zsScaled[4];
+	float low[4], high[4], select[4];
 	float hLow, hHigh, height;
-	int hIndex = 0, adjHeight;
-	int x, z;
+	int i, x, z, count;
+	cc_bool anyHigh;
 
-#if CC_BUILD_MAXSTACK <= (16 * 1024)
-	struct NoiseBuffer { 
-		struct CombinedNoise n1, n2;
-		struct OctaveNoise n3;
-	};
-	void* mem = TempMem_Alloc(sizeof(struct NoiseBuffer));
+	for (z = zBeg; z < zEnd; z++) {
+		for (i = 0; i < 4; i++) { zs[i] = (float)z; zsScaled[i] = z * 1.3f; }
 
-	struct NoiseBuffer* buf  = (struct NoiseBuffer*)mem;
-	struct CombinedNoise* n1 = &buf->n1;
-	struct CombinedNoise* n2 = &buf->n2;
-	struct OctaveNoise*   n3 = &buf->n3;
-#else
-	struct CombinedNoise _n1, *n1 = &_n1;
-	struct CombinedNoise _n2, *n2 = &_n2;
-	struct OctaveNoise   _n3, *n3 = &_n3;
-#endif
+		/* Noise is always calculated 4 columns at a time, even past the end of the row */
+		for (x = 0; x < World.Width; x += 4) {
+			for (i = 0; i < 4; i++) { xs[i] = (float)(x + i); xsScaled[i] = (x + i) * 1.3f; }
+			count = min(4, World.Width - x);
 
-	CombinedNoise_Init(n1, &rnd, 8, 8);
-	CombinedNoise_Init(n2, &rnd, 8, 8);	
-	OctaveNoise_Init(n3,   &rnd, 6);
+			CombinedNoise_Calc4(&noise->n1, xsScaled, zsScaled, low);
+			OctaveNoise_Calc4(&noise->n3, xs, zs, select);
 
-	Gen_CurrentState = "Building heightmap";
-	for (z = 0; z < World.Length; z++) {
-		Gen_CurrentProgress = (float)z / World.Length;
+			anyHigh = false;
+			for (i = 0; i < count; i++) { anyHigh |= select[i] <= 0; }
+			if (anyHigh) CombinedNoise_Calc4(&noise->n2, xsScaled, zsScaled, high);
 
-		for (x = 0; x < World.Width; x++) {
-			hLow   = CombinedNoise_Calc(n1, x * 1.3f, z * 1.3f) / 6 - 4;
-			height = hLow;
+			for (i = 0; i < count; i++) {
+				hLow   = low[i] / 6 - 4;
+				height = hLow;
 
-			if (OctaveNoise_Calc(n3, (float)x, (float)z) <= 0) {
-				hHigh = CombinedNoise_Calc(n2, x * 1.3f, z * 1.3f) / 5 + 6;
-				height = max(hLow, hHigh);
+				if (select[i] <= 0) {
+					hHigh  = high[i] / 5 + 6;
+					height = max(hLow, hHigh);
+				}
+
+				height *= 0.5f;
+				if (height < 0) height *= 0.8f;
+
+				height *= Gen_GetTheme()->heightScale;
+				heightmap[z * World.Width + x + i] = (int)(height + waterLevel);
 			}
+		}
+		Gen_RowCompleted();
+	}
+}
 
-			height *= 0.5f;
-			if (height < 0) height *= 0.8f;
+static void NotchyGen_CreateHeightmap(void) {
+	int i, count = World.Width * World.Length;
+#if CC_BUILD_MAXSTACK <= (16 * 1024)
+	void* mem = TempMem_Alloc(sizeof(struct HeightmapNoise));
+	struct HeightmapNoise* noise = (struct HeightmapNoise*)mem;
+#else
+	struct HeightmapNoise _noise, *noise = &_noise;
+#endif
 
-			height *= Gen_GetTheme()->heightScale;
+	CombinedNoise_Init(&noise->n1, &rnd, 8, 8);
+	CombinedNoise_Init(&noise->n2, &rnd, 8, 8);	
+	OctaveNoise_Init(&noise->n3,   &rnd, 6);
 
-			adjHeight = (int)(height + waterLevel);
-			minHeight = min(adjHeight, minHeight);
-			heightmap[hIndex++] = adjHeight;
-		}
+	Gen_CurrentState = "Building heightmap";
+	Gen_ForEachRow(NotchyGen_HeightmapRows, noise);
+
+	for (i = 0; i < count; i++) {
+		minHeight = min(heightmap[i], minHeight);
 	}
 }
 
@@ -603,43 +914,77 @@ static int NotchyGen_CreateStrataFast(void) {
 	return max(stoneHeight, 1);
 }
 
-static void NotchyGen_CreateStrata(void) {
-	int dirtThickness, dirtHeight;
-	int minStoneY, stoneHeight;
-	int hIndex = 0, maxY = World.MaxY, index = 0;
-	int x, y, z;
-	struct OctaveNoise n;
+struct StrataArgs { struct OctaveNoise n; int minStoneY; };
+#define STRATA_SEGMENT 64
 
-	/* Try to bulk fill bottom of the map if possible */
-	minStoneY = NotchyGen_CreateStrataFast();
-	OctaveNoise_Init(&n, &rnd, 8);
+static void NotchyGen_StrataRows(void* arg, int zBeg, int zEnd) {
+	struct StrataArgs* args = (struct StrataArgs*)arg;
+	BlockRaw stoneBlock = Gen_GetTheme()->stoneBlock;
+	BlockRaw fillBlock  = Gen_GetTheme()->fillBlock;
+	int minStoneY = args->minStoneY, maxY = World.MaxY;
+	int stoneTop[STRATA_SEGMENT], fillBeg[STRATA_SEGMENT], fillTop[STRATA_SEGMENT];
+	int dirtThickness, dirtHeight, stoneHeight;
+	float xs[4], zs[4], thickness[4];
+	int i, j, x, y, z, count, yBeg, yEnd;
+	BlockRaw* row;
 
-	Gen_CurrentState = "Creating strata";
-	for (z = 0; z < World.Length; z++) {
-		Gen_CurrentProgress = (float)z / World.Length;
+	for (z = zBeg; z < zEnd; z++) {
+		for (i = 0; i < 4; i++) { zs[i] = (float)z; }
 
-		for (x = 0; x < World.Width; x++) {
-			dirtThickness = (int)(OctaveNoise_Calc(&n, (float)x, (float)z) / 24 - 4);
-			dirtHeight    = heightmap[hIndex++];
-			stoneHeight   = dirtHeight + dirtThickness;
+		/* Columns are filled a segment at a time, one Y layer at a time */
+		/* (much more cache friendly than filling each column from bottom to top) */
+		for (x = 0; x < World.Width; x += STRATA_SEGMENT) {
+			count = min(STRATA_SEGMENT, World.Width - x);
+			yBeg  = minStoneY; yEnd = 0;
 
-			stoneHeight = min(stoneHeight, maxY);
-			dirtHeight  = min(dirtHeight,  maxY);
+			for (i = 0; i < count; i += 4) {
+				for (j = 0; j < 4; j++) { xs[j] = (float)(x + i + j); }
+				OctaveNoise_Calc4(&args->n, xs, zs, thickness);
+
+				for (j = 0; j < 4 && i + j < count; j++) {
+					dirtThickness = (int)(thickness[j] / 24 - 4);
+					dirtHeight    = heightmap[z * World.Width + x + i + j];
+					stoneHeight   = dirtHeight + dirtThickness;
+
+					stoneHeight = min(stoneHeight, maxY);
+					dirtHeight  = min(dirtHeight,  maxY);
 
-			index = World_Pack(x, minStoneY, z);
-			for (y = minStoneY; y <= stoneHeight; y++) {
-				Gen_Blocks[index] = Gen_GetTheme()->stoneBlock; index += World.OneY;
+					stoneTop[i + j] = stoneHeight;
+					fillBeg[i + j]  = max(stoneHeight, 0) + 1;
+					fillTop[i + j]  = dirtHeight;
+
+					yBeg = min(yBeg, fillBeg[i + j]);
+					yEnd = max(yEnd, max(stoneHeight, dirtHeight));
+				}
 			}
 
-			stoneHeight = max(stoneHeight, 0);
-			index = World_Pack(x, (stoneHeight + 1), z);
-			for (y = stoneHeight + 1; y <= dirtHeight; y++) {
-				Gen_Blocks[index] = Gen_GetTheme()->fillBlock; index += World.OneY;
+			for (y = yBeg; y <= yEnd; y++) {
+				row = Gen_Blocks + World_Pack(x, y, z);
+
+				for (i = 0; i < count; i++) {
+					if (y >= minStoneY && y <= stoneTop[i]) {
+						row[i] = stoneBlock;
+					} else if (y >= fillBeg[i] && y <= fillTop[i]) {
+						row[i] = fillBlock;
+					}
+				}
 			}
 		}
+		Gen_RowCompleted();
 	}
 }
 
+static void NotchyGen_CreateStrata(void) {
+	struct StrataArgs args;
+
+	/* Try to bulk fill bottom of the map if possible */
+	args.minStoneY = NotchyGen_CreateStrataFast();
+	OctaveNoise_Init(&args.n, &rnd, 8);
+
+	Gen_CurrentState = "Creating strata";
+	Gen_ForEachRow(NotchyGen_StrataRows, &args);
+}
+
 static void NotchyGen_CarveCaves(void) {
 	int cavesCount, caveLen;
 	float caveX, caveY, caveZ;
@@ -680,12 +1025,13 @@ static void NotchyGen_CarveCaves(void) {
 			radius = (World.Height - cenY) / (float)World.Height;
 			radius = 1.2f + (radius * 3.5f + 1.0f) * caveRadius;
 			radius = radius * Math_SinF(j * MATH_PI / caveLen);
-			NotchyGen_FillOblateSpheroid(cenX, cenY, cenZ, radius, BLOCK_AIR);
+			NotchyGen_Carve(cenX, cenY, cenZ, radius, BLOCK_AIR);
 		}
 	}
+	NotchyGen_FinishCarving();
 }
 
-static void NotchyGen_CarveOreVeins(float abundance, const char* state, BlockRaw block) {
+static void NotchyGen_RecordOreVeins(float abundance, const char* state, BlockRaw block) {
 	int numVeins, veinLen;
 	float veinX, veinY, veinZ;
 	float theta, deltaTheta, phi, deltaPhi;
@@ -716,26 +1062,32 @@ static void NotchyGen_CarveOreVeins(float abundance, const char* state, BlockRaw
 			deltaPhi   = deltaPhi   * 0.9f + Random_Float(&rnd) - Random_Float(&rnd);
 
 			radius = abundance * Math_SinF(j * MATH_PI / veinLen) + 1.0f;
-			NotchyGen_FillOblateSpheroid((int)veinX, (int)veinY, (int)veinZ, radius, block);
+			NotchyGen_Carve((int)veinX, (int)veinY, (int)veinZ, radius, block);
 		}
 	}
 }
 
+static void NotchyGen_CarveOreVeins(float abundance, const char* state, BlockRaw block) {
+	NotchyGen_RecordOreVeins(abundance, state, block);
+	NotchyGen_FinishCarving();
+}
+
 static void NotchyGen_CarveAllOres(void) {
 	int i;
 	if (Gen_Theme == GEN_THEME_CUSTOM) {
 		for (i = 0; i < MAX_CUSTOM_ORES; i++) {
 			if (!Gen_CustomOres[i].enabled) continue;
-			NotchyGen_CarveOreVeins(Gen_CustomOres[i].abundance,
+			NotchyGen_RecordOreVeins(Gen_CustomOres[i].abundance,
 				"Carving custom ore", Gen_CustomOres[i].block);
 		}
 	} else {
-		NotchyGen_CarveOreVeins(0.9f, "Carving coal ore",    BLOCK_COAL_ORE);
-		NotchyGen_CarveOreVeins(0.7f, "Carving iron ore",    BLOCK_IRON_ORE);
-		NotchyGen_CarveOreVeins(0.5f, "Carving gold ore",    BLOCK_GOLD_ORE);
-		NotchyGen_CarveOreVeins(0.6f, "Carving red ore",     BLOCK_RED_ORE);
-		NotchyGen_CarveOreVeins(0.4f, "Carving diamond ore", BLOCK_DIAMOND_ORE);
+		NotchyGen_RecordOreVeins(0.9f, "Carving coal ore",    BLOCK_COAL_ORE);
+		NotchyGen_RecordOreVeins(0.7f, "Carving iron ore",    BLOCK_IRON_ORE);
+		NotchyGen_RecordOreVeins(0.5f, "Carving gold ore",    BLOCK_GOLD_ORE);
+		NotchyGen_RecordOreVeins(0.6f, "Carving red ore",     BLOCK_RED_ORE);
+		NotchyGen_RecordOreVeins(0.4f, "Carving diamond ore", BLOCK_DIAMOND_ORE);
 	}
+	NotchyGen_FinishCarving();
 }
 
 static void NotchyGen_FloodFillWaterBorders(void) {
@@ -1794,9 +2146,10 @@ static void CavesGen_CarveTunnels(void) {
 
 			radius = 1.2f + (0.5f + caveRadius * 2.0f);
 			radius = radius * Math_SinF(j * MATH_PI / caveLen);
-			NotchyGen_FillOblateSpheroid(cenX, cenY, cenZ, radius, BLOCK_AIR);
+			NotchyGen_Carve(cenX, cenY, cenZ, radius, BLOCK_AIR);
 		}
 	}
+	NotchyGen_FinishCarving();
 }
 
 static void CavesGen_CarveCaverns(void) {
@@ -34,6 +34,14 @@ void Gen_Start(STRING_REF const struct MapGenerator* gen, int seed,
 				int width, int height, int length);
 /* The currently active map generator (valid during and after generation) */
 extern const struct MapGenerator* gen_active;
+/* Runs a map generator to completion on the calling thread, for a map of the current world's dimensions */
+/* Returns false if a map is still being generated, or the generator couldn't be prepared */
+/* NOTE: Only intended for benchmarking, as unlike Gen_Start the world itself is not changed */
+cc_bool Gen_RunBlocking(const struct MapGenerator* gen, int seed, BlockRaw* blocks);
+/* Whether noise is calculated for several points at once using SIMD (if supported) */
+extern cc_bool Gen_NoiseSIMD;
+/* Whether generation stages are split across worker threads (when possible) */
+extern cc_bool Gen_Parallel;
 /* If Y >= 0, overrides the default spawn position after generation */
 extern Vec3 Gen_SpawnOverride;
 
@@ -27,12 +27,22 @@ struct IGameComponent;
 struct MenuOptionsScreen;
 extern struct IGameComponent Gfx_Component;
 
+#if CC_GFX_BACKEND == CC_GFX_BACKEND_SOFTGPU || CC_GFX_BACKEND == CC_GFX_BACKEND_GL2 || \
+	CC_GFX_BACKEND == CC_GFX_BACKEND_D3D11
+/* Whether the backend supports the compact VERTEX_FORMAT_CHUNK format for chunk meshes */
+#define CC_GFX_CHUNK_VERTICES
+#endif
+
 typedef enum VertexFormat_ {
 	VERTEX_FORMAT_COLOURED, VERTEX_FORMAT_TEXTURED
+#ifdef CC_GFX_CHUNK_VERTICES
+	, VERTEX_FORMAT_CHUNK
+#endif
 } VertexFormat;
 
 #define SIZEOF_VERTEX_COLOURED 16
 #define SIZEOF_VERTEX_TEXTURED 24
+#define SIZEOF_VERTEX_CHUNK    16
 
 #if defined CC_BUILD_PSP
 /* 3 floats for position (XYZ), 4 bytes for colour */
@@ -46,6 +56,28 @@ struct VertexColoured { float x, y, z; PackedCol Col; };
 struct VertexTextured { float x, y, z; PackedCol Col; float U, V; };
 #endif
 
+#ifdef CC_GFX_CHUNK_VERTICES
+/* Position is fixed point relative to the chunk origin (see Gfx_SetChunkOrigin) */
+#define CHUNK_VERTEX_POS_SCALE 256
+/* Texture coordinates are fixed point. U of a merged face repeats once per block (so goes up to 16), */
+/*  whereas V always stays within the 1D terrain atlas (0 to 1) and so can have more precision */
+#define CHUNK_VERTEX_U_SCALE   2048
+#define CHUNK_VERTEX_V_SCALE   32768
+/* 3 shorts for position (XYZ), 4 bytes for colour, 2 shorts for texture coordinates (UV) */
+struct VertexChunk { cc_int16 x, y, z, pad; PackedCol Col; cc_uint16 U, V; };
+
+/* Sets the world position that positions of VERTEX_FORMAT_CHUNK vertices are relative to */
+void Gfx_SetChunkOrigin(int x, int y, int z);
+#endif
+
+#if CC_GFX_BACKEND == CC_GFX_BACKEND_SOFTGPU
+/* Sets whether every flush of binned triangles is also drawn with the plain scanline rasteriser, */
+/*  with the resulting framebuffer compared to the output of the tiled rasteriser */
+void Gfx_SetRasterCompare(cc_bool enabled);
+/* Gets how many flushes were compared, how many of those differed, and the total differing pixels */
+void Gfx_GetRasterCompare(int* flushes, int* mismatches, int* pixels);
+#endif
+
 void Gfx_Create(void);
 void Gfx_Free(void);
 
@@ -322,6 +354,15 @@ CC_API void  Gfx_UnlockVb(GfxResourceID vb);
 /* Special case of Gfx_Create/LockVb for building chunks in Builder.c */
 GfxResourceID Gfx_CreateVb2(void* vertices, VertexFormat fmt, int count);
 #endif
+#if CC_GFX_BACKEND == CC_GFX_BACKEND_GL1  || CC_GFX_BACKEND == CC_GFX_BACKEND_GL2 || \
+	CC_GFX_BACKEND == CC_GFX_BACKEND_D3D9 || CC_GFX_BACKEND == CC_GFX_BACKEND_D3D11
+#define CC_GFX_VB_RANGES
+/* Acquires temp memory for changing count vertices starting at offset in a vertex buffer */
+/* NOTE: The vertex buffer must have previously been filled using Gfx_LockVb */
+void* Gfx_LockVbRange(GfxResourceID vb, VertexFormat fmt, int offset, int count);
+/* Submits the changed vertices of a vertex buffer */
+void  Gfx_UnlockVbRange(GfxResourceID vb);
+#endif
 #if CC_GFX_BACKEND == CC_GFX_BACKEND_GL2
 /* Special case Gfx_BindVb for use with Gfx_DrawIndexedTris_T2fC4b */
 void Gfx_BindVb_Textured(GfxResourceID vb);
@@ -380,6 +421,8 @@ CC_API void Gfx_DrawVb_IndexedTris_Range(int verticesCount, int startVertex, Dra
 CC_API void Gfx_DrawVb_IndexedTris(int verticesCount);
 /* Special case Gfx_DrawVb_IndexedTris_Range for map renderer */
 void Gfx_DrawIndexedTris_T2fC4b(int verticesCount, int startVertex);
+/* Calls Gfx_DrawIndexedTris_T2fC4b for each of the given ranges, using a single multi-draw if supported */
+void Gfx_DrawIndexedTris_T2fC4b_Multi(int count, const int* verticesCounts, const int* startVertices);
 
 
 /*########################################################################################################################*
@@ -438,6 +438,24 @@ void Gfx_UnlockVb(GfxResourceID vb) {
 	tmp = NULL;
 }
 
+static D3D11_BOX tmpRange;
+void* Gfx_LockVbRange(GfxResourceID vb, VertexFormat fmt, int offset, int count) {
+	tmpRange.left   = offset * strideSizes[fmt];
+	tmpRange.right  = tmpRange.left + count * strideSizes[fmt];
+	tmpRange.top    = 0; tmpRange.bottom = 1;
+	tmpRange.front  = 0; tmpRange.back   = 1;
+
+	tmp = Mem_TryAlloc(count, strideSizes[fmt]);
+	return tmp;
+}
+
+void Gfx_UnlockVbRange(GfxResourceID vb) {
+	ID3D11DeviceContext_UpdateSubresource(context, (ID3D11Resource*)vb, 0, 
+											&tmpRange, tmp, 0, 0);
+	Mem_Free(tmp);
+	tmp = NULL;
+}
+
 
 /*########################################################################################################################*
 *--------------------------------------------------Dynamic vertex buffers-------------------------------------------------*
@@ -545,6 +563,7 @@ void Gfx_CalcPerspectiveMatrix(struct Matrix* matrix, float fov, float aspect, f
 //########################################################################################################################
 // https://docs.microsoft.com/en-us/windows/win32/direct3d11/d3d10-graphics-programming-guide-input-assembler-stage
 static ID3D11InputLayout* input_textured;
+static ID3D11InputLayout* input_chunk;
 
 static void IA_CreateLayouts(void) {
 	ID3D11InputLayout* input = NULL;
@@ -561,10 +580,22 @@ static void IA_CreateLayouts(void) {
 	HRESULT hr = ID3D11Device_CreateInputLayout(device, T_layout, Array_Elems(T_layout), 
 												vs_textured, sizeof(vs_textured), &input);
 	input_textured = input;
+
+	// Chunk vertices are fixed point, and get converted back in the vertex shader (see struct VertexChunk)
+	static D3D11_INPUT_ELEMENT_DESC C_layout[] =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_SINT, 0,  0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "COLOR"   , 0, DXGI_FORMAT_R8G8B8A8_UNORM,    0,  8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_UINT,       0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	};
+	hr = ID3D11Device_CreateInputLayout(device, C_layout, Array_Elems(C_layout), 
+										vs_chunk, sizeof(vs_chunk), &input);
+	input_chunk = input;
 }
 
 static void IA_UpdateLayout(void) {
-	ID3D11DeviceContext_IASetInputLayout(context, input_textured);
+	ID3D11InputLayout* input = gfx_format == VERTEX_FORMAT_CHUNK ? input_chunk : input_textured;
+	ID3D11DeviceContext_IASetInputLayout(context, input);
 }
 
 static void IA_Init(void) {
@@ -574,6 +605,7 @@ static void IA_Init(void) {
 
 static void IA_Free(void) {
 	ID3D11InputLayout_Release(input_textured);
+	ID3D11InputLayout_Release(input_chunk);
 }
 
 void Gfx_BindIb(GfxResourceID ib) {
@@ -598,17 +630,19 @@ void Gfx_BindDynamicVb(GfxResourceID vb) {
 //--------------------------------------------------------Vertex shader---------------------------------------------------
 //########################################################################################################################
 // https://docs.microsoft.com/en-us/windows/win32/direct3d11/vertex-shader-stage
-static ID3D11VertexShader* vs_shaders[3];
+static ID3D11VertexShader* vs_shaders[4];
 static ID3D11Buffer* vs_cBuffer;
 
 static struct CC_ALIGNED(64) VSConstants {
 	struct Matrix mvp;
-	float texX, texY;
+	float texX, texY, _pad[2];
+	float chunkX, chunkY, chunkZ;
 } vs_constants;
 static const struct ShaderDesc vs_descs[] = {
 	{ vs_colored,         sizeof(vs_colored) },
 	{ vs_textured,        sizeof(vs_textured) },
 	{ vs_textured_offset, sizeof(vs_textured_offset) },
+	{ vs_chunk,           sizeof(vs_chunk) },
 };
 
 static void VS_CreateShaders(void) {
@@ -642,6 +676,7 @@ static void VS_CreateConstants(void) {
 
 static int VS_CalcShaderIndex(void) {
 	if (gfx_format == VERTEX_FORMAT_COLOURED) return 0;
+	if (gfx_format == VERTEX_FORMAT_CHUNK)    return 3;
 
 	cc_bool has_offset = vs_constants.texX != 0 || vs_constants.texY != 0;
 	return has_offset ? 2 : 1;
@@ -707,6 +742,14 @@ void Gfx_DisableTextureOffset(void) {
 	VS_UpdateShader();
 }
 
+void Gfx_SetChunkOrigin(int x, int y, int z) {
+	if (x == vs_constants.chunkX && y == vs_constants.chunkY && z == vs_constants.chunkZ) return;
+	vs_constants.chunkX = (float)x;
+	vs_constants.chunkY = (float)y;
+	vs_constants.chunkZ = (float)z;
+	VS_UpdateConstants();
+}
+
 
 //########################################################################################################################
 //---------------------------------------------------------Rasteriser-----------------------------------------------------
@@ -654,6 +654,18 @@ void Gfx_UnlockVb(GfxResourceID vb) {
 	if (res) Process_Abort2(res, "Gfx_UnlockVb");
 }
 
+void* Gfx_LockVbRange(GfxResourceID vb, VertexFormat fmt, int offset, int count) {
+	IDirect3DVertexBuffer9* buffer = (IDirect3DVertexBuffer9*)vb;
+	void* dst = NULL;
+	int stride = strideSizes[fmt];
+
+	cc_result res = IDirect3DVertexBuffer9_Lock(buffer, offset * stride, count * stride, &dst, 0);
+	if (res) Process_Abort2(res, "Gfx_LockVbRange");
+	return dst;
+}
+
+void Gfx_UnlockVbRange(GfxResourceID vb) { Gfx_UnlockVb(vb); }
+
 
 /*########################################################################################################################*
 *--------------------------------------------------Dynamic vertex buffers-------------------------------------------------*
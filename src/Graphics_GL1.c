@@ -179,6 +179,17 @@ static cc_bool UnlockVb(GfxResourceID vb) {
 #endif
 }
 
+static cc_uint32 vbRangeOffset;
+void* Gfx_LockVbRange(GfxResourceID vb, VertexFormat fmt, int offset, int count) {
+	vbRangeOffset = offset * strideSizes[fmt];
+	return FastAllocTempMem(count * strideSizes[fmt]);
+}
+
+void Gfx_UnlockVbRange(GfxResourceID vb) {
+	_glBindBuffer(GL_ARRAY_BUFFER, vb);
+	_glBufferSubData(GL_ARRAY_BUFFER, vbRangeOffset, tmpSize, tmpData);
+}
+
 
 /*########################################################################################################################*
 *--------------------------------------------------Dynamic vertex buffers-------------------------------------------------*
@@ -522,7 +533,7 @@ static void APIENTRY legacy_bufferData(GLenum target, cc_uintptr size, const GLv
 
 static void APIENTRY legacy_bufferSubData(GLenum target, cc_uintptr offset, cc_uintptr size, const GLvoid* data) {
 	legacy_buffer* buffer = *legacy_GetBuffer(target);
-	Mem_Copy(buffer->data, data, size);
+	Mem_Copy((cc_uint8*)buffer->data + offset, data, size);
 }
 
 
@@ -4,6 +4,9 @@
 
 #include "Core.h"
 #if CC_GFX_BACKEND == CC_GFX_BACKEND_GL2
+#ifndef CC_BUILD_GLES
+#define CC_GFX_NATIVE_MULTIDRAW
+#endif
 #include "_GraphicsBase.h"
 #include "Errors.h"
 #include "Window.h"
@@ -127,6 +130,17 @@ static cc_bool UnlockVb(GfxResourceID vb) {
 #endif
 }
 
+static cc_uint32 vbRangeOffset;
+void* Gfx_LockVbRange(GfxResourceID vb, VertexFormat fmt, int offset, int count) {
+	vbRangeOffset = offset * strideSizes[fmt];
+	return FastAllocTempMem(count * strideSizes[fmt]);
+}
+
+void Gfx_UnlockVbRange(GfxResourceID vb) {
+	glBindBuffer(GL_ARRAY_BUFFER, ptr_to_uint(vb));
+	glBufferSubData(GL_ARRAY_BUFFER, vbRangeOffset, tmpSize, tmpData);
+}
+
 
 /*########################################################################################################################*
 *--------------------------------------------------Dynamic vertex buffers-------------------------------------------------*
@@ -174,6 +188,7 @@ void Gfx_SetDynamicVbData(GfxResourceID vb, void* vertices, int vCount) {
 #define FTR_LINEAR_FOG (1 << 3)
 #define FTR_DENSIT_FOG (1 << 4)
 #define FTR_HASANY_FOG (FTR_LINEAR_FOG | FTR_DENSIT_FOG)
+#define FTR_CHUNK_VERT (1 << 5)
 #define FTR_FS_MEDIUMP (1 << 7)
 
 #define UNI_MVP_MATRIX (1 << 0)
@@ -181,7 +196,8 @@ void Gfx_SetDynamicVbData(GfxResourceID vb, void* vertices, int vCount) {
 #define UNI_FOG_COL    (1 << 2)
 #define UNI_FOG_END    (1 << 3)
 #define UNI_FOG_DENS   (1 << 4)
-#define UNI_MASK_ALL   0x1F
+#define UNI_CHUNK_POS  (1 << 5)
+#define UNI_MASK_ALL   0x3F
 
 /* cached uniforms (cached for multiple programs */
 static struct Matrix _view, _proj, _mvp;
@@ -190,14 +206,15 @@ static float _texX, _texY;
 static PackedCol gfx_fogColor;
 static float gfx_fogEnd = -1.0f, gfx_fogDensity = -1.0f;
 static int gfx_fogMode = -1;
+static int chunkX, chunkY, chunkZ;
 
 /* shader programs (emulate fixed function) */
 static struct GLShader {
 	int features;     /* what features are enabled for this shader */
 	int uniforms;     /* which associated uniforms need to be resent to GPU */
 	GLuint program;   /* OpenGL program ID (0 if not yet compiled) */
-	int locations[5]; /* location of uniforms (not constant) */
-} shaders[6 * 3] = {
+	int locations[6]; /* location of uniforms (not constant) */
+} shaders[6 * 3 + 2 * 3] = {
 	/* no fog */
 	{ 0              },
 	{ 0              | FTR_ALPHA_TEST },
@@ -219,6 +236,13 @@ static struct GLShader {
 	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_ALPHA_TEST },
 	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_TEX_OFFSET },
 	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_TEX_OFFSET | FTR_ALPHA_TEST },
+	/* chunk vertices */
+	{ 0              | FTR_TEXTURE_UV | FTR_CHUNK_VERT },
+	{ 0              | FTR_TEXTURE_UV | FTR_CHUNK_VERT | FTR_ALPHA_TEST },
+	{ FTR_LINEAR_FOG | FTR_TEXTURE_UV | FTR_CHUNK_VERT },
+	{ FTR_LINEAR_FOG | FTR_TEXTURE_UV | FTR_CHUNK_VERT | FTR_ALPHA_TEST },
+	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_CHUNK_VERT },
+	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_CHUNK_VERT | FTR_ALPHA_TEST },
 };
 static struct GLShader* gfx_activeShader;
 
@@ -226,6 +250,7 @@ static struct GLShader* gfx_activeShader;
 static void GenVertexShader(const struct GLShader* shader, cc_string* dst) {
 	int uv = shader->features & FTR_TEXTURE_UV;
 	int tm = shader->features & FTR_TEX_OFFSET;
+	int ch = shader->features & FTR_CHUNK_VERT;
 
 	String_AppendConst(dst,         "attribute vec3 in_pos;\n");
 	String_AppendConst(dst,         "attribute vec4 in_col;\n");
@@ -234,11 +259,15 @@ static void GenVertexShader(const struct GLShader* shader, cc_string* dst) {
 	if (uv) String_AppendConst(dst, "varying vec2 out_uv;\n");
 	String_AppendConst(dst,         "uniform mat4 mvp;\n");
 	if (tm) String_AppendConst(dst, "uniform vec2 texOffset;\n");
+	if (ch) String_AppendConst(dst, "uniform vec3 chunkOrigin;\n");
 
+	/* Chunk vertices are fixed point (see CHUNK_VERTEX_POS_SCALE etc in Graphics.h) */
 	String_AppendConst(dst,         "void main() {\n");
-	String_AppendConst(dst,         "  gl_Position = mvp * vec4(in_pos, 1.0);\n");
+	if (ch) String_AppendConst(dst, "  gl_Position = mvp * vec4(in_pos * (1.0 / 256.0) + chunkOrigin, 1.0);\n");
+	else    String_AppendConst(dst, "  gl_Position = mvp * vec4(in_pos, 1.0);\n");
 	String_AppendConst(dst,         "  out_col = in_col;\n");
-	if (uv) String_AppendConst(dst, "  out_uv  = in_uv;\n");
+	if (ch) String_AppendConst(dst, "  out_uv  = in_uv * vec2(1.0 / 2048.0, 1.0 / 32768.0);\n");
+	else if (uv) String_AppendConst(dst, "  out_uv  = in_uv;\n");
 	if (tm) String_AppendConst(dst, "  out_uv  = out_uv + texOffset;\n");
 	String_AppendConst(dst,         "}");
 }
@@ -374,6 +403,7 @@ static void CompileProgram(struct GLShader* shader) {
 		shader->locations[2] = glGetUniformLocation(program, "fogCol");
 		shader->locations[3] = glGetUniformLocation(program, "fogEnd");
 		shader->locations[4] = glGetUniformLocation(program, "fogDensity");
+		shader->locations[5] = glGetUniformLocation(program, "chunkOrigin");
 		return;
 	}
 	temp = 0;
@@ -423,6 +453,10 @@ static void ReloadUniforms(void) {
 		glUniform1f(s->locations[4], -gfx_fogDensity);
 		s->uniforms &= ~UNI_FOG_DENS;
 	}
+	if ((s->uniforms & UNI_CHUNK_POS) && (s->features & FTR_CHUNK_VERT)) {
+		glUniform3f(s->locations[5], (float)chunkX, (float)chunkY, (float)chunkZ);
+		s->uniforms &= ~UNI_CHUNK_POS;
+	}
 }
 
 /* Switches program to one that duplicates current fixed function state */
@@ -436,9 +470,14 @@ static void SwitchProgram(void) {
 		if (gfx_fogMode >= 1) index += 6; /* exp fog */
 	}
 
-	if (gfx_format == VERTEX_FORMAT_TEXTURED) index += 2;
-	if (gfx_texTransform) index += 2;
-	if (gfx_alphaTest)    index += 1;
+	if (gfx_format == VERTEX_FORMAT_CHUNK) {
+		/* Chunk shaders come last, and only have alpha test variants */
+		index = 6 * 3 + index / 3;
+	} else {
+		if (gfx_format == VERTEX_FORMAT_TEXTURED) index += 2;
+		if (gfx_texTransform) index += 2;
+	}
+	if (gfx_alphaTest) index += 1;
 
 	shader = &shaders[index];
 	if (shader == gfx_activeShader) { ReloadUniforms(); return; }
@@ -533,11 +572,30 @@ void Gfx_DisableTextureOffset(void) {
 	SwitchProgram();
 }
 
+void Gfx_SetChunkOrigin(int x, int y, int z) {
+	if (x == chunkX && y == chunkY && z == chunkZ) return;
+	chunkX = x; chunkY = y; chunkZ = z;
+	DirtyUniform(UNI_CHUNK_POS);
+	ReloadUniforms();
+}
+
 
 /*########################################################################################################################*
 *-------------------------------------------------------State setup-------------------------------------------------------*
 *#########################################################################################################################*/
+#ifdef CC_GFX_NATIVE_MULTIDRAW
+/* Core since OpenGL 1.4, so always available with OpenGL 2.0 */
+static void (APIENTRY *_glMultiDrawElements)(GLenum mode, const GLsizei* count, GLenum type, 
+											const void* const* indices, GLsizei drawcount);
+#endif
+
 static void GLBackend_Init(void) {
+#ifdef CC_GFX_NATIVE_MULTIDRAW
+	static const struct DynamicLibSym multiDrawFuncs[] = {
+		DynamicLib_OptSym(glMultiDrawElements)
+	};
+	GLContext_GetAll(multiDrawFuncs, Array_Elems(multiDrawFuncs));
+#endif
 #ifdef CC_BUILD_GLES
 	// OpenGL ES 2.0 doesn't support custom mipmaps levels, but 3.2 does
 	// Note that GL_MAJOR_VERSION and GL_MINOR_VERSION were not actually
@@ -667,30 +725,47 @@ typedef void (*GL_SetupVBRangeFunc)(int startVertex);
 static GL_SetupVBFunc gfx_setupVBFunc;
 static GL_SetupVBRangeFunc gfx_setupVBRangeFunc;
 
+/* Vertex that textured/chunk vertex attributes currently start from (-1 if coloured) */
+static int textured_base;
+
 static void GL_SetupVbColoured(void) {
 	glVertexAttribPointer(0, 3, GL_FLOAT,         false, SIZEOF_VERTEX_COLOURED, uint_to_ptr( 0));
 	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, true,  SIZEOF_VERTEX_COLOURED, uint_to_ptr(12));
+	textured_base = -1;
 }
 
 static void GL_SetupVbTextured(void) {
 	glVertexAttribPointer(0, 3, GL_FLOAT,         false, SIZEOF_VERTEX_TEXTURED, uint_to_ptr( 0));
 	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, true,  SIZEOF_VERTEX_TEXTURED, uint_to_ptr(12));
 	glVertexAttribPointer(2, 2, GL_FLOAT,         false, SIZEOF_VERTEX_TEXTURED, uint_to_ptr(16));
+	textured_base = 0;
 }
 
 static void GL_SetupVbColoured_Range(int startVertex) {
 	cc_uint32 offset = startVertex * SIZEOF_VERTEX_COLOURED;
 	glVertexAttribPointer(0, 3, GL_FLOAT,         false, SIZEOF_VERTEX_COLOURED, uint_to_ptr(offset     ));
 	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, true,  SIZEOF_VERTEX_COLOURED, uint_to_ptr(offset + 12));
+	textured_base = -1;
 }
 
 static void GL_SetupVbTextured_Range(int startVertex) {
 	cc_uint32 offset = startVertex * SIZEOF_VERTEX_TEXTURED;
+	textured_base    = startVertex;
 	glVertexAttribPointer(0, 3, GL_FLOAT,         false, SIZEOF_VERTEX_TEXTURED, uint_to_ptr(offset     ));
 	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, true,  SIZEOF_VERTEX_TEXTURED, uint_to_ptr(offset + 12));
 	glVertexAttribPointer(2, 2, GL_FLOAT,         false, SIZEOF_VERTEX_TEXTURED, uint_to_ptr(offset + 16));
 }
 
+static void GL_SetupVbChunk_Range(int startVertex) {
+	cc_uint32 offset = startVertex * SIZEOF_VERTEX_CHUNK;
+	textured_base    = startVertex;
+	glVertexAttribPointer(0, 3, GL_SHORT,          false, SIZEOF_VERTEX_CHUNK, uint_to_ptr(offset     ));
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE,  true,  SIZEOF_VERTEX_CHUNK, uint_to_ptr(offset +  8));
+	glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, false, SIZEOF_VERTEX_CHUNK, uint_to_ptr(offset + 12));
+}
+
+static void GL_SetupVbChunk(void) { GL_SetupVbChunk_Range(0); }
+
 void Gfx_SetVertexFormat(VertexFormat fmt) {
 	if (fmt == gfx_format) return;
 	gfx_format = fmt;
@@ -700,6 +775,10 @@ void Gfx_SetVertexFormat(VertexFormat fmt) {
 		glEnableVertexAttribArray(2);
 		gfx_setupVBFunc      = GL_SetupVbTextured;
 		gfx_setupVBRangeFunc = GL_SetupVbTextured_Range;
+	} else if (fmt == VERTEX_FORMAT_CHUNK) {
+		glEnableVertexAttribArray(2);
+		gfx_setupVBFunc      = GL_SetupVbChunk;
+		gfx_setupVBRangeFunc = GL_SetupVbChunk_Range;
 	} else {
 		glDisableVertexAttribArray(2);
 		gfx_setupVBFunc      = GL_SetupVbColoured;
@@ -725,17 +804,61 @@ void Gfx_DrawVb_IndexedTris(int verticesCount) {
 
 void Gfx_BindVb_Textured(GfxResourceID vb) {
 	Gfx_BindVb(vb);
-	GL_SetupVbTextured();
+	gfx_setupVBFunc();
+}
+
+/* Whether the vertices can be reached by 16 bit indices from where textured vertex attributes start */
+static cc_bool GL_InTexturedRange(int verticesCount, int startVertex) {
+	return textured_base >= 0 && startVertex >= textured_base && 
+			startVertex + verticesCount <= textured_base + GFX_MAX_VERTICES;
 }
 
 void Gfx_DrawIndexedTris_T2fC4b(int verticesCount, int startVertex) {
-	if (startVertex + verticesCount > GFX_MAX_VERTICES) {
-		GL_SetupVbTextured_Range(startVertex);
-		glDrawElements(GL_TRIANGLES, ICOUNT(verticesCount), GL_UNSIGNED_SHORT, NULL);
-		GL_SetupVbTextured();
-	} else {
-		/* ICOUNT(startVertex) * 2 = startVertex * 3  */
-		glDrawElements(GL_TRIANGLES, ICOUNT(verticesCount), GL_UNSIGNED_SHORT, uint_to_ptr(startVertex * 3));
+	/* Vertex attributes only need to be moved when vertices are outside the range reachable by 16 bit indices */
+	/*  (which happens often for chunks in the shared chunk vertex buffers) */
+	if (!GL_InTexturedRange(verticesCount, startVertex)) gfx_setupVBRangeFunc(startVertex);
+
+	/* ICOUNT(startVertex) * 2 = startVertex * 3  */
+	startVertex -= textured_base;
+	glDrawElements(GL_TRIANGLES, ICOUNT(verticesCount), GL_UNSIGNED_SHORT, uint_to_ptr(startVertex * 3));
+}
+
+#ifdef CC_GFX_NATIVE_MULTIDRAW
+#define MAX_MULTIDRAW 64
+static void GL_MultiDraw(GLsizei* counts, const void** offsets, int count) {
+	if (count == 1) {
+		glDrawElements(GL_TRIANGLES, counts[0], GL_UNSIGNED_SHORT, offsets[0]);
+	} else if (count) {
+		_glMultiDrawElements(GL_TRIANGLES, counts, GL_UNSIGNED_SHORT, offsets, count);
 	}
+	if (count) Game_DrawCalls++;
 }
+
+void Gfx_DrawIndexedTris_T2fC4b_Multi(int count, const int* verticesCounts, const int* startVertices) {
+	GLsizei counts[MAX_MULTIDRAW];
+	const void* offsets[MAX_MULTIDRAW];
+	int i, n = 0, start;
+
+	if (!_glMultiDrawElements) {
+		for (i = 0; i < count; i++) Gfx_DrawIndexedTris_T2fC4b(verticesCounts[i], startVertices[i]);
+		Game_DrawCalls += count;
+		return;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		start = startVertices[i];
+		/* All ranges in one multi-draw must use the same vertex attributes */
+		if (n == MAX_MULTIDRAW || !GL_InTexturedRange(verticesCounts[i], start)) {
+			GL_MultiDraw(counts, offsets, n); n = 0;
+		}
+		if (!GL_InTexturedRange(verticesCounts[i], start)) gfx_setupVBRangeFunc(start);
+
+		counts[n]  = ICOUNT(verticesCounts[i]);
+		offsets[n] = uint_to_ptr((start - textured_base) * 3);
+		n++;
+	}
+	GL_MultiDraw(counts, offsets, n);
+}
+#endif
 #endif
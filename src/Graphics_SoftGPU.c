@@ -4,6 +4,7 @@
 #include "_GraphicsBase.h"
 #include "Errors.h"
 #include "Window.h"
+#include "Utils.h"
 
 static cc_bool faceCulling;
 static int fb_width, fb_height; 
@@ -24,6 +25,12 @@ static int db_stride;
 static void* gfx_vertices;
 static GfxResourceID white_square;
 
+static void InitBins(void);
+static void FreeBins(void);
+static void ResizeBins(void);
+static void FlushBins(void);
+static void FreeCompareBuffers(void);
+
 static void Gfx_RestoreState(void) {
 	InitDefaultResources();
 
@@ -46,10 +53,14 @@ void Gfx_Create(void) {
 	Gfx.BackendType  = CC_GFX_BACKEND_SOFTGPU;
 	Gfx.Limitations  = GFX_LIMIT_MINIMAL;
 	
+	InitBins();
 	Gfx_RestoreState();
 }
 
 static void DestroyBuffers(void) {
+	FlushBins();
+	FreeBins();
+	FreeCompareBuffers();
 	Window_FreeFramebuffer(&fb_bmp);
 	Mem_Free(depthBuffer);
 	depthBuffer = NULL;
@@ -92,7 +103,10 @@ void Gfx_BindTexture(GfxResourceID texId) {
 		
 void Gfx_DeleteTexture(GfxResourceID* texId) {
 	GfxResourceID data = *texId;
-	if (data) Mem_Free(data);
+	if (!data) return;
+
+	FlushBins();
+	Mem_Free(data);
 	*texId = NULL;
 }
 		
@@ -111,6 +125,7 @@ GfxResourceID Gfx_AllocTexture(struct Bitmap* bmp, int rowWidth, cc_uint8 flags,
 void Gfx_UpdateTexture(GfxResourceID texId, int x, int y, struct Bitmap* part, int rowWidth, cc_bool mipmaps) {
 	CCTexture* tex = (CCTexture*)texId;
 	BitmapCol* dst = (tex->pixels + x) + y * tex->width;
+	FlushBins();
 
 	CopyPixels(dst,         tex->width * BITMAPCOLOR_SIZE,
 			   part->scan0, rowWidth   * BITMAPCOLOR_SIZE,
@@ -166,6 +181,7 @@ static void ClearDepthBuffer(void) {
 }
 
 void Gfx_ClearBuffers(GfxBuffers buffers) {
+	FlushBins();
 	if (buffers & GFX_BUFFER_COLOR) ClearColorBuffer();
 	if (buffers & GFX_BUFFER_DEPTH) ClearDepthBuffer();
 }
@@ -232,12 +248,34 @@ void Gfx_UnlockVb(GfxResourceID vb) { }
 *#########################################################################################################################*/
 static float texOffsetX, texOffsetY;
 static struct Matrix _view, _proj, _mvp;
+// MVP matrix with the chunk origin and fixed point scale of chunk vertices folded in
+static struct Matrix _chunkMvp;
+static int chunkX, chunkY, chunkZ;
+
+static void UpdateChunkMVP(void) {
+	const float* src = (const float*)&_mvp;
+	float* dst = (float*)&_chunkMvp;
+	float scale = 1.0f / CHUNK_VERTEX_POS_SCALE;
+
+	for (int i = 0; i < 12; i++) dst[i] = src[i] * scale;
+	for (int i = 0; i < 4;  i++) 
+	{
+		dst[12 + i] = chunkX * src[i] + chunkY * src[4 + i] + chunkZ * src[8 + i] + src[12 + i];
+	}
+}
+
+void Gfx_SetChunkOrigin(int x, int y, int z) {
+	if (x == chunkX && y == chunkY && z == chunkZ) return;
+	chunkX = x; chunkY = y; chunkZ = z;
+	UpdateChunkMVP();
+}
 
 void Gfx_LoadMatrix(MatrixType type, const struct Matrix* matrix) {
 	if (type == MATRIX_VIEW) _view = *matrix;
 	if (type == MATRIX_PROJ) _proj = *matrix;
 
 	Matrix_Mul(&_mvp, &_view, &_proj);
+	UpdateChunkMVP();
 }
 
 void Gfx_LoadMVP(const struct Matrix* view, const struct Matrix* proj, struct Matrix* mvp) {
@@ -246,6 +284,7 @@ void Gfx_LoadMVP(const struct Matrix* view, const struct Matrix* proj, struct Ma
 
 	Matrix_Mul(mvp, view, proj);
 	_mvp  = *mvp;
+	UpdateChunkMVP();
 }
 
 void Gfx_EnableTextureOffset(float x, float y) {
@@ -322,10 +361,26 @@ static void TransformVertex2D(int index, Vertex* vertex) {
 	}
 }
 
+static int TransformChunkVertex(const struct VertexChunk* v, Vertex* vertex) {
+	const struct Matrix* m = &_chunkMvp;
+	float x = v->x, y = v->y, z = v->z;
+
+	vertex->x = x * m->row1.x + y * m->row2.x + z * m->row3.x + m->row4.x;
+	vertex->y = x * m->row1.y + y * m->row2.y + z * m->row3.y + m->row4.y;
+	vertex->z = x * m->row1.z + y * m->row2.z + z * m->row3.z + m->row4.z;
+	vertex->w = x * m->row1.w + y * m->row2.w + z * m->row3.w + m->row4.w;
+
+	vertex->u = v->U * (1.0f / CHUNK_VERTEX_U_SCALE) + texOffsetX;
+	vertex->v = v->V * (1.0f / CHUNK_VERTEX_V_SCALE) + texOffsetY;
+	vertex->c = v->Col;
+	return vertex->z >= 0.0f;
+}
+
 static int TransformVertex3D(int index, Vertex* vertex) {
 	// TODO: avoid the multiply, just add down in DrawTriangles
 	char* ptr = (char*)gfx_vertices + index * gfx_stride;
 	Vector3* pos = (Vector3*)ptr;
+	if (gfx_format == VERTEX_FORMAT_CHUNK) return TransformChunkVertex((struct VertexChunk*)ptr, vertex);
 
 	vertex->x = pos->x * _mvp.row1.x + pos->y * _mvp.row2.x + pos->z * _mvp.row3.x + _mvp.row4.x;
 	vertex->y = pos->x * _mvp.row1.y + pos->y * _mvp.row2.y + pos->z * _mvp.row3.y + _mvp.row4.y;
@@ -552,41 +607,101 @@ static void DrawTriangle2D(Vertex* V0, Vertex* V1, Vertex* V2) {
 	b2 = BitmapCol_B(tColor); \
 	B  = ( b1 * b2 ) >> 8;    \
 
-static void DrawTriangle3D(Vertex* V0, Vertex* V1, Vertex* V2) {
+struct RasterState {
+	BitmapCol* texPixels;
+	int texWidth, texHeight;
+	int texWidthMask, texHeightMask;
+	int texSinglePixel;
+	cc_bool textured, alphaTest, alphaBlend;
+	cc_bool depthTest, depthWrite, colWrite;
+};
+
+static void GetRasterState(struct RasterState* s) {
+	s->texPixels     = curTexPixels;
+	s->texWidth      = curTexWidth;
+	s->texHeight     = curTexHeight;
+	s->texWidthMask  = texWidthMask;
+	s->texHeightMask = texHeightMask;
+	s->texSinglePixel = texSinglePixel;
+
+	s->textured   = gfx_format != VERTEX_FORMAT_COLOURED;
+	s->alphaTest  = gfx_alphaTest;
+	s->alphaBlend = gfx_alphaBlend;
+	s->depthTest  = depthTest;
+	s->depthWrite = depthWrite;
+	s->colWrite   = colWrite;
+}
+
+// Edge function values are always multiples of 0.5, which floats can represent exactly up to 2^23
+// When the values across the whole triangle are small enough, the result of incrementally stepping
+//  from one pixel to the next is exactly the same as directly calculating the value at any pixel
+#define EDGE_EXACT_LIMIT (1 << 22)
+static float EdgeBound(int ax, int ay, int bx, int by, int minX, int minY, int maxX, int maxY) {
+	float ex = max(Math_AbsF(minX + 0.5f - ax), Math_AbsF(maxX + 0.5f - ax));
+	float ey = max(Math_AbsF(minY + 0.5f - ay), Math_AbsF(maxY + 0.5f - ay));
+	return Math_AbsF((float)(bx - ax)) * ey + Math_AbsF((float)(by - ay)) * ex;
+}
+
+static cc_bool EdgesExact(int x0, int y0, int x1, int y1, int x2, int y2, int minX, int minY, int maxX, int maxY) {
+	return EdgeBound(x1,y1, x2,y2, minX,minY,maxX,maxY) < EDGE_EXACT_LIMIT &&
+		   EdgeBound(x2,y2, x0,y0, minX,minY,maxX,maxY) < EDGE_EXACT_LIMIT &&
+		   EdgeBound(x0,y0, x1,y1, minX,minY,maxX,maxY) < EDGE_EXACT_LIMIT;
+}
+
+// Checks 4 pixels at once, so that runs of pixels outside the triangle can be skipped quickly
+// Only the signs of the products matter, so this gives the same result as the scalar checks
+#if defined __SSE__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define RASTER_SIMD
+static CC_INLINE cc_bool AnyCovered4(float bc0, float bc1, float bc2, int dx0, int dx1, int dx2, float factor) {
+	__m128 steps = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	__m128 f     = _mm_set1_ps(factor);
+	__m128 zero  = _mm_setzero_ps();
+
+	__m128 ic0 = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(bc0), _mm_mul_ps(steps, _mm_set1_ps((float)dx0))), f);
+	__m128 ic1 = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(bc1), _mm_mul_ps(steps, _mm_set1_ps((float)dx1))), f);
+	__m128 ic2 = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(bc2), _mm_mul_ps(steps, _mm_set1_ps((float)dx2))), f);
+
+	__m128 outside = _mm_or_ps(_mm_cmplt_ps(ic0, zero), _mm_or_ps(_mm_cmplt_ps(ic1, zero), _mm_cmplt_ps(ic2, zero)));
+	return _mm_movemask_ps(outside) != 0x0F;
+}
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define RASTER_SIMD
+static CC_INLINE cc_bool AnyCovered4(float bc0, float bc1, float bc2, int dx0, int dx1, int dx2, float factor) {
+	static const float stepsData[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+	float32x4_t steps = vld1q_f32(stepsData);
+	float32x4_t zero  = vdupq_n_f32(0.0f);
+
+	float32x4_t ic0 = vmulq_n_f32(vaddq_f32(vdupq_n_f32(bc0), vmulq_n_f32(steps, (float)dx0)), factor);
+	float32x4_t ic1 = vmulq_n_f32(vaddq_f32(vdupq_n_f32(bc1), vmulq_n_f32(steps, (float)dx1)), factor);
+	float32x4_t ic2 = vmulq_n_f32(vaddq_f32(vdupq_n_f32(bc2), vmulq_n_f32(steps, (float)dx2)), factor);
+
+	uint32x4_t outside = vorrq_u32(vcltq_f32(ic0, zero), vorrq_u32(vcltq_f32(ic1, zero), vcltq_f32(ic2, zero)));
+	uint32x2_t both    = vand_u32(vget_low_u32(outside), vget_high_u32(outside));
+	return !(vget_lane_u32(both, 0) & vget_lane_u32(both, 1));
+}
+#endif
+
+// Rasterises the part of the triangle within the given bounds
+// exact indicates whether edge function values can be calculated directly (see EdgesExact)
+static void RasterTriangle3D(const Vertex* V0, const Vertex* V1, const Vertex* V2, const struct RasterState* s,
+							int minX, int minY, int maxX, int maxY, cc_bool exact) {
 	int x0 = (int)V0->x, y0 = (int)V0->y;
 	int x1 = (int)V1->x, y1 = (int)V1->y;
 	int x2 = (int)V2->x, y2 = (int)V2->y;
-	int minX = min(x0, min(x1, x2));
-	int minY = min(y0, min(y1, y2));
-	int maxX = max(x0, max(x1, x2));
-	int maxY = max(y0, max(y1, y2));
-
 	int area = edgeFunction(x0,y0, x1,y1, x2,y2);
-	if (faceCulling) {
-		// https://gamedev.stackexchange.com/questions/203694/how-to-make-backface-culling-work-correctly-in-both-orthographic-and-perspective
-		if (area < 0) return;
-	}
-
-	// Reject triangles completely outside
-	if (maxX < 0 || minX > fb_maxX) return;
-	if (maxY < 0 || minY > fb_maxY) return;
-
-	// Perform scissoring
-	minX = max(minX, 0); maxX = min(maxX, fb_maxX);
-	minY = max(minY, 0); maxY = min(maxY, fb_maxY);
 
 	// NOTE: W in frag variables below is actually 1/W 
 	float factor = 1.0f / area;
 	float w0 = V0->w, w1 = V1->w, w2 = V2->w;
-	
-	// TODO proper clipping
-	if (w0 <= 0 || w1 <= 0 || w2 <= 0) {
-		return;
-	}
-
 	float z0 = V0->z, z1 = V1->z, z2 = V2->z;
 	PackedCol color = V0->c;
 
+	int curTexWidth  = s->texWidth,     curTexHeight  = s->texHeight;
+	int texWidthMask = s->texWidthMask, texHeightMask = s->texHeightMask;
+	BitmapCol* curTexPixels = s->texPixels;
+
 	float u0 = V0->u * curTexWidth,  u1 = V1->u * curTexWidth,  u2 = V2->u * curTexWidth;
 	float v0 = V0->v * curTexHeight, v1 = V1->v * curTexHeight, v2 = V2->v * curTexHeight;
 	
@@ -603,14 +718,14 @@ static void DrawTriangle3D(Vertex* V0, Vertex* V1, Vertex* V2) {
 	int R, G, B, A, x, y;
 	int a1, r1, g1, b1;
 	int a2, r2, g2, b2;
-	cc_bool texturing = gfx_format == VERTEX_FORMAT_TEXTURED;
+	cc_bool texturing = s->textured;
 
 	if (!texturing) {
 		R = PackedCol_R(color);
 		G = PackedCol_G(color);
 		B = PackedCol_B(color);
 		A = PackedCol_A(color);
-	} else if (texSinglePixel) {
+	} else if (s->texSinglePixel) {
 		/* Don't need to calculate complicated texturing in this case */
 		float rawY0 = v0 / w0;
 		float rawY1 = v1 / w1;
@@ -629,6 +744,13 @@ static void DrawTriangle3D(Vertex* V0, Vertex* V1, Vertex* V2) {
 
 		for (x = minX; x <= maxX; x++, bc0 += dx12, bc1 += dx20, bc2 += dx01) 
 		{
+#ifdef RASTER_SIMD
+			if (exact && !((x - minX) & 3) && x + 3 <= maxX && !AnyCovered4(bc0, bc1, bc2, dx12, dx20, dx01, factor)) {
+				// Skip over next 3 pixels too (loop increments past 4th pixel)
+				x += 3; bc0 += dx12 * 3; bc1 += dx20 * 3; bc2 += dx01 * 3;
+				continue;
+			}
+#endif
 			float ic0 = bc0 * factor;
 			float ic1 = bc1 * factor;
 			float ic2 = bc2 * factor;
@@ -638,9 +760,9 @@ static void DrawTriangle3D(Vertex* V0, Vertex* V1, Vertex* V2) {
 			float w = 1 / (ic0 * w0 + ic1 * w1 + ic2 * w2);
 			float z = (ic0 * z0 + ic1 * z1 + ic2 * z2) * w;
 
-			if (depthTest && (z < 0 || z > depthBuffer[db_index])) continue;
-			if (!colWrite) {
-				if (depthWrite) depthBuffer[db_index] = z;
+			if (s->depthTest && (z < 0 || z > depthBuffer[db_index])) continue;
+			if (!s->colWrite) {
+				if (s->depthWrite) depthBuffer[db_index] = z;
 				continue;
 			}
 
@@ -656,11 +778,11 @@ static void DrawTriangle3D(Vertex* V0, Vertex* V1, Vertex* V2) {
 				MultiplyColors(color, tColor);
 			}
 
-			if (gfx_alphaTest && A < 0x80) continue;
-			if (depthWrite) depthBuffer[db_index] = z;
+			if (s->alphaTest && A < 0x80) continue;
+			if (s->depthWrite) depthBuffer[db_index] = z;
 			int cb_index = y * cb_stride + x;
 			
-			if (!gfx_alphaBlend) {
+			if (!s->alphaBlend) {
 				colorBuffer[cb_index] = BitmapCol_Make(R, G, B, 0xFF);
 				continue;
 			}
@@ -678,6 +800,239 @@ static void DrawTriangle3D(Vertex* V0, Vertex* V1, Vertex* V2) {
 	}
 }
 
+
+/*########################################################################################################################*
+*-----------------------------------------------------Binned rendering----------------------------------------------------*
+*#########################################################################################################################*/
+// When worker threads are available, 3D triangles are not drawn immediately, but instead
+//  are binned into each 64x64 screen tile they overlap. When the bins are flushed, each tile
+//  draws the part of its triangles within the tile, in the same order they were submitted.
+// Since no two threads ever touch the same pixel, and each pixel sees the same sequence
+//  of triangles, the output is identical to drawing triangles immediately.
+#define BIN_TILE_SHIFT 6
+#define BIN_TILE_SIZE  (1 << BIN_TILE_SHIFT)
+#define BIN_MAX_TRIS   (1024 * 32)
+
+struct BinnedTri { Vertex v[3]; int minX, minY, maxX, maxY, state; };
+struct TileBin   { int* tris; int count, capacity; };
+
+static cc_bool binning, bin_compare;
+static struct BinnedTri* bin_tris;
+static int bin_numTris;
+static struct RasterState* bin_states;
+static int bin_numStates, bin_statesCapacity;
+static struct TileBin* bin_tiles;
+static int bin_tilesX, bin_tilesY;
+
+static void InitBins(void) {
+	binning = Jobs_WorkerCount() > 0 || bin_compare;
+	if (!binning) return;
+
+	if (!bin_tris) bin_tris = (struct BinnedTri*)Mem_TryAlloc(BIN_MAX_TRIS, sizeof(struct BinnedTri));
+	if (!bin_tris) binning = false;
+}
+
+static void FreeBins(void) {
+	int i;
+	bin_numTris   = 0;
+	bin_numStates = 0;
+
+	for (i = 0; i < bin_tilesX * bin_tilesY; i++) Mem_Free(bin_tiles[i].tris);
+
+	Mem_Free(bin_tiles);
+	bin_tiles  = NULL;
+	bin_tilesX = 0; bin_tilesY = 0;
+}
+
+static void ResizeBins(void) {
+	FreeBins();
+	if (!binning) return;
+
+	bin_tilesX = (fb_width  + BIN_TILE_SIZE - 1) >> BIN_TILE_SHIFT;
+	bin_tilesY = (fb_height + BIN_TILE_SIZE - 1) >> BIN_TILE_SHIFT;
+	bin_tiles  = (struct TileBin*)Mem_AllocCleared(bin_tilesX * bin_tilesY, sizeof(struct TileBin), "tile bins");
+}
+
+static void RasterTiles(void* arg, int beg, int end) {
+	int tile, i, minX, minY, maxX, maxY;
+	struct BinnedTri* t;
+	struct TileBin* bin;
+
+	for (tile = beg; tile < end; tile++)
+	{
+		bin  = &bin_tiles[tile];
+		minX = (tile % bin_tilesX) << BIN_TILE_SHIFT;
+		minY = (tile / bin_tilesX) << BIN_TILE_SHIFT;
+		maxX = minX + BIN_TILE_SIZE - 1;
+		maxY = minY + BIN_TILE_SIZE - 1;
+
+		for (i = 0; i < bin->count; i++)
+		{
+			t = &bin_tris[bin->tris[i]];
+			RasterTriangle3D(&t->v[0], &t->v[1], &t->v[2], &bin_states[t->state],
+							max(t->minX, minX), max(t->minY, minY), 
+							min(t->maxX, maxX), min(t->maxY, maxY), true);
+		}
+		bin->count = 0;
+	}
+}
+
+// When comparing, each flush also draws the binned triangles one by one over the whole of their
+//  bounds (i.e. the old scanline path, without the SIMD skipping) into a copy of the framebuffer
+static BitmapCol* cmp_colors;
+static float* cmp_depth;
+static int cmp_flushes, cmp_mismatches, cmp_pixels;
+
+static void FreeCompareBuffers(void) {
+	Mem_Free(cmp_colors); cmp_colors = NULL;
+	Mem_Free(cmp_depth);  cmp_depth  = NULL;
+}
+
+static void RasterScanline(void) {
+	BitmapCol* colors = colorBuffer;
+	float* depth      = depthBuffer;
+	struct BinnedTri* t;
+	int i;
+
+	if (!cmp_colors) cmp_colors = (BitmapCol*)Mem_TryAlloc(fb_height * cb_stride, 4);
+	if (!cmp_depth)  cmp_depth  = (float*)Mem_TryAlloc(fb_height * db_stride, 4);
+	if (!cmp_colors || !cmp_depth) { FreeCompareBuffers(); return; }
+
+	Mem_Copy(cmp_colors, colorBuffer, fb_height * cb_stride * 4);
+	Mem_Copy(cmp_depth,  depthBuffer, fb_height * db_stride * 4);
+	colorBuffer = cmp_colors;
+	depthBuffer = cmp_depth;
+
+	for (i = 0; i < bin_numTris; i++)
+	{
+		t = &bin_tris[i];
+		RasterTriangle3D(&t->v[0], &t->v[1], &t->v[2], &bin_states[t->state],
+						t->minX, t->minY, t->maxX, t->maxY, false);
+	}
+	colorBuffer = colors;
+	depthBuffer = depth;
+}
+
+static void CompareBins(void) {
+	// Depth is compared bitwise, since degenerate triangles can write NaN depth values
+	cc_uint32* depthA = (cc_uint32*)depthBuffer;
+	cc_uint32* depthB = (cc_uint32*)cmp_depth;
+	int x, y, diff = 0;
+	if (!cmp_colors) return;
+
+	for (y = 0; y < fb_height; y++)
+		for (x = 0; x < fb_width; x++)
+	{
+		if (colorBuffer[y * cb_stride + x] != cmp_colors[y * cb_stride + x] ||
+			depthA[y * db_stride + x] != depthB[y * db_stride + x]) diff++;
+	}
+
+	cmp_flushes++;
+	cmp_pixels += diff;
+	if (diff) cmp_mismatches++;
+}
+
+static void FlushBins(void) {
+	if (!bin_numTris) return;
+	if (bin_compare) RasterScanline();
+	Jobs_ParallelFor(bin_tilesX * bin_tilesY, 1, RasterTiles, NULL);
+	if (bin_compare) CompareBins();
+
+	bin_numTris   = 0;
+	bin_numStates = 0;
+}
+
+void Gfx_SetRasterCompare(cc_bool enabled) {
+	FlushBins();
+	bin_compare = enabled;
+	cmp_flushes = 0; cmp_mismatches = 0; cmp_pixels = 0;
+	if (!enabled) FreeCompareBuffers();
+
+	InitBins();
+	ResizeBins();
+}
+
+void Gfx_GetRasterCompare(int* flushes, int* mismatches, int* pixels) {
+	*flushes    = cmp_flushes;
+	*mismatches = cmp_mismatches;
+	*pixels     = cmp_pixels;
+}
+
+static void BinTriangle(Vertex* V0, Vertex* V1, Vertex* V2, int minX, int minY, int maxX, int maxY) {
+	struct BinnedTri* t;
+	struct RasterState state;
+	struct TileBin* bin;
+	int tx, ty;
+
+	Mem_Set(&state, 0, sizeof(state));
+	GetRasterState(&state);
+	if (!bin_numStates || Mem_Equal(&state, &bin_states[bin_numStates - 1], sizeof(state)) == false) {
+		if (bin_numStates == bin_statesCapacity) {
+			Utils_Resize((void**)&bin_states, &bin_statesCapacity, sizeof(struct RasterState), 0, 64);
+		}
+		bin_states[bin_numStates++] = state;
+	}
+
+	t = &bin_tris[bin_numTris];
+	t->v[0] = *V0; t->v[1] = *V1; t->v[2] = *V2;
+	t->minX = minX; t->minY = minY; t->maxX = maxX; t->maxY = maxY;
+	t->state = bin_numStates - 1;
+
+	for (ty = minY >> BIN_TILE_SHIFT; ty <= maxY >> BIN_TILE_SHIFT; ty++)
+		for (tx = minX >> BIN_TILE_SHIFT; tx <= maxX >> BIN_TILE_SHIFT; tx++)
+	{
+		bin = &bin_tiles[ty * bin_tilesX + tx];
+		if (bin->count == bin->capacity) {
+			Utils_Resize((void**)&bin->tris, &bin->capacity, sizeof(int), 0, 256);
+		}
+		bin->tris[bin->count++] = bin_numTris;
+	}
+
+	if (++bin_numTris == BIN_MAX_TRIS) FlushBins();
+}
+
+static void DrawTriangle3D(Vertex* V0, Vertex* V1, Vertex* V2) {
+	int x0 = (int)V0->x, y0 = (int)V0->y;
+	int x1 = (int)V1->x, y1 = (int)V1->y;
+	int x2 = (int)V2->x, y2 = (int)V2->y;
+	int minX = min(x0, min(x1, x2));
+	int minY = min(y0, min(y1, y2));
+	int maxX = max(x0, max(x1, x2));
+	int maxY = max(y0, max(y1, y2));
+
+	int area = edgeFunction(x0,y0, x1,y1, x2,y2);
+	if (faceCulling) {
+		// https://gamedev.stackexchange.com/questions/203694/how-to-make-backface-culling-work-correctly-in-both-orthographic-and-perspective
+		if (area < 0) return;
+	}
+
+	// Reject triangles completely outside
+	if (maxX < 0 || minX > fb_maxX) return;
+	if (maxY < 0 || minY > fb_maxY) return;
+
+	// Perform scissoring
+	minX = max(minX, 0); maxX = min(maxX, fb_maxX);
+	minY = max(minY, 0); maxY = min(maxY, fb_maxY);
+
+	// TODO proper clipping
+	if (V0->w <= 0 || V1->w <= 0 || V2->w <= 0) {
+		return;
+	}
+
+	cc_bool exact = EdgesExact(x0,y0, x1,y1, x2,y2, minX,minY,maxX,maxY);
+	// NOTE: Scissor rectangle could be set larger than the framebuffer
+	if (binning && exact && bin_tiles && maxX < fb_width && maxY < fb_height) {
+		BinTriangle(V0, V1, V2, minX, minY, maxX, maxY);
+		return;
+	}
+
+	// Triangle needs to be drawn with the exact same incremental stepping as before
+	struct RasterState state;
+	GetRasterState(&state);
+	FlushBins();
+	RasterTriangle3D(V0, V1, V2, &state, minX, minY, maxX, maxY, exact);
+}
+
 #define V0_VIS (1 << 0)
 #define V1_VIS (1 << 1)
 #define V2_VIS (1 << 2)
@@ -945,7 +1300,11 @@ void DrawQuads(int startVertex, int verticesCount, DrawHints hints) {
 	Vertex vertices[4];
 	int i, j = startVertex;
 
-	if (gfx_rendering2D && (hints & (DRAW_HINT_SPRITE|DRAW_HINT_RECT))) {
+	// 2D drawing doesn't go through bins, so must be drawn after all pending 3D triangles
+	if (gfx_rendering2D) FlushBins();
+
+	// Sprite fast path always samples the bound texture, so can't be used for coloured quads
+	if (gfx_rendering2D && (hints & (DRAW_HINT_SPRITE|DRAW_HINT_RECT)) && gfx_format == VERTEX_FORMAT_TEXTURED) {
 		// 4 vertices = 1 quad = 2 triangles
 		for (i = 0; i < verticesCount / 4; i++, j += 4)
 		{
@@ -1025,6 +1384,7 @@ static BitmapCol* CB_GetRow(struct Bitmap* bmp, int y, void* ctx) {
 cc_result Gfx_TakeScreenshot(struct Stream* output) {
 	struct Bitmap bmp;
 	Bitmap_Init(bmp, fb_width, fb_height, NULL);
+	FlushBins();
 	return Png_Encode(&bmp, output, CB_GetRow, false, NULL);
 }
 
@@ -1035,6 +1395,7 @@ void Gfx_BeginFrame(void) { }
 
 void Gfx_EndFrame(void) {
 	Rect2D r = { 0, 0, fb_width, fb_height };
+	FlushBins();
 	Window_DrawFramebuffer(r, &fb_bmp);
 }
 
@@ -1054,6 +1415,7 @@ void Gfx_OnWindowResize(void) {
 
 	depthBuffer = Mem_Alloc(fb_width * fb_height, 4, "depth buffer");
 	db_stride   = fb_width;
+	ResizeBins();
 
 	Gfx_SetViewport(0, 0, Game.Width, Game.Height);
 	Gfx_SetScissor (0, 0, Game.Width, Game.Height);
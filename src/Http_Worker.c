@@ -273,41 +273,85 @@ static struct ConnectionPoolEntry {
 	cc_string addr;
 	char addrBuffer[STRING_SIZE];
 	cc_bool https;
+	cc_bool inUse;      /* Whether a worker is currently using this connection */
+	cc_uint64 lastUsed; /* When this connection last finished a request */
 } connection_pool[10];
+/* Workers share the pool, so entries can only be claimed/released while holding this */
+static void* poolMutex;
 
-static cc_result ConnectionPool_Insert(int i, struct HttpConnection** conn, const struct HttpUrl* url) {
+static void ConnectionPool_Insert(int i, struct HttpConnection** conn, const struct HttpUrl* url) {
 	struct ConnectionPoolEntry* e = &connection_pool[i];
 	*conn = &e->conn;
 
 	String_InitArray(e->addr, e->addrBuffer);
 	String_Copy(&e->addr, &url->address);
 	e->https = url->https;
-	return HttpConnection_Open(&e->conn, url);
+	e->inUse = true;
 }
 
-static cc_result ConnectionPool_Open(struct HttpConnection** conn, const struct HttpUrl* url) {
+static cc_result ConnectionPool_Claim(struct HttpConnection** conn, const struct HttpUrl* url, cc_bool* reused) {
 	struct ConnectionPoolEntry* e;
-	int i;
+	int i, lru = -1;
 
+	/* Reuse an idle kept-alive connection to the same host */
 	for (i = 0; i < Array_Elems(connection_pool); i++)
 	{
 		e = &connection_pool[i];
-		if (e->conn.valid && e->https == url->https && String_Equals(&e->addr, &url->address)) {
-			*conn = &connection_pool[i].conn;
-			return 0;
-		}
+		if (e->inUse || !e->conn.valid) continue;
+		if (e->https != url->https || !String_Equals(&e->addr, &url->address)) continue;
+
+		*conn    = &e->conn;
+		*reused  = true;
+		e->inUse = true;
+		return 0;
 	}
 
 	for (i = 0; i < Array_Elems(connection_pool); i++)
 	{
 		e = &connection_pool[i];
-		if (!e->conn.valid) return ConnectionPool_Insert(i, conn, url);
+		if (e->inUse || e->conn.valid) continue;
+
+		ConnectionPool_Insert(i, conn, url);
+		return 0;
 	}
 
-	/* TODO: Should we be consistent in which entry gets evicted? */
-	i = (cc_uint8)Stopwatch_Measure() % Array_Elems(connection_pool);
-	HttpConnection_Close(&connection_pool[i].conn);
-	return ConnectionPool_Insert(i, conn, url);
+	/* Evict the idle connection that has been unused the longest */
+	for (i = 0; i < Array_Elems(connection_pool); i++)
+	{
+		e = &connection_pool[i];
+		if (e->inUse) continue;
+		if (lru == -1 || e->lastUsed < connection_pool[lru].lastUsed) lru = i;
+	}
+
+	/* Can't happen unless there are more workers than pool entries */
+	if (lru == -1) return ERR_NOT_SUPPORTED;
+	HttpConnection_Close(&connection_pool[lru].conn);
+	ConnectionPool_Insert(lru, conn, url);
+	return 0;
+}
+
+static cc_result ConnectionPool_Open(struct HttpConnection** conn, const struct HttpUrl* url) {
+	cc_bool reused = false;
+	cc_result res;
+
+	Mutex_Lock(poolMutex);
+	res = ConnectionPool_Claim(conn, url, &reused);
+	Mutex_Unlock(poolMutex);
+
+	/* Connecting can be slow, so do it without blocking other workers */
+	if (res || reused) return res;
+	return HttpConnection_Open(*conn, url);
+}
+
+/* Returns a claimed connection to the pool, keeping it open for reuse unless keepAlive is false */
+static void ConnectionPool_Release(struct HttpConnection* conn, cc_bool keepAlive) {
+	struct ConnectionPoolEntry* e = (struct ConnectionPoolEntry*)conn;
+	if (!keepAlive) HttpConnection_Close(conn);
+
+	Mutex_Lock(poolMutex);
+	e->inUse    = false;
+	e->lastUsed = Stopwatch_Measure();
+	Mutex_Unlock(poolMutex);
 }
 
 
@@ -342,7 +386,7 @@ struct HttpClientState {
 	struct HttpRequest* req;
 	cc_uint32 dataLeft; /* Number of bytes still to read from the current chunk or body */
 	cc_bool chunked;    /* Whether content is being transferred using HTTP chunks */
-	cc_bool autoClose;  /* TODO Whether connection should be dropped after request completed */
+	cc_bool autoClose;  /* Whether connection should be dropped after request completed */
 	cc_bool retried;    /* Whether request has been retried due to SSL context being closed/dropped */
 	cc_uint8 redirects; /* Number of times current HTTP request has been redirected */
 	cc_string header;   /* Current header being parsed */
@@ -668,16 +712,14 @@ static void Http_AddHeader(struct HttpRequest* req, const char* key, const cc_st
 
 static cc_result HttpBackend_PerformRequest(struct HttpClientState* state) {
 	cc_result res;
+	state->conn = NULL;
 
 	res = ConnectionPool_Open(&state->conn, &state->url);
-	if (res) { HttpConnection_Close(state->conn); return res; }
-
-	res = HttpClient_SendRequest(state);
-	if (res) { HttpConnection_Close(state->conn); return res; }
-
-	res = HttpClient_ParseResponse(state);
-	if (res) HttpConnection_Close(state->conn);
+	if (!res) res = HttpClient_SendRequest(state);
+	if (!res) res = HttpClient_ParseResponse(state);
 
+	/* Keep connection open for later requests to the same host, unless server said otherwise */
+	if (state->conn) ConnectionPool_Release(state->conn, !res && !state->autoClose);
 	return res;
 }
 static const char* verbs[] = { "GET", "HEAD", "POST" };
@@ -727,15 +769,28 @@ static cc_bool HttpBackend_DescribeError(cc_result res, cc_string* dst) {
 #endif
 
 
-static void* workerWaitable;
-static void* workerThread;
+#if defined CC_BUILD_LOWMEM || defined CC_BUILD_COOPTHREADED
+#define HTTP_WORKER_COUNT 1
+#else
+/* Worker 0 only handles priority requests (e.g. texture packs), so they never wait behind skins */
+#define HTTP_WORKER_COUNT 4
+#endif
+/* Maximum number of requests to the same host at once (per RFC 7230 section 6.4 guidance) */
+#define HTTP_MAX_HOST_REQUESTS 2
+
+static void* workerWaitables[HTTP_WORKER_COUNT];
+static void* workerThreads[HTTP_WORKER_COUNT];
+static int workersStarted;
 
 static void* pendingMutex;
 static struct RequestList pendingReqs;
+static struct RequestList priorityReqs;
+/* Address of the host each worker is currently downloading from */
+static cc_string workerHosts[HTTP_WORKER_COUNT];
+static char workerHostBuffers[HTTP_WORKER_COUNT][STRING_SIZE + 8];
 
 static void* curRequestMutex;
-static struct HttpRequest http_curRequest;
-
+static struct HttpRequest http_curRequests[HTTP_WORKER_COUNT];
 
 /*########################################################################################################################*
 *----------------------------------------------------Http public api------------------------------------------------------*
@@ -753,20 +808,37 @@ cc_bool Http_GetResult(int reqID, struct HttpRequest* item) {
 }
 
 cc_bool Http_GetCurrent(int* reqID, int* progress) {
+	int i;
+	*reqID    = 0;
+	*progress = HTTP_PROGRESS_NOT_WORKING_ON;
+
 	Mutex_Lock(curRequestMutex);
 	{
-		*reqID    = http_curRequest.id;
-		*progress = http_curRequest.progress;
+		/* Report the oldest request still being worked on */
+		for (i = 0; i < HTTP_WORKER_COUNT; i++)
+		{
+			if (!http_curRequests[i].id) continue;
+			if (*reqID && http_curRequests[i].id > *reqID) continue;
+
+			*reqID    = http_curRequests[i].id;
+			*progress = http_curRequests[i].progress;
+		}
 	}
 	Mutex_Unlock(curRequestMutex);
 	return *reqID != 0;
 }
 
 int Http_CheckProgress(int reqID) {
-	int curReqID, progress;
-	Http_GetCurrent(&curReqID, &progress);
+	int i, progress = HTTP_PROGRESS_NOT_WORKING_ON;
 
-	if (reqID != curReqID) progress = HTTP_PROGRESS_NOT_WORKING_ON;
+	Mutex_Lock(curRequestMutex);
+	{
+		for (i = 0; i < HTTP_WORKER_COUNT; i++)
+		{
+			if (http_curRequests[i].id == reqID) progress = http_curRequests[i].progress;
+		}
+	}
+	Mutex_Unlock(curRequestMutex);
 	return progress;
 }
 
@@ -774,6 +846,7 @@ void Http_ClearPending(void) {
 	Mutex_Lock(pendingMutex);
 	{
 		RequestList_Free(&pendingReqs);
+		RequestList_Free(&priorityReqs);
 	}
 	Mutex_Unlock(pendingMutex);
 }
@@ -781,7 +854,8 @@ void Http_ClearPending(void) {
 void Http_TryCancel(int reqID) {
 	Mutex_Lock(pendingMutex);
 	{
-		RequestList_TryFree(&pendingReqs, reqID);
+		RequestList_TryFree(&pendingReqs,  reqID);
+		RequestList_TryFree(&priorityReqs, reqID);
 	}
 	Mutex_Unlock(pendingMutex);
 
@@ -797,11 +871,11 @@ void Http_TryCancel(int reqID) {
 *-----------------------------------------------------Http worker---------------------------------------------------------*
 *#########################################################################################################################*/
 /* Sets up state to begin a http request */
-static void SetCurrentRequest(struct HttpRequest* req) {
+static void SetCurrentRequest(int worker, struct HttpRequest* req) {
 	Mutex_Lock(curRequestMutex);
 	{
-		HttpRequest_Copy(&http_curRequest, req);
-		http_curRequest.progress = HTTP_PROGRESS_MAKING_REQUEST;
+		HttpRequest_Copy(&http_curRequests[worker], req);
+		http_curRequests[worker].progress = HTTP_PROGRESS_MAKING_REQUEST;
 	}
 	Mutex_Unlock(curRequestMutex);
 }
@@ -821,60 +895,116 @@ static void PerformRequest(struct HttpRequest* req) {
 	Http_FinishRequest(req);
 }
 
-static void ClearCurrentRequest(void) {
+static void ClearCurrentRequest(int worker) {
 	Mutex_Lock(curRequestMutex);
 	{
-		http_curRequest.id       = 0;
-		http_curRequest.progress = HTTP_PROGRESS_NOT_WORKING_ON;
+		http_curRequests[worker].id       = 0;
+		http_curRequests[worker].progress = HTTP_PROGRESS_NOT_WORKING_ON;
 	}
 	Mutex_Unlock(curRequestMutex);
 }
 
-static void DoRequest(struct HttpRequest* request) {
-	SetCurrentRequest(request);
-	PerformRequest(&http_curRequest);
-	ClearCurrentRequest();
+static void DoRequest(int worker, struct HttpRequest* request) {
+	SetCurrentRequest(worker, request);
+	PerformRequest(&http_curRequests[worker]);
+	ClearCurrentRequest(worker);
+}
+
+static void WakeWorkers(void) {
+	int i;
+	for (i = 0; i < workersStarted; i++) { Waitable_Signal(workerWaitables[i]); }
+}
+
+static void GetRequestHost(struct HttpRequest* req, cc_string* host) {
+	struct HttpUrl url;
+	cc_string str = String_FromRawArray(req->url);
+
+	HttpUrl_Parse(&str, &url);
+	String_Copy(host, &url.address);
+}
+
+/* Removes the first request from the list whose host isn't already at HTTP_MAX_HOST_REQUESTS */
+/* NOTE: Must be called while holding pendingMutex */
+static cc_bool TakePendingRequest(int worker, struct RequestList* list, struct HttpRequest* request) {
+	cc_string host; char hostBuffer[STRING_SIZE + 8];
+	int i, j, active;
+
+	for (i = 0; i < list->count; i++)
+	{
+		String_InitArray(host, hostBuffer);
+		GetRequestHost(&list->entries[i], &host);
+		active = 0;
+
+		for (j = 0; j < HTTP_WORKER_COUNT; j++)
+		{
+			if (String_Equals(&workerHosts[j], &host)) active++;
+		}
+		if (active >= HTTP_MAX_HOST_REQUESTS) continue;
+
+		String_Copy(&workerHosts[worker], &host);
+		HttpRequest_Copy(request, &list->entries[i]);
+		RequestList_RemoveAt(list, i);
+		return true;
+	}
+	return false;
 }
 
 static void WorkerLoop(void) {
 	struct HttpRequest request;
 	cc_bool hasRequest;
+	int worker;
 
-	for (;;) {
-		hasRequest = false;
+	Mutex_Lock(pendingMutex);
+	{
+		worker = workersStarted++;
+	}
+	Mutex_Unlock(pendingMutex);
 
+	for (;;) {
 		Mutex_Lock(pendingMutex);
 		{
-			if (pendingReqs.count) {
-				HttpRequest_Copy(&request, &pendingReqs.entries[0]);
-				hasRequest = true;
-				RequestList_RemoveAt(&pendingReqs, 0);
+			hasRequest = TakePendingRequest(worker, &priorityReqs, &request);
+			/* Priority worker is left free for priority requests */
+			if (!hasRequest && (worker || HTTP_WORKER_COUNT == 1)) {
+				hasRequest = TakePendingRequest(worker, &pendingReqs, &request);
 			}
 		}
 		Mutex_Unlock(pendingMutex);
 
 		if (hasRequest) {
-			DoRequest(&request);
+			DoRequest(worker, &request);
+
+			Mutex_Lock(pendingMutex);
+			{
+				workerHosts[worker].length = 0;
+			}
+			Mutex_Unlock(pendingMutex);
+			/* Requests to this host may have been waiting on the per host limit */
+			WakeWorkers();
 		} else {
 			/* Block until another thread submits a request to do */
 			Platform_LogConst("Download queue empty, going back to sleep...");
-			Waitable_Wait(workerWaitable);
+			Waitable_Wait(workerWaitables[worker]);
 		}
 	}
 }
 
-/* Adds a req to the list of pending requests, waking up worker thread if needed */
+/* Adds a req to the list of pending requests, waking up worker threads if needed */
 static void HttpBackend_Add(struct HttpRequest* req, cc_uint8 flags) {
 #if defined CC_BUILD_PSP || defined CC_BUILD_NDS
 	/* TODO why doesn't threading work properly on PSP */
-	DoRequest(req);
+	DoRequest(0, req);
 #else
 	Mutex_Lock(pendingMutex);
 	{
-		RequestList_Append(&pendingReqs, req, flags);
+		if (flags & HTTP_FLAG_PRIORITY) {
+			RequestList_Append(&priorityReqs, req, flags);
+		} else {
+			RequestList_Append(&pendingReqs,  req, flags);
+		}
 	}
 	Mutex_Unlock(pendingMutex);
-	Waitable_Signal(workerWaitable);
+	WakeWorkers();
 #endif
 }
 
@@ -882,20 +1012,33 @@ static void HttpBackend_Add(struct HttpRequest* req, cc_uint8 flags) {
 *-----------------------------------------------------Http component------------------------------------------------------*
 *#########################################################################################################################*/
 static void Http_Init(void) {
+	int i;
 	Http_InitCommon();
-	http_curRequest.progress = HTTP_PROGRESS_NOT_WORKING_ON;
+	for (i = 0; i < HTTP_WORKER_COUNT; i++) 
+	{
+		http_curRequests[i].progress = HTTP_PROGRESS_NOT_WORKING_ON;
+	}
 	/* Http component gets initialised multiple times on Android */
-	if (workerThread) return;
+	if (workerThreads[0]) return;
 
 	HttpBackend_Init();
 	RequestList_Init(&pendingReqs);
+	RequestList_Init(&priorityReqs);
 	RequestList_Init(&processedReqs);
 
-	workerWaitable  = Waitable_Create("HTTP wakeup");
 	pendingMutex    = Mutex_Create("HTTP pending");
 	processedMutex  = Mutex_Create("HTTP processed");
 	curRequestMutex = Mutex_Create("HTTP current");
-	
-	Thread_Run(&workerThread, WorkerLoop, 128 * 1024, "HTTP");
+	poolMutex       = Mutex_Create("HTTP connections");
+
+	for (i = 0; i < HTTP_WORKER_COUNT; i++)
+	{
+		String_InitArray(workerHosts[i], workerHostBuffers[i]);
+		workerWaitables[i] = Waitable_Create("HTTP wakeup");
+	}
+	for (i = 0; i < HTTP_WORKER_COUNT; i++)
+	{
+		Thread_Run(&workerThreads[i], WorkerLoop, 128 * 1024, "HTTP");
+	}
 }
 #endif
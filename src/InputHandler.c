@@ -1573,7 +1573,8 @@ static cc_bool mob_vtable_inited;
 #define MOB_AGGRO_RANGE_SQ   (16.0f * 16.0f)  /* 16 blocks */
 #define MOB_DEAGGRO_RANGE_SQ (24.0f * 24.0f)  /* 24 blocks - always deaggro */
 #define MOB_DEAGGRO_LOS_RANGE_SQ (10.0f * 10.0f)  /* 10 blocks - deaggro if no line of sight */
-#define MOB_SPACING_DIST_SQ  (2.0f * 2.0f)    /* hostile mobs stay 2 blocks apart */
+#define MOB_SPACING_DIST     2.0f             /* hostile mobs stay 2 blocks apart */
+#define MOB_SPACING_DIST_SQ  (MOB_SPACING_DIST * MOB_SPACING_DIST)
 
 static cc_uint8 mobType[MAX_NET_PLAYERS];
 static Vec3     mobWanderTarget[MAX_NET_PLAYERS];
@@ -1700,6 +1701,7 @@ static void DropItem_Spawn(int slot, Vec3 pos, BlockID block, cc_bool isItem, in
 	/* Initialize NetPlayer entity */
 	np = &NetPlayers_List[eid];
 	NetPlayer_Init(np);
+	np->Base.Flags |= ENTITY_FLAG_TICK_LOD;
 	Entities.List[eid] = &np->Base;
 	Event_RaiseInt(&EntityEvents.Added, eid);
 
@@ -1971,10 +1973,7 @@ static void DroppedItem_TickAll(struct ScheduledTask* task) {
 }
 
 static cc_bool Mob_BlockIsSolid(int x, int y, int z) {
-	BlockID b;
-	if (!World_Contains(x, y, z)) return false;
-	b = World_GetBlock(x, y, z);
-	return Blocks.Collide[b] == COLLIDE_SOLID;
+	return World_Contains(x, y, z) && World_IsSolid(x, y, z);
 }
 
 /* Check if a block would obstruct a mob at the given entity Y position (considering partial block heights) */
@@ -1982,8 +1981,8 @@ static cc_bool Mob_BlockObstructsAt(int x, int blockY, int z, float entityY) {
 	BlockID b;
 	float blockTop;
 	if (!World_Contains(x, blockY, z)) return false;
+	if (!World_IsSolid(x, blockY, z))   return false;
 	b = World_GetBlock(x, blockY, z);
-	if (Blocks.Collide[b] != COLLIDE_SOLID) return false;
 	
 	/* Get the actual top height of this block */
 	blockTop = (float)blockY + Blocks.MaxBB[b].y;
@@ -1994,10 +1993,7 @@ static cc_bool Mob_BlockObstructsAt(int x, int blockY, int z, float entityY) {
 }
 
 static cc_bool Mob_BlockIsPassable(int x, int y, int z) {
-	BlockID b;
-	if (!World_Contains(x, y, z)) return true;
-	b = World_GetBlock(x, y, z);
-	return Blocks.Collide[b] != COLLIDE_SOLID;
+	return !World_Contains(x, y, z) || !World_IsSolid(x, y, z);
 }
 
 /* Checks line-of-sight between two positions (no solid blocks in the way) */
@@ -2278,9 +2274,10 @@ static void Mob_ApplyGravity(struct Entity* e, float delta, int id) {
 	bz = (int)Math_Floor(e->Position.z);
 
 	if (World_Contains(bx, by, bz)) {
-		below = World_GetBlock(bx, by, bz);
-		if (Blocks.Collide[below] == COLLIDE_SOLID) {
-			float blockTop = (float)by + Blocks.MaxBB[below].y;
+		if (World_IsSolid(bx, by, bz)) {
+			float blockTop;
+			below    = World_GetBlock(bx, by, bz);
+			blockTop = (float)by + Blocks.MaxBB[below].y;
 			if (e->Velocity.y <= 0.0f && e->Position.y <= blockTop + 0.05f) {
 				/* Falling/stationary and at or near block surface: land on it */
 				e->Velocity.y = 0.0f;
@@ -2533,11 +2530,16 @@ static void Arrow_TickAll(float delta) {
 
 		/* Check collision with mobs (player arrows only) */
 		if (arrowIsPlayerArrow[slot]) {
-			int mi;
+			cc_uint16 nearby[ENTITIES_MAX_COUNT];
+			int mi, k, nearbyCount;
 			cc_bool hitMob = false;
-			for (mi = 0; mi < MAX_NET_PLAYERS; mi++) {
-				struct Entity* me = Entities.List[mi];
-				if (!me || !Mob_IsMob(mi)) continue;
+
+			nearbyCount = Entities_QueryRange(&newPos, 1.0f, nearby);
+			for (k = 0; k < nearbyCount; k++) {
+				struct Entity* me;
+				mi = nearby[k];
+				if (mi >= MAX_NET_PLAYERS || !Mob_IsMob(mi)) continue;
+				me = Entities.List[mi];
 				if (mobDeathTimer[mi] > 0.0f) continue; /* skip dying mobs */
 				dx = newPos.x - me->Position.x;
 				dy = newPos.y - (me->Position.y + 0.9f);
@@ -2622,7 +2624,8 @@ static void Arrow_ScheduledTick(struct ScheduledTask* task) {
 }
 
 static void MobEntity_Tick(struct Entity* e, float delta) {
-	int id, j;
+	cc_uint16 nearby[ENTITIES_MAX_COUNT];
+	int id, j, k, nearbyCount;
 	float dx, dy, dz, distSq, dist, rx, rz, rdist;
 	Vec3 playerPos;
 
@@ -2653,7 +2656,7 @@ static void MobEntity_Tick(struct Entity* e, float delta) {
 						TNT_Explode(bx, by, bz);
 					} else if (mobCreeperVariant[id] == CREEPER_VAR_NUKE) {
 						TNT_ExplodeRadius(bx, by, bz, CREEPER_NUKE_POWER);
-						Audio_PlayDigSound(SOUND_EXPLODE_BIG);
+						Audio_PlayDigSoundAt(SOUND_EXPLODE_BIG, e->Position.x, e->Position.y, e->Position.z);
 					}
 					/* CREEPER_VAR_STANDARD and CREEPER_VAR_MELEE: no death explosion */
 				} else if (Game_CreeperBehavior == CREEPER_EXPLODE_DEATH) {
@@ -2696,7 +2699,7 @@ static void MobEntity_Tick(struct Entity* e, float delta) {
 				int bz = (int)Math_Floor(e->Position.z);
 				if (Game_CreeperVariants && mobCreeperVariant[id] == CREEPER_VAR_NUKE) {
 					TNT_ExplodeRadius(bx, by, bz, CREEPER_NUKE_POWER);
-					Audio_PlayDigSound(SOUND_EXPLODE_BIG);
+					Audio_PlayDigSoundAt(SOUND_EXPLODE_BIG, e->Position.x, e->Position.y, e->Position.z);
 				} else {
 					TNT_Explode(bx, by, bz);
 				}
@@ -2951,7 +2954,7 @@ static void MobEntity_Tick(struct Entity* e, float delta) {
 				if (useExplosionAI) {
 					if (distSq < CREEPER_ATTACK_RANGE_SQ && mobCreeperFuse[id] < 0.0f) {
 						mobCreeperFuse[id] = CREEPER_ATTACK_FUSE_TIME;
-						Audio_PlayDigSound(SOUND_FUSE);
+						Audio_PlayDigSoundAt(SOUND_FUSE, e->Position.x, e->Position.y, e->Position.z);
 					}
 					/* Keep following player at 50% speed while fuse is lit */
 					if (mobCreeperFuse[id] >= 0.0f) {
@@ -3079,9 +3082,10 @@ static void MobEntity_Tick(struct Entity* e, float delta) {
 		}
 
 		/* Hostile mob spacing: push away from other nearby hostile mobs */
-		for (j = 0; j < MAX_NET_PLAYERS; j++) {
-			if (j == id || mobType[j] != MOB_TYPE_HOSTILE) continue;
-			if (!Entities.List[j]) continue;
+		nearbyCount = Entities_QueryRange(&e->Position, MOB_SPACING_DIST, nearby);
+		for (k = 0; k < nearbyCount; k++) {
+			j = nearby[k];
+			if (j == id || j >= MAX_NET_PLAYERS || mobType[j] != MOB_TYPE_HOSTILE) continue;
 
 			rx = e->Position.x - Entities.List[j]->Position.x;
 			rz = e->Position.z - Entities.List[j]->Position.z;
@@ -3217,11 +3221,13 @@ void Mob_TriggerCreeperChainExplosion(int id) {
 	mobDeathRotZ[id]  = (Random_Float(&mob_rng) < 0.5f) ? 90.0f : -90.0f;
 	mobHasTarget[id]  = false;
 	mobIsMoving[id]   = false;
-	Audio_PlayDigSound(SOUND_FUSE);
+	Audio_PlayDigSoundAt(SOUND_FUSE, Entities.List[id]->Position.x, 
+						Entities.List[id]->Position.y, Entities.List[id]->Position.z);
 }
 
 void Mob_DamageMob(int id, int damage, cc_bool fromPlayer) {
 	struct Entity* e;
+	int sound;
 
 	if (id < 0 || id >= MAX_NET_PLAYERS) return;
 	if (mobType[id] == MOB_TYPE_NONE) return;
@@ -3250,15 +3256,15 @@ void Mob_DamageMob(int id, int damage, cc_bool fromPlayer) {
 		/* Start death animation: 0.5s fall-over (+ 1s on ground for creeper explode-on-death) */
 		float deathDuration = 0.5f;
 
-		/* Play mob-specific death sound (NOT hurt sound) */
+		/* Mob-specific death sound (NOT hurt sound) */
 		switch (mobModelIdx[id]) {
-			case MOB_IDX_SKELETON: Audio_PlayDigSound(SOUND_SKELETON_DEATH); break;
-			case MOB_IDX_CREEPER:  Audio_PlayDigSound(SOUND_CREEPER_DEATH);  break;
-			case MOB_IDX_SPIDER:   Audio_PlayDigSound(SOUND_SPIDER_DEATH);   break;
-			case MOB_IDX_ZOMBIE:   Audio_PlayDigSound(SOUND_ZOMBIE_DEATH);   break;
-			case MOB_IDX_PIG:      Audio_PlayDigSound(SOUND_PIG_DEATH);      break;
-			case MOB_IDX_SHEEP:    Audio_PlayDigSound(SOUND_SHEEP);          break;
-			default:               Audio_PlayDigSound(SOUND_HURT);           break;
+			case MOB_IDX_SKELETON: sound = SOUND_SKELETON_DEATH; break;
+			case MOB_IDX_CREEPER:  sound = SOUND_CREEPER_DEATH;  break;
+			case MOB_IDX_SPIDER:   sound = SOUND_SPIDER_DEATH;   break;
+			case MOB_IDX_ZOMBIE:   sound = SOUND_ZOMBIE_DEATH;   break;
+			case MOB_IDX_PIG:      sound = SOUND_PIG_DEATH;      break;
+			case MOB_IDX_SHEEP:    sound = SOUND_SHEEP;          break;
+			default:               sound = SOUND_HURT;           break;
 		}
 
 		if (mobModelIdx[id] == MOB_IDX_CREEPER) {
@@ -3276,17 +3282,18 @@ void Mob_DamageMob(int id, int damage, cc_bool fromPlayer) {
 		mobHasTarget[id]  = false;
 		mobIsMoving[id]   = false;
 	} else {
-		/* Play mob-specific hurt sound */
+		/* Mob-specific hurt sound */
 		switch (mobModelIdx[id]) {
-			case MOB_IDX_SKELETON: Audio_PlayDigSound(SOUND_SKELETON_HURT); break;
-			case MOB_IDX_CREEPER:  Audio_PlayDigSound(SOUND_CREEPER_HURT);  break;
-			case MOB_IDX_SPIDER:   Audio_PlayDigSound(SOUND_SPIDER_HURT);   break;
-			case MOB_IDX_ZOMBIE:   Audio_PlayDigSound(SOUND_ZOMBIE_HURT);   break;
-			case MOB_IDX_PIG:      Audio_PlayDigSound(SOUND_PIG_HURT);      break;
-			case MOB_IDX_SHEEP:    Audio_PlayDigSound(SOUND_SHEEP);         break;
-			default:               Audio_PlayDigSound(SOUND_HURT);          break;
+			case MOB_IDX_SKELETON: sound = SOUND_SKELETON_HURT; break;
+			case MOB_IDX_CREEPER:  sound = SOUND_CREEPER_HURT;  break;
+			case MOB_IDX_SPIDER:   sound = SOUND_SPIDER_HURT;   break;
+			case MOB_IDX_ZOMBIE:   sound = SOUND_ZOMBIE_HURT;   break;
+			case MOB_IDX_PIG:      sound = SOUND_PIG_HURT;      break;
+			case MOB_IDX_SHEEP:    sound = SOUND_SHEEP;         break;
+			default:               sound = SOUND_HURT;          break;
 		}
 	}
+	if (e) Audio_PlayDigSoundAt(sound, e->Position.x, e->Position.y, e->Position.z);
 }
 
 void Mob_RemoveAllMobs(void) {
@@ -3417,6 +3424,7 @@ static void SpawnRandomMob(void) {
 		mob_vtable_inited            = true;
 	}
 	np->Base.VTABLE = &mobEntity_VTABLE;
+	np->Base.Flags |= ENTITY_FLAG_TICK_LOD;
 
 	Entities.List[id] = &np->Base;
 	Event_RaiseInt(&EntityEvents.Added, id);
@@ -3525,6 +3533,7 @@ static cc_bool SpawnMobAt(Vec3 spawnPos, int idx) {
 		mob_vtable_inited            = true;
 	}
 	np->Base.VTABLE = &mobEntity_VTABLE;
+	np->Base.Flags |= ENTITY_FLAG_TICK_LOD;
 
 	Entities.List[id] = &np->Base;
 	Event_RaiseInt(&EntityEvents.Added, id);
@@ -3586,6 +3595,11 @@ static cc_bool SpawnMobAt(Vec3 spawnPos, int idx) {
 	return true;
 }
 
+cc_bool Mob_SpawnAt(float x, float y, float z, int type) {
+	Vec3 pos; Vec3_Set(pos, x, y, z);
+	return SpawnMobAt(pos, type);
+}
+
 static cc_bool BindTriggered_SpawnMob(int key, struct InputDevice* device) {
 	if (Gui.InputGrab) return false;
 	SpawnRandomMob();
@@ -3631,6 +3645,7 @@ static void BoomCommand_Execute(const cc_string* args, int argsCount) {
 		mob_vtable_inited            = true;
 	}
 	np->Base.VTABLE = &mobEntity_VTABLE;
+	np->Base.Flags |= ENTITY_FLAG_TICK_LOD;
 
 	Entities.List[id] = &np->Base;
 	Event_RaiseInt(&EntityEvents.Added, id);
@@ -3702,58 +3717,196 @@ static cc_bool Mob_IsSpawnableBlock(BlockID b) {
 	       b == BLOCK_SAND || b == BLOCK_GRAVEL;
 }
 
+/* Spawnable surfaces (i.e. air with spawnable ground below) in each chunk, split into shadowed and lit */
+/*  Chunk lists are built when first needed, and then kept up to date as blocks change */
+struct SpawnList  { cc_uint16* cells; int count, capacity; };
+struct SpawnChunk { struct SpawnList lists[2]; cc_bool built; };
+static struct SpawnChunk* spawnChunks;
+static int spawnChunksCount;
+
+#define SPAWN_CELL(x, y, z) ((x & CHUNK_MASK) | ((z & CHUNK_MASK) << 4) | ((y & CHUNK_MASK) << 8))
+/* Furthest distance from the player mobs are naturally spawned at */
+#define SPAWN_RANGE 16
+/* Maximum number of chunks that may be searched for spawnable surfaces */
+#define SPAWN_MAX_CHUNKS 2048
+
+static cc_bool Mob_IsSpawnSurface(int x, int y, int z) {
+	BlockID b0, b1;
+	if (y <= 0 || !World_Contains(x, y, z)) return false;
+
+	/* Ground must be a solid and spawnable type */
+	if (!World_IsSolid(x, y - 1, z) || !Mob_IsSpawnableBlock(World_GetBlock(x, y - 1, z))) return false;
+
+	/* Ensure 2 blocks of air above */
+	if (!Mob_BlockIsPassable(x, y, z) || !Mob_BlockIsPassable(x, y + 1, z)) return false;
+
+	/* Don't spawn underwater or in lava */
+	b0 = World_GetBlock(x, y, z);
+	b1 = World_SafeGetBlock(x, y + 1, z);
+	if (b0 == BLOCK_WATER || b0 == BLOCK_STILL_WATER ||
+		b1 == BLOCK_WATER || b1 == BLOCK_STILL_WATER) return false;
+	if (b0 == BLOCK_LAVA || b0 == BLOCK_STILL_LAVA ||
+		b1 == BLOCK_LAVA || b1 == BLOCK_STILL_LAVA) return false;
+	return true;
+}
+
+static void SpawnList_Add(struct SpawnList* list, int cell) {
+	if (list->count == list->capacity) {
+		Utils_Resize((void**)&list->cells, &list->capacity, sizeof(cc_uint16), 32, 64);
+	}
+	list->cells[list->count++] = cell;
+}
+
+static void SpawnList_RemoveAt(struct SpawnList* list, int i) {
+	list->cells[i] = list->cells[--list->count];
+}
+
+static void SpawnChunk_AddCell(struct SpawnChunk* chunk, int x, int y, int z) {
+	if (!Mob_IsSpawnSurface(x, y, z)) return;
+	SpawnList_Add(&chunk->lists[Lighting.IsLit(x, y, z)], SPAWN_CELL(x, y, z));
+}
+
+static void SpawnChunk_Build(struct SpawnChunk* chunk, int cx, int cy, int cz) {
+	int x1 = cx << CHUNK_SHIFT, y1 = cy << CHUNK_SHIFT, z1 = cz << CHUNK_SHIFT;
+	int x2 = min(x1 + CHUNK_MAX, World.MaxX);
+	int y2 = min(y1 + CHUNK_MAX, World.MaxY);
+	int z2 = min(z1 + CHUNK_MAX, World.MaxZ);
+	int x, y, z;
+
+	for (y = y1; y <= y2; y++)
+		for (z = z1; z <= z2; z++)
+			for (x = x1; x <= x2; x++)
+				SpawnChunk_AddCell(chunk, x, y, z);
+	chunk->built = true;
+}
+
+static void SpawnChunks_Free(void) {
+	int i;
+	if (!spawnChunks) return;
+
+	for (i = 0; i < spawnChunksCount; i++) 
+	{
+		Mem_Free(spawnChunks[i].lists[0].cells);
+		Mem_Free(spawnChunks[i].lists[1].cells);
+	}
+	Mem_Free(spawnChunks);
+	spawnChunks = NULL;
+}
+
+static void SpawnChunks_BlockDefChanged(void* obj) { SpawnChunks_Free(); }
+static void SpawnChunks_LightingModeChanged(void* obj, cc_uint8 oldMode, cc_bool fromServer) { SpawnChunks_Free(); }
+
+void Mob_OnBlockChanged(int x, int y, int z) {
+	struct SpawnChunk* chunk;
+	struct SpawnList* list;
+	int cx = x >> CHUNK_SHIFT, cz = z >> CHUNK_SHIFT, cy;
+	int column, i, j, yy, y1, y2;
+	if (!spawnChunks) return;
+
+	/* The change affects the surfaces directly above and below the block, */
+	/*  but may also change whether anything below it in the column is lit */
+	column = SPAWN_CELL(x, 0, z);
+	for (cy = 0; cy < World.ChunksY; cy++) 
+	{
+		chunk = &spawnChunks[World_ChunkPack(cx, cy, cz)];
+		if (!chunk->built) continue;
+
+		for (j = 0; j < 2; j++) 
+		{
+			list = &chunk->lists[j];
+			for (i = 0; i < list->count; ) 
+			{
+				if ((list->cells[i] & 0xFF) == column) { SpawnList_RemoveAt(list, i); } 
+				else { i++; }
+			}
+		}
+
+		y1 = cy << CHUNK_SHIFT;
+		y2 = min(y1 + CHUNK_MAX, World.MaxY);
+		for (yy = y1; yy <= y2; yy++) { SpawnChunk_AddCell(chunk, x, yy, z); }
+	}
+}
+
 /* lightMode: 0 = no light check, 1 = hostile (must be shadow), 2 = passive (must be lit) */
 static cc_bool Mob_FindNaturalSpawnPos(Vec3* outPos, int lightMode) {
+	static int chunkIds[SPAWN_MAX_CHUNKS];
+	static int chunkWeights[SPAWN_MAX_CHUNKS];
 	struct Entity* pe = &Entities.CurPlayer->Base;
+	struct SpawnChunk* chunk;
+	struct SpawnList* list;
 	int px, py, pz, tx, ty, tz, attempts;
-	BlockID groundBlock;
+	int cx, cy, cz, cx1, cz1, cx2, cz2, cy1, cy2, y;
+	int i, cell, lit, pick, count = 0, total = 0;
+
+	if (!World.Blocks) return false;
+	if (!spawnChunks) {
+		spawnChunks = (struct SpawnChunk*)Mem_TryAllocCleared(World.ChunksCount, sizeof(struct SpawnChunk));
+		if (!spawnChunks) return false;
+		spawnChunksCount = World.ChunksCount;
+	}
 
 	px = (int)Math_Floor(pe->Position.x);
 	py = (int)Math_Floor(pe->Position.y);
 	pz = (int)Math_Floor(pe->Position.z);
 
-	for (attempts = 0; attempts < 20; attempts++) {
-		/* Random position 16-32 blocks from player */
-		tx = px + (Random_Next(&mob_rng, 33) - 16);
-		tz = pz + (Random_Next(&mob_rng, 33) - 16);
+	/* Only chunks that might contain surfaces within range, and at or up to SPAWN_RANGE below the player */
+	cx1 = max(px - SPAWN_RANGE, 0) >> CHUNK_SHIFT; cx2 = min(px + SPAWN_RANGE, World.MaxX) >> CHUNK_SHIFT;
+	cz1 = max(pz - SPAWN_RANGE, 0) >> CHUNK_SHIFT; cz2 = min(pz + SPAWN_RANGE, World.MaxZ) >> CHUNK_SHIFT;
+	cy1 = max(py - SPAWN_RANGE, 0) >> CHUNK_SHIFT; cy2 = min(py, World.MaxY) >> CHUNK_SHIFT;
+	if (px + SPAWN_RANGE < 0 || pz + SPAWN_RANGE < 0 || py < 0) return false;
 
-		/* Skip if too close (within 8 blocks) */
-		{
-			int distX = tx - px;
-			int distZ = tz - pz;
-			if (distX < 0) distX = -distX;
-			if (distZ < 0) distZ = -distZ;
-			if (distX < 8 && distZ < 8) continue;
-		}
-
-		ty = py;
-
-		if (!World_Contains(tx, ty, tz)) continue;
-
-		/* Find ground level: search down for solid ground */
-		while (ty > 0 && !Mob_BlockIsSolid(tx, ty - 1, tz)) ty--;
-		if (ty <= 0) continue;
+	for (cy = cy1; cy <= cy2; cy++)
+		for (cz = cz1; cz <= cz2; cz++)
+			for (cx = cx1; cx <= cx2 && count < SPAWN_MAX_CHUNKS; cx++)
+	{
+		i     = World_ChunkPack(cx, cy, cz);
+		chunk = &spawnChunks[i];
+		if (!chunk->built) SpawnChunk_Build(chunk, cx, cy, cz);
 
-		/* Check ground block is a spawnable type */
-		groundBlock = World_GetBlock(tx, ty - 1, tz);
-		if (!Mob_IsSpawnableBlock(groundBlock)) continue;
+		if (lightMode != 2) total += chunk->lists[0].count;
+		if (lightMode != 1) total += chunk->lists[1].count;
+		chunkIds[count] = i; chunkWeights[count] = total; count++;
+	}
 
-		/* Ensure 2 blocks of air above */
-		if (!Mob_BlockIsPassable(tx, ty, tz) || !Mob_BlockIsPassable(tx, ty + 1, tz)) continue;
+	for (attempts = 0; attempts < 20 && total; attempts++) {
+		/* Pick a chunk weighted by how many suitable surfaces it has, then a surface in it */
+		pick = Random_Next(&mob_rng, total);
+		for (i = 0; chunkWeights[i] <= pick; i++) { }
+		chunk = &spawnChunks[chunkIds[i]];
+		pick -= i ? chunkWeights[i - 1] : 0;
 
-		/* Don't spawn underwater or in lava */
-		{
-			BlockID b0 = World_GetBlock(tx, ty, tz);
-			BlockID b1 = World_GetBlock(tx, ty + 1, tz);
-			if (b0 == BLOCK_WATER || b0 == BLOCK_STILL_WATER ||
-				b1 == BLOCK_WATER || b1 == BLOCK_STILL_WATER) continue;
-			if (b0 == BLOCK_LAVA || b0 == BLOCK_STILL_LAVA ||
-				b1 == BLOCK_LAVA || b1 == BLOCK_STILL_LAVA) continue;
+		if (lightMode) {
+			lit = lightMode == 2;
+		} else {
+			lit   = pick >= chunk->lists[0].count;
+			pick -= lit ? chunk->lists[0].count : 0;
+		}
+		list = &chunk->lists[lit];
+		if (pick >= list->count) continue; /* list changed since weights were calculated */
+		cell = list->cells[pick];
+
+		cx = chunkIds[i] % World.ChunksX;
+		cz = (chunkIds[i] / World.ChunksX) / World.ChunksY;
+		cy = (chunkIds[i] / World.ChunksX) % World.ChunksY;
+		tx = (cx << CHUNK_SHIFT) | (cell & 0x0F);
+		tz = (cz << CHUNK_SHIFT) | ((cell >> 4) & 0x0F);
+		ty = (cy << CHUNK_SHIFT) | (cell >> 8);
+
+		/* Must be 8-16 blocks away from player horizontally, and at most 16 blocks below them */
+		if (Math_AbsI(tx - px) > SPAWN_RANGE || Math_AbsI(tz - pz) > SPAWN_RANGE) continue;
+		if (Math_AbsI(tx - px) < 8 && Math_AbsI(tz - pz) < 8) continue;
+		if (ty > py || ty < py - SPAWN_RANGE) continue;
+
+		/* Must be the first surface below the player in the column, so mobs don't fill sealed caves */
+		for (y = ty; y < py && !Mob_BlockIsSolid(tx, y, tz); y++) { }
+		if (y < py) continue;
+
+		/* Light may have spread from blocks changing elsewhere, so reclassify if needed */
+		if (Lighting.IsLit(tx, ty, tz) != lit) {
+			SpawnList_RemoveAt(list, pick);
+			SpawnList_Add(&chunk->lists[!lit], cell);
+			if (lightMode) continue;
 		}
-
-		/* Light check: hostile must be in shadow, passive must be in light */
-		if (lightMode == 1 && Lighting.IsLit(tx, ty, tz)) continue;
-		if (lightMode == 2 && !Lighting.IsLit(tx, ty, tz)) continue;
 
 		outPos->x = (float)tx + 0.5f;
 		outPos->y = (float)ty;
@@ -4035,9 +4188,9 @@ static void OnInit(void) {
 	LocalPlayerInput_Add(&gamepadInput);
 	HookInputBinds();
 
-	ScheduledTask_Add(1.0 / 20, Arrow_ScheduledTick);
-	ScheduledTask_Add(1.0 / 20.0, DroppedItem_TickAll);
-	ScheduledTask_Add(1.0, Mob_NaturalSpawnTick);
+	ScheduledTask_AddNamed(1.0 / 20, Arrow_ScheduledTick,    "Arrow_ScheduledTick");
+	ScheduledTask_AddNamed(1.0 / 20.0, DroppedItem_TickAll, "DroppedItem_TickAll");
+	ScheduledTask_AddNamed(1.0, Mob_NaturalSpawnTick,       "Mob_NaturalSpawnTick");
 
 	Commands_Register(&BoomCommand);
 
@@ -4049,6 +4202,8 @@ static void OnInit(void) {
 	Event_Register_(&InputEvents.Up2,     NULL, OnInputUp);
 
 	Event_Register_(&UserEvents.HackPermsChanged, NULL, InputHandler_CheckZoomFov);
+	Event_Register_(&BlockEvents.BlockDefChanged, NULL, SpawnChunks_BlockDefChanged);
+	Event_Register_(&WorldEvents.LightingModeChanged, NULL, SpawnChunks_LightingModeChanged);
 	StoredHotkeys_LoadAll();
 
 	Bind_OnTriggered[BIND_FORWARD] = Player_TriggerUp;
@@ -4064,11 +4219,13 @@ static void OnInit(void) {
 
 static void OnFree(void) {
 	HotkeysText.count = 0;
+	SpawnChunks_Free();
 }
 
 static void OnNewMap(void) {
 	Mob_RemoveAllMobs();
 	mobSpawnTimer = 0.0f;
+	SpawnChunks_Free();
 }
 
 struct IGameComponent InputHandler_Component = {
@@ -18,6 +18,12 @@ void Mob_RemoveAllMobs(void);
 cc_bool Mob_IsMob(int id);
 cc_bool Mob_IsCreeper(int id);
 void Mob_TriggerCreeperChainExplosion(int id);
+/* Number of mob types that can be spawned (pig, sheep, creeper, spider, zombie, skeleton) */
+#define MOB_TYPES_COUNT 6
+/* Spawns a mob of the given type at the given position, returning false if unable to */
+cc_bool Mob_SpawnAt(float x, float y, float z, int type);
+/* Updates the surfaces mobs can naturally spawn on, after a block in the world changes */
+void Mob_OnBlockChanged(int x, int y, int z);
 
 
 /* whether to leave text input open for user to enter further input */
@@ -247,6 +247,8 @@ void Launcher_Setup(void) {
 	LWebTasks_Init();
 	Session_Load();
 	GameVersion_Load();
+	/* Job workers must be started before http workers, which may submit jobs */
+	Jobs_Init();
 	Http_Component.Init();
 
 	/* Skip launcher completely - auto-start singleplayer directly */
@@ -22,6 +22,12 @@ struct ChunkPartInfo* MapRenderer_PartsTranslucent;
 static cc_bool inTranslucent;
 static IVec3 chunkPos;
 
+#ifdef CC_GFX_CHUNK_VERTICES
+#define CHUNK_VERTEX_FORMAT VERTEX_FORMAT_CHUNK
+#else
+#define CHUNK_VERTEX_FORMAT VERTEX_FORMAT_TEXTURED
+#endif
+
 /* The number of non-empty Normal/Translucent ChunkPartInfos (across entire world) for each 1D atlas batch. */
 /* 1D atlas batches that do not have any ChunkPartInfos can be entirely skipped. */
 static int normPartsCount[ATLAS1D_MAX_ATLASES], tranPartsCount[ATLAS1D_MAX_ATLASES];
@@ -48,6 +54,8 @@ int MapRenderer_MaxChunkUpdates;
 cc_bool MapRenderer_OcclusionCulling;
 /* Cached number of chunks in the world */
 static int chunksCount;
+/* Number of times all chunks have been deleted by MapRenderer_Refresh */
+static int refreshCount;
 /* Queue for occlusion culling flood-fill */
 static int* occlusionQueue;
 static int occlusionQueueSize;
@@ -113,19 +121,79 @@ static void CheckWeather(float delta) {
 	Gfx_SetAlphaBlending(false);
 }
 
+#if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
+/* Ranges of chunk vertices that are drawn with the same face culling state */
+/* Ranges directly after each other in the same vertex buffer are merged into one range */
+#define MAX_DRAW_RANGES 512
+struct DrawRanges {
+	cc_bool cull;
+	int count;
+	struct ChunkInfo* infos[MAX_DRAW_RANGES];
+	int counts[MAX_DRAW_RANGES], offsets[MAX_DRAW_RANGES];
+};
+static struct DrawRanges culledRanges = { true }, drawRanges;
+
+#ifdef CC_GFX_CHUNK_VERTICES
+/* Chunk vertices are relative to their chunk's origin, so only ranges of the same chunk can be drawn at once */
+#define SameDrawGroup(a, b) ((a) == (b))
+#else
+/* All ranges in the same vertex buffer can be drawn at once */
+#define SameDrawGroup(a, b) ((a)->vb == (b)->vb)
+#endif
+
+static void FlushRanges(struct DrawRanges* list) {
+	struct ChunkInfo* info;
+	int i, j;
+	if (!list->count) return;
+	if (list->cull) Gfx_SetFaceCulling(true);
+
+	for (i = 0; i < list->count; i = j)
+	{
+		info = list->infos[i];
+		for (j = i + 1; j < list->count && SameDrawGroup(list->infos[j], info); j++) { }
+
+		Gfx_BindVb_Textured(info->vb);
+#ifdef CC_GFX_CHUNK_VERTICES
+		Gfx_SetChunkOrigin(info->centreX - HALF_CHUNK_SIZE, info->centreY - HALF_CHUNK_SIZE, 
+							info->centreZ - HALF_CHUNK_SIZE);
+#endif
+		/* Gfx_DrawIndexedTris_T2fC4b_Multi updates Game_DrawCalls with the calls it submits */
+		Gfx_DrawIndexedTris_T2fC4b_Multi(j - i, &list->counts[i], &list->offsets[i]);
+	}
+
+	if (list->cull) Gfx_SetFaceCulling(false);
+	list->count = 0;
+}
+
+static void AddRange(struct DrawRanges* list, struct ChunkInfo* info, int offset, int count) {
+	int last = list->count - 1;
+
+	if (last >= 0 && SameDrawGroup(list->infos[last], info) && list->offsets[last] + list->counts[last] == offset
+			&& list->counts[last] + count <= GFX_MAX_VERTICES) {
+		list->counts[last] += count; return;
+	}
+
+	if (list->count == MAX_DRAW_RANGES) FlushRanges(list);
+	list->infos[list->count]   = info;
+	list->offsets[list->count] = offset;
+	list->counts[list->count]  = count;
+	list->count++;
+}
+#endif
+
 #if CC_GFX_BACKEND == CC_GFX_BACKEND_GL11
 	#define DrawFace(face, ign)    Gfx_BindVb(part.vbs[face]); Gfx_DrawIndexedTris_T2fC4b(0, 0);
 	#define DrawFaces(f1, f2, ign) DrawFace(f1, ign); DrawFace(f2, ign);
+	#define DrawCulledFaces(f1, f2, ign) Gfx_SetFaceCulling(true); DrawFaces(f1, f2, ign); Gfx_SetFaceCulling(false);
 #else
-	#define DrawFace(face, offset)    Gfx_DrawIndexedTris_T2fC4b(part.counts[face], offset);
-	#define DrawFaces(f1, f2, offset) Gfx_DrawIndexedTris_T2fC4b(part.counts[f1] + part.counts[f2], offset);
+	#define DrawFace(face, offset)    AddRange(&drawRanges, info, offset, part.counts[face]);
+	#define DrawFaces(f1, f2, offset) AddRange(&drawRanges, info, offset, part.counts[f1] + part.counts[f2]);
+	#define DrawCulledFaces(f1, f2, offset) AddRange(&culledRanges, info, offset, part.counts[f1] + part.counts[f2]);
 #endif
 
 #define DrawNormalFaces(minFace, maxFace) \
 if (drawMin && drawMax) { \
-	Gfx_SetFaceCulling(true); \
-	DrawFaces(minFace, maxFace, offset); \
-	Gfx_SetFaceCulling(false); \
+	DrawCulledFaces(minFace, maxFace, offset); \
 	Game_Vertices += (part.counts[minFace] + part.counts[maxFace]); \
 } else if (drawMin) { \
 	DrawFace(minFace, offset); \
@@ -140,7 +208,7 @@ static void RenderNormalBatch(int batch) {
 	struct ChunkInfo* info;
 	struct ChunkPartInfo part;
 	cc_bool drawMin, drawMax;
-	int i, offset, count;
+	int i, offset, count, base = 0;
 
 	for (i = 0; i < renderChunksCount; i++) {
 		info = renderChunks[i];
@@ -149,12 +217,11 @@ static void RenderNormalBatch(int batch) {
 		part = info->normalParts[batchOffset];
 		if (part.offset < 0) continue;
 		hasNormParts[batch] = true;
-
-#if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
-		Gfx_BindVb_Textured(info->vb);
+#ifdef CHUNK_VB_ARENA
+		base = info->vbOffset;
 #endif
 
-		offset  = part.offset + part.spriteCount;
+		offset  = base + part.offset + part.spriteCount;
 		drawMin = info->drawXMin && part.counts[FACE_XMIN];
 		drawMax = info->drawXMax && part.counts[FACE_XMAX];
 		DrawNormalFaces(FACE_XMIN, FACE_XMAX);
@@ -170,42 +237,46 @@ static void RenderNormalBatch(int batch) {
 		DrawNormalFaces(FACE_YMIN, FACE_YMAX);
 
 		if (!part.spriteCount) continue;
-		offset = part.offset;
+		offset = base + part.offset;
 		count  = part.spriteCount >> 2; /* 4 per sprite */
 
-		Gfx_SetFaceCulling(true);
 		/* TODO: fix to not render them all */
 #if CC_GFX_BACKEND == CC_GFX_BACKEND_GL11
+		Gfx_SetFaceCulling(true);
 		Gfx_BindVb(part.vbs[FACE_COUNT]);
 		Gfx_DrawIndexedTris_T2fC4b(0, 0);
 		Game_Vertices += count * 4;
 		Gfx_SetFaceCulling(false);
-		continue;
-#endif
+#else
 		if (info->drawXMax || info->drawZMin) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
+			AddRange(&culledRanges, info, offset, count); Game_Vertices += count;
 		} offset += count;
 
 		if (info->drawXMin || info->drawZMax) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
+			AddRange(&culledRanges, info, offset, count); Game_Vertices += count;
 		} offset += count;
 
 		if (info->drawXMin || info->drawZMin) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
+			AddRange(&culledRanges, info, offset, count); Game_Vertices += count;
 		} offset += count;
 
 		if (info->drawXMax || info->drawZMax) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
+			AddRange(&culledRanges, info, offset, count); Game_Vertices += count;
 		}
-		Gfx_SetFaceCulling(false);
+#endif
 	}
+
+#if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
+	FlushRanges(&culledRanges);
+	FlushRanges(&drawRanges);
+#endif
 }
 
 void MapRenderer_RenderNormal(float delta) {
 	int batch;
 	if (!mapChunks) return;
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
+	Gfx_SetVertexFormat(CHUNK_VERTEX_FORMAT);
 	Gfx_SetAlphaTest(true);
 	
 	Gfx_EnableMipmaps();
@@ -244,7 +315,7 @@ static void RenderTranslucentBatch(int batch) {
 	struct ChunkInfo* info;
 	struct ChunkPartInfo part;
 	cc_bool drawMin, drawMax;
-	int i, offset;
+	int i, offset, base = 0;
 
 	for (i = 0; i < renderChunksCount; i++) {
 		info = renderChunks[i];
@@ -253,12 +324,11 @@ static void RenderTranslucentBatch(int batch) {
 		part = info->translucentParts[batchOffset];
 		if (part.offset < 0) continue;
 		hasTranParts[batch] = true;
-
-#if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
-		Gfx_BindVb_Textured(info->vb);
+#ifdef CHUNK_VB_ARENA
+		base = info->vbOffset;
 #endif
 
-		offset  = part.offset;
+		offset  = base + part.offset;
 		drawMin = (inTranslucent || info->drawXMin) && part.counts[FACE_XMIN];
 		drawMax = (inTranslucent || info->drawXMax) && part.counts[FACE_XMAX];
 		DrawTranslucentFaces(FACE_XMIN, FACE_XMAX);
@@ -273,6 +343,10 @@ static void RenderTranslucentBatch(int batch) {
 		drawMax = (inTranslucent || info->drawYMax) && part.counts[FACE_YMAX];
 		DrawTranslucentFaces(FACE_YMIN, FACE_YMAX);
 	}
+
+#if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
+	FlushRanges(&drawRanges);
+#endif
 }
 
 void MapRenderer_RenderTranslucent(float delta) {
@@ -281,7 +355,7 @@ void MapRenderer_RenderTranslucent(float delta) {
 
 	/* First fill depth buffer */
 	vertices = Game_Vertices;
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
+	Gfx_SetVertexFormat(CHUNK_VERTEX_FORMAT);
 	Gfx_SetAlphaBlending(false);
 	Gfx_DepthOnlyRendering(true);
 
@@ -322,6 +396,162 @@ void MapRenderer_RenderTranslucent(float delta) {
 }
 
 
+#ifdef CHUNK_VB_ARENA
+/*########################################################################################################################*
+*---------------------------------------------------Chunk vertex arena----------------------------------------------------*
+*#########################################################################################################################*/
+/* Chunk meshes are sub-allocated from large shared vertex buffers ('pages'), */
+/*  so that many chunks can be drawn without needing to bind a different vertex buffer */
+#ifdef CC_BUILD_LOWMEM
+/* Smaller pages on low memory systems, to avoid running out of VRAM for a mostly empty page */
+#define ARENA_PAGE_VERTICES (32 * 1024)
+#else
+#define ARENA_PAGE_VERTICES (256 * 1024)
+#endif
+/* Allocations are rounded up to a multiple of this, to reduce fragmentation */
+#define ARENA_ALIGN 64
+
+struct ArenaRange { int offset, count; };
+struct ArenaPage {
+	GfxResourceID vb;
+	int capacity, rangesCount;
+	struct ArenaRange* ranges; /* Free ranges, sorted by offset */
+};
+static struct ArenaPage* arenaPages;
+static int arenaPagesCount;
+
+static cc_bool ArenaPage_Alloc(struct ArenaPage* page, int count, int* offset) {
+	struct ArenaRange* range;
+	int i;
+
+	for (i = 0; i < page->rangesCount; i++)
+	{
+		range = &page->ranges[i];
+		if (range->count < count) continue;
+
+		*offset        = range->offset;
+		range->offset += count;
+		range->count  -= count;
+		if (range->count) return true;
+
+		/* Free range is entirely used up now */
+		page->rangesCount--;
+		Mem_Move(range, range + 1, (page->rangesCount - i) * sizeof(struct ArenaRange));
+		return true;
+	}
+	return false;
+}
+
+static void ArenaPage_Free(struct ArenaPage* page, int offset, int count) {
+	struct ArenaRange* ranges = page->ranges;
+	int i, n = page->rangesCount;
+	cc_bool joinPrev, joinNext;
+
+	for (i = 0; i < n && ranges[i].offset < offset; i++) { }
+	joinPrev = i > 0 && ranges[i - 1].offset + ranges[i - 1].count == offset;
+	joinNext = i < n && offset + count == ranges[i].offset;
+
+	if (joinPrev && joinNext) {
+		ranges[i - 1].count += count + ranges[i].count;
+		page->rangesCount--;
+		Mem_Move(&ranges[i], &ranges[i + 1], (n - i - 1) * sizeof(struct ArenaRange));
+	} else if (joinPrev) {
+		ranges[i - 1].count += count;
+	} else if (joinNext) {
+		ranges[i].offset = offset;
+		ranges[i].count += count;
+	} else {
+		page->rangesCount++;
+		Mem_Move(&ranges[i + 1], &ranges[i], (n - i) * sizeof(struct ArenaRange));
+		ranges[i].offset = offset;
+		ranges[i].count  = count;
+	}
+}
+
+static struct ArenaPage* Arena_AddPage(int count) {
+	int capacity = max(ARENA_PAGE_VERTICES, count);
+	struct ArenaRange* ranges;
+	struct ArenaPage* page;
+	GfxResourceID vb;
+
+	/* NOTE: When out of VRAM, Gfx_CreateVb calls Game_ReduceVRAM, which frees all the pages */
+	/*  through MapRenderer_Refresh. So the page must be fully created before it is linked in, */
+	/*  and nothing from arenaPages can be kept across this call */
+	vb = Gfx_CreateVb(CHUNK_VERTEX_FORMAT, capacity);
+	/* Fill the whole vertex buffer once, so that ranges of it can be updated later */
+	Gfx_LockVb(vb, CHUNK_VERTEX_FORMAT, capacity);
+	Gfx_UnlockVb(vb);
+
+	/* Used ranges are at least ARENA_ALIGN long, and adjacent free ranges are always */
+	/*  joined together, so there can never be more than this many free ranges */
+	ranges = (struct ArenaRange*)Mem_Alloc(capacity / ARENA_ALIGN / 2 + 1, 
+											sizeof(struct ArenaRange), "chunk arena ranges");
+	ranges[0].offset = 0;
+	ranges[0].count  = capacity;
+
+	arenaPages = (struct ArenaPage*)Mem_Realloc(arenaPages, arenaPagesCount + 1, 
+											sizeof(struct ArenaPage), "chunk arena pages");
+	page = &arenaPages[arenaPagesCount++];
+	page->vb          = vb;
+	page->capacity    = capacity;
+	page->ranges      = ranges;
+	page->rangesCount = 1;
+	return page;
+}
+
+void* MapRenderer_AllocVertices(struct ChunkInfo* info, int count) {
+	int i, offset, size = (count + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+	struct ArenaPage* page = NULL;
+
+	for (i = 0; i < arenaPagesCount; i++)
+	{
+		if (ArenaPage_Alloc(&arenaPages[i], size, &offset)) { page = &arenaPages[i]; break; }
+	}
+
+	if (!page) {
+		/* If adding the page reduced VRAM, this chunk was deleted too, but it */
+		/*  still gets built into the new page (see BuildChunk) */
+		page = Arena_AddPage(size);
+		ArenaPage_Alloc(page, size, &offset);
+	}
+
+	info->vb       = page->vb;
+	info->vbOffset = offset;
+	info->vbCount  = size;
+	return Gfx_LockVbRange(page->vb, CHUNK_VERTEX_FORMAT, offset, count);
+}
+
+void MapRenderer_SubmitVertices(struct ChunkInfo* info) {
+	Gfx_UnlockVbRange(info->vb);
+}
+
+static void FreeChunkVertices(struct ChunkInfo* info) {
+	int i;
+	if (!info->vb) return;
+
+	for (i = 0; i < arenaPagesCount; i++)
+	{
+		if (arenaPages[i].vb != info->vb) continue;
+		ArenaPage_Free(&arenaPages[i], info->vbOffset, info->vbCount);
+		break;
+	}
+	info->vb = 0;
+}
+
+static void FreeArenaPages(void) {
+	int i;
+	for (i = 0; i < arenaPagesCount; i++)
+	{
+		Gfx_DeleteVb(&arenaPages[i].vb);
+		Mem_Free(arenaPages[i].ranges);
+	}
+
+	Mem_Free(arenaPages);
+	arenaPages      = NULL;
+	arenaPagesCount = 0;
+}
+#endif
+
 /*########################################################################################################################*
 *---------------------------------------------------Chunk functionality---------------------------------------------------*
 *#########################################################################################################################*/
@@ -331,6 +561,8 @@ static void DeleteChunk(struct ChunkInfo* info) {
 	int i;
 #if CC_GFX_BACKEND == CC_GFX_BACKEND_GL11
 	int j;
+#elif defined CHUNK_VB_ARENA
+	FreeChunkVertices(info);
 #else
 	Gfx_DeleteVb(&info->vb);
 #endif
@@ -373,11 +605,21 @@ static void DeleteChunk(struct ChunkInfo* info) {
 /* Builds the mesh (hence vertex buffer) for the given chunk, and updates internal state */
 static void BuildChunk(struct ChunkInfo* info, int* chunkUpdates) {
 	struct ChunkPartInfo* ptr;
-	int i;
+	cc_uint64 beg;
+	int i, refreshes = refreshCount;
 
 	Game.ChunkUpdates++;
 	(*chunkUpdates)++;
+
+	beg = Benchmark_Begin();
+	Profiler_Begin("Builder_MakeChunk");
 	Builder_MakeChunk(info);
+	Profiler_End();
+	Benchmark_End(BENCH_BUILDER_MAKECHUNK, beg);
+
+	/* Running out of VRAM while building reduces view distance, which deletes all chunks */
+	/*  (including this one), so just discard the mesh and rebuild this chunk later */
+	if (refreshes != refreshCount) { DeleteChunk(info); return; }
 
 	info->dirty  = false;
 	info->noData = !info->normalParts && !info->translucentParts;
@@ -492,6 +734,9 @@ static void DeleteChunks(void) {
 		DeleteChunk(&mapChunks[i]);
 	}
 	ResetPartCounts();
+#ifdef CHUNK_VB_ARENA
+	FreeArenaPages();
+#endif
 }
 
 void MapRenderer_Refresh(void) {
@@ -500,6 +745,7 @@ void MapRenderer_Refresh(void) {
 
 	if (mapChunks && World.Blocks) {
 		DeleteChunks();
+		refreshCount++;
 
 		oldCount = MapRenderer_1DUsedCount;
 		MapRenderer_1DUsedCount = MapRenderer_UsedAtlases();
@@ -745,6 +991,28 @@ static void SimpleOcclusionCulling(void) {
 	occlusionQueueSize = tail;
 }
 
+cc_bool MapRenderer_IsOccluded(const struct AABB* bb) {
+	int minX, minY, minZ, maxX, maxY, maxZ;
+	int cx, cy, cz;
+	if (!MapRenderer_OcclusionCulling || !mapChunks) return false;
+
+	minX = (int)Math_Floor(bb->Min.x) >> CHUNK_SHIFT; maxX = (int)Math_Floor(bb->Max.x) >> CHUNK_SHIFT;
+	minY = (int)Math_Floor(bb->Min.y) >> CHUNK_SHIFT; maxY = (int)Math_Floor(bb->Max.y) >> CHUNK_SHIFT;
+	minZ = (int)Math_Floor(bb->Min.z) >> CHUNK_SHIFT; maxZ = (int)Math_Floor(bb->Max.z) >> CHUNK_SHIFT;
+
+	/* Chunks outside the map are never occluded */
+	if (minX < 0 || minY < 0 || minZ < 0) return false;
+	if (maxX >= World.ChunksX || maxY >= World.ChunksY || maxZ >= World.ChunksZ) return false;
+
+	for (cy = minY; cy <= maxY; cy++)
+		for (cz = minZ; cz <= maxZ; cz++)
+			for (cx = minX; cx <= maxX; cx++)
+	{
+		if (!mapChunks[World_ChunkPack(cx, cy, cz)].occluded) return false;
+	}
+	return true;
+}
+
 static void UpdateSortOrder(void) {
 	struct ChunkInfo* info;
 	IVec3 pos;
@@ -10,6 +10,8 @@ CC_BEGIN_HEADER
    Copyright 2014-2025 ClassiCube | Licensed under BSD-3
 */
 struct IGameComponent;
+struct AABB;
+struct VertexTextured;
 extern struct IGameComponent MapRenderer_Component;
 
 /* Max used 1D atlases. (i.e. Atlas1D_Index(maxTextureLoc) + 1) */
@@ -34,6 +36,12 @@ struct ChunkPartInfo {
 	cc_uint16 counts[FACE_COUNT]; /* Counts per face */
 };
 
+#if CC_GFX_BACKEND == CC_GFX_BACKEND_GL1  || CC_GFX_BACKEND == CC_GFX_BACKEND_GL2 || \
+	CC_GFX_BACKEND == CC_GFX_BACKEND_D3D9 || CC_GFX_BACKEND == CC_GFX_BACKEND_D3D11
+/* Chunk meshes are sub-allocated from a few large shared vertex buffers */
+#define CHUNK_VB_ARENA
+#endif
+
 /* Describes data necessary for rendering a chunk. */
 struct ChunkInfo {	
 	cc_uint16 centreX, centreY, centreZ; /* Centre coordinates of the chunk */
@@ -57,6 +65,9 @@ struct ChunkInfo {
 	cc_uint8 occlusionFlags; /* Bitmask of faces that can "see through" */
 #if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
 	GfxResourceID vb;
+#endif
+#ifdef CHUNK_VB_ARENA
+	int vbOffset, vbCount; /* Range of vertices in the shared vertex buffer */
 #endif
 	struct ChunkPartInfo* normalParts;
 	struct ChunkPartInfo* translucentParts;
@@ -82,6 +93,18 @@ void MapRenderer_Refresh(void);
 void MapRenderer_InvalidateSortOrder(void);
 /* Whether occlusion culling is enabled. */
 extern cc_bool MapRenderer_OcclusionCulling;
+/* Whether all the chunks the given box touches are hidden behind other solid chunks. */
+/* NOTE: Always false when occlusion culling is disabled. */
+cc_bool MapRenderer_IsOccluded(const struct AABB* bb);
+
+#ifdef CHUNK_VB_ARENA
+/* Allocates room for count vertices of the given chunk's mesh in a shared vertex buffer. */
+/* Returns temp memory to write the vertices (in the chunk vertex format) into, */
+/*  which must be uploaded with MapRenderer_SubmitVertices. */
+void* MapRenderer_AllocVertices(struct ChunkInfo* info, int count);
+/* Uploads the vertices written into the memory returned by MapRenderer_AllocVertices. */
+void MapRenderer_SubmitVertices(struct ChunkInfo* info);
+#endif
 
 CC_END_HEADER
 #endif
@@ -1721,7 +1721,7 @@ static void TexturePackScreen_EntryClick(void* screen, void* widget) {
 
 	TexturePack_SetDefault(&file);
 	TexturePack_Url.length = 0;
-	res = TexturePack_ExtractCurrent(true);
+	res = TexturePack_ExtractCurrentAsync(true);
 
 	CPE_SendNotifyAction(NOTIFY_ACTION_TEXTURE_PACK_CHANGED, 0);
 
@@ -1759,7 +1759,7 @@ static void TexturePackScreen_UploadCallback(const cc_string* path) {
 #else
 	String_Copy(&TexturePack_Path, path);
 #endif
-	TexturePack_ExtractCurrent(true);
+	TexturePack_ExtractCurrentAsync(true);
 }
 
 static void TexturePackScreen_ActionFunc(void* s, void* w) {
@@ -12,6 +12,7 @@
 #include "Block.h"
 #include "Stream.h"
 #include "Options.h"
+#include "MapRenderer.h"
 
 struct _ModelsData Models;
 /* NOTE: None of the built in models use more than 12 parts at once, but custom models can use up to 64 parts. */
@@ -63,7 +64,10 @@ cc_bool Model_ShouldRender(struct Entity* e) {
 	maxYZ  = max(bbHeight, bbLength);
 	maxXYZ = max(bbWidth,  maxYZ);
 	pos.y += bbHeight * 0.5f; /* Centre Y coordinate. */
-	return FrustumCulling_SphereInFrustum(pos.x, pos.y, pos.z, maxXYZ);
+	if (!FrustumCulling_SphereInFrustum(pos.x, pos.y, pos.z, maxXYZ)) return false;
+
+	/* Skip entities hidden behind walls or inside unseen caves */
+	return !MapRenderer_IsOccluded(&bb);
 }
 
 static float Model_MinDist(float dist, float extent) {
@@ -170,6 +174,105 @@ void Model_ApplyTexture(struct Entity* e) {
 }
 
 
+/* Scaling the packed texture coordinates of model vertices gives the same results for every entity */
+/*  using the same model and texture scale, so scaled coordinates are cached instead of recalculated */
+/*  for every vertex of every entity each frame */
+/* NOTE: Only used for models with MODEL_FLAG_STATIC_UVS, as some models modify UVs when drawing */
+struct ModelUV { float u, v; };
+struct ModelUVCache {
+	struct Model* model;
+	float uScale, vScale;
+	int count, capacity;
+	cc_uint32 lastUsed;
+	struct ModelUV* uvs;
+};
+#define MODEL_UV_CACHES 16
+static struct ModelUVCache uvCaches[MODEL_UV_CACHES];
+static struct ModelUVCache* uvCache_cur;
+static cc_uint32 uvCache_time;
+
+static struct ModelUVCache* ModelUVCache_Find(struct Model* model) {
+	struct ModelUVCache* c;
+	struct ModelUVCache* oldest = &uvCaches[0];
+	int i;
+	uvCache_time++;
+
+	for (i = 0; i < MODEL_UV_CACHES; i++)
+	{
+		c = &uvCaches[i];
+		if (c->model == model && c->uScale == Models.uScale && c->vScale == Models.vScale) {
+			c->lastUsed = uvCache_time; return c;
+		}
+		if (c->lastUsed < oldest->lastUsed) oldest = c;
+	}
+
+	/* Evict least recently used entry, but keep its allocated memory */
+	c = oldest;
+	c->model  = model;
+	c->uScale = Models.uScale;
+	c->vScale = Models.vScale;
+	c->count  = 0;
+	c->lastUsed = uvCache_time;
+	return c;
+}
+
+static void ModelUVCache_Extend(struct ModelUVCache* c, int end) {
+	struct ModelVertex* src = c->model->vertices;
+	float uScale = c->uScale, vScale = c->vScale;
+	int i;
+
+	if (end > c->capacity) {
+		c->capacity = max(end, c->model->maxVertices);
+		c->uvs = (struct ModelUV*)Mem_Realloc(c->uvs, c->capacity, sizeof(struct ModelUV), "model UVs");
+	}
+
+	for (i = c->count; i < end; i++)
+	{
+		c->uvs[i].u = (src[i].u & UV_POS_MASK) * uScale - (src[i].u >> UV_MAX_SHIFT) * 0.01f * uScale;
+		c->uvs[i].v = (src[i].v & UV_POS_MASK) * vScale - (src[i].v >> UV_MAX_SHIFT) * 0.01f * vScale;
+	}
+	c->count = end;
+}
+
+/* Returns the scaled texture coordinates of the given part's vertices, or NULL if not cached */
+static const struct ModelUV* Model_GetUVs(struct ModelPart* part) {
+	struct Model* model = Models.Active;
+	struct ModelUVCache* c = uvCache_cur;
+	int end = part->offset + part->count;
+	if (!(model->flags & MODEL_FLAG_STATIC_UVS)) return NULL;
+
+	if (!c || c->model != model || c->uScale != Models.uScale || c->vScale != Models.vScale) {
+		c = ModelUVCache_Find(model);
+		uvCache_cur = c;
+	}
+
+	if (end > c->count) ModelUVCache_Extend(c, end);
+	return &c->uvs[part->offset];
+}
+
+/* Discards any cached texture coordinates for the given model (e.g. when its vertices are rebuilt) */
+static void Model_InvalidateUVs(struct Model* model) {
+	int i;
+	for (i = 0; i < MODEL_UV_CACHES; i++)
+	{
+		if (uvCaches[i].model != model) continue;
+		uvCaches[i].model = NULL;
+		uvCaches[i].count = 0;
+	}
+	uvCache_cur = NULL;
+}
+
+static void Model_FreeUVs(void) {
+	int i;
+	for (i = 0; i < MODEL_UV_CACHES; i++)
+	{
+		Mem_Free(uvCaches[i].uvs);
+	}
+	Mem_Set(uvCaches, 0, sizeof(uvCaches));
+	uvCache_cur = NULL;
+}
+
+
 void Model_UpdateVB(void) {
 	struct Model* model = Models.Active;
 	if (!Models.Vb)
@@ -211,12 +314,27 @@ void Model_DrawPart(struct ModelPart* part) {
 	struct Model* model        = Models.Active;
 	struct ModelVertex* src    = &model->vertices[part->offset];
 	struct VertexTextured* dst = &Models.Vertices[model->index];
+	const struct ModelUV* uvs  = Model_GetUVs(part);
 
 	struct ModelVertex v;
 	int i, count = part->count;
 	float uScale = Models.uScale;
 	float vScale = Models.vScale;
 
+	if (uvs) {
+		for (i = 0; i < count; i++) 
+		{
+			v = *src;
+			dst->x = v.x; dst->y = v.y; dst->z = v.z;
+			dst->Col = Models.Cols[i >> 2];
+
+			dst->U = uvs->u; dst->V = uvs->v;
+			src++; dst++; uvs++;
+		}
+		model->index += count;
+		return;
+	}
+
 	for (i = 0; i < count; i++) 
 	{
 		v = *src;
@@ -238,6 +356,7 @@ void Model_DrawRotate(float angleX, float angleY, float angleZ, struct ModelPart
 	struct Model* model        = Models.Active;
 	struct ModelVertex* src    = &model->vertices[part->offset];
 	struct VertexTextured* dst = &Models.Vertices[model->index];
+	const struct ModelUV* uvs  = Model_GetUVs(part);
 
 	float cosX = Math_CosF(-angleX), sinX = Math_SinF(-angleX);
 	float cosY = Math_CosF(-angleY), sinY = Math_SinF(-angleY);
@@ -277,8 +396,12 @@ void Model_DrawRotate(float angleX, float angleY, float angleZ, struct ModelPart
 		dst->x = v.x + x; dst->y = v.y + y; dst->z = v.z + z;
 		dst->Col = Models.Cols[i >> 2];
 
-		dst->U = (v.u & UV_POS_MASK) * Models.uScale - (v.u >> UV_MAX_SHIFT) * 0.01f * Models.uScale;
-		dst->V = (v.v & UV_POS_MASK) * Models.vScale - (v.v >> UV_MAX_SHIFT) * 0.01f * Models.vScale;
+		if (uvs) {
+			dst->U = uvs->u; dst->V = uvs->v; uvs++;
+		} else {
+			dst->U = (v.u & UV_POS_MASK) * Models.uScale - (v.u >> UV_MAX_SHIFT) * 0.01f * Models.uScale;
+			dst->V = (v.v & UV_POS_MASK) * Models.vScale - (v.v >> UV_MAX_SHIFT) * 0.01f * Models.vScale;
+		}
 		src++; dst++;
 	}
 	model->index += count;
@@ -463,6 +586,7 @@ static void MakeModel(struct Model* model) {
 	Models.Active = model;
 	model->index  = 0;
 	model->MakeParts();
+	Model_InvalidateUVs(model);
 
 	model->flags |= MODEL_FLAG_INITED;
 	model->index  = 0;
@@ -490,6 +614,7 @@ void Model_Unregister(struct Model* model) {
 	struct Model* cur;
 	int i;
 	LinkedList_Remove(model, cur, models_head, models_tail); 
+	Model_InvalidateUVs(model);
 
 	/* unset this model from all entities, replacing with default fallback */
 	for (i = 0; i < ENTITIES_MAX_COUNT; i++) 
@@ -507,6 +632,16 @@ void Model_RegisterTexture(struct ModelTex* tex) {
 	LinkedList_Append(tex, textures_head, textures_tail);
 }
 
+struct ModelTex* Model_GetTexture(const cc_string* name) {
+	struct ModelTex* tex;
+
+	for (tex = textures_head; tex; tex = tex->next) 
+	{
+		if (String_CaselessEqualsConst(name, tex->name)) return tex;
+	}
+	return NULL;
+}
+
 static void Models_TextureChanged(void* obj, struct Stream* stream, const cc_string* name) {
 	struct ModelTex* tex;
 
@@ -879,6 +1014,9 @@ void CustomModel_Register(struct CustomModel* cm) {
 	cm->model.name        = cm->name;
 	cm->model.defaultTex  = &customDefaultTex;
 	cm->model.maxVertices = cm->numParts * MODEL_BOX_VERTICES;
+	/* animations only ever change positions of vertices */
+	cm->model.flags      |= MODEL_FLAG_STATIC_UVS;
+	Model_InvalidateUVs(&cm->model);
 
 	cm->model.MakeParts = Model_NoParts;
 	cm->model.Draw      = CustomModel_Draw;
@@ -902,6 +1040,7 @@ void CustomModel_Register(struct CustomModel* cm) {
 void CustomModel_Undefine(struct CustomModel* cm) {
 	if (!cm->defined) return;
 	if (cm->registered) Model_Unregister((struct Model*)cm);
+	Model_InvalidateUVs(&cm->model);
 
 	Mem_Free(cm->model.vertices);
 	Mem_Set(cm, 0, sizeof(struct CustomModel));
@@ -2708,6 +2847,7 @@ static void ToolModel_Register(void) {
 *-------------------------------------------------------Models component--------------------------------------------------*
 *#########################################################################################################################*/
 static void RegisterDefaultModels(void) {
+	struct Model* model;
 	Model_RegisterTexture(&human_tex);
 #ifndef CC_DISABLE_EXTRA_MODELS
 	Model_RegisterTexture(&chicken_tex);
@@ -2756,6 +2896,16 @@ static void RegisterDefaultModels(void) {
 	ItemModel_Register();
 	ToolModel_Register();
 #endif
+
+	for (model = models_head; model; model = model->next)
+	{
+		model->flags |= MODEL_FLAG_STATIC_UVS;
+	}
+#ifndef CC_DISABLE_EXTRA_MODELS
+	/* item and tool models offset UVs to the item's tile when drawing */
+	item_model.flags &= ~MODEL_FLAG_STATIC_UVS;
+	tool_model.flags &= ~MODEL_FLAG_STATIC_UVS;
+#endif
 }
 
 static void OnContextLost(void* obj) {
@@ -2781,6 +2931,7 @@ static void OnInit(void) {
 static void OnFree(void) {
 	OnContextLost(NULL);
 	CustomModel_FreeAll();
+	Model_FreeUVs();
 }
 
 static void OnReset(void) { CustomModel_FreeAll(); }
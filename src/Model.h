@@ -41,6 +41,8 @@ struct ModelTex { const char* name; cc_uint8 skinType; GfxResourceID texID; stru
 
 #define MODEL_FLAG_INITED    0x01
 #define MODEL_FLAG_CLEAR_HAT 0x02
+/* Texture coordinates of vertices never change after MakeParts, so can be cached once scaled */
+#define MODEL_FLAG_STATIC_UVS 0x04
 
 struct Model;
 /* Contains a set of quads and/or boxes that describe a 3D object as well as
@@ -159,6 +161,8 @@ void Model_Unregister(struct Model* model);
 /* Adds a texture to the list of automatically managed model textures. */
 /* These textures are automatically loaded from texture packs. (e.g. "skeleton.png") */
 CC_API void Model_RegisterTexture(struct ModelTex* tex);
+/* Returns the automatically managed model texture with the given name, or NULL if there is none */
+struct ModelTex* Model_GetTexture(const cc_string* name);
 
 /* Describes data for a box being built. */
 struct BoxDesc {
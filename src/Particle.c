@@ -10,11 +10,19 @@
 #include "Game.h"
 #include "Event.h"
 
-#ifdef CC_BUILD_TINYMEM
+#if defined CC_BUILD_TINYMEM
 	#define PARTICLES_MAX 10
+	#define BURST_PARTICLES_MAX 12
+#elif defined CC_BUILD_LOWMEM
+	#define PARTICLES_MAX 600
+	#define BURST_PARTICLES_MAX 600
 #else
 	#define PARTICLES_MAX 600
+	/* Breaking blocks and explosions spawn a large number of particles at once */
+	#define BURST_PARTICLES_MAX 4096
 #endif
+/* Rain, custom and smoke particles are all drawn in one batch, terrain particles in another */
+#define PARTICLES_VB_MAX (max(PARTICLES_MAX * 2 + BURST_PARTICLES_MAX, BURST_PARTICLES_MAX) * 4)
 
 
 /*########################################################################################################################*
@@ -25,6 +33,32 @@ static RNGState rnd;
 static cc_bool hitTerrain;
 typedef cc_bool (*CanPassThroughFunc)(BlockID b);
 
+/* Max number of terrain and smoke particles, which is reduced when frames take too long */
+static int particles_budget = BURST_PARTICLES_MAX;
+static float particles_frameTime;
+#define PARTICLES_TARGET_FRAME_TIME (1.0f / 60.0f)
+
+static void Particles_UpdateBudget(float delta) {
+	/* Smoothed, so a single slow frame doesn't immediately shrink the budget */
+	particles_frameTime += (delta - particles_frameTime) * 0.1f;
+	if (particles_frameTime <= PARTICLES_TARGET_FRAME_TIME) {
+		particles_budget = BURST_PARTICLES_MAX; return;
+	}
+
+	particles_budget = (int)(BURST_PARTICLES_MAX * (PARTICLES_TARGET_FRAME_TIME / particles_frameTime));
+	Math_Clamp(particles_budget, BURST_PARTICLES_MAX / 8, BURST_PARTICLES_MAX);
+}
+
+/* Returns the index to store a new particle at, replacing an existing particle when at the limit */
+/* Particles are swap removed, so the oldest particle isn't at a known index */
+/*  and hence existing particles are just replaced in round robin order instead */
+static int Particles_NextSlot(int* count, int limit, int* replaceIndex) {
+	if (*count < limit) return (*count)++;
+
+	*replaceIndex = (*replaceIndex + 1) % *count;
+	return *replaceIndex;
+}
+
 void Particle_DoRender(const Vec2* size, const Vec3* pos, const TextureRec* rec, PackedCol col, struct VertexTextured* v) {
 	struct Matrix* view;
 	float sX, sY;
@@ -132,7 +166,7 @@ static cc_bool PhysicsTick(struct Particle* p, float gravity, CanPassThroughFunc
 *-------------------------------------------------------Rain particle-----------------------------------------------------*
 *#########################################################################################################################*/
 static struct Particle rain_Particles[PARTICLES_MAX];
-static int rain_count;
+static int rain_count, rain_replace;
 static TextureRec rain_rec = { 2.0f/128.0f, 14.0f/128.0f, 5.0f/128.0f, 16.0f/128.0f };
 
 static cc_bool RainParticle_CanPass(BlockID block) {
@@ -159,28 +193,17 @@ static void RainParticle_Render(struct Particle* p, float t, struct VertexTextur
 	Particle_DoRender(&size, &pos, &rain_rec, col, vertices);
 }
 
-static void Rain_Render(float t) {
-	struct VertexTextured* data;
+static struct VertexTextured* Rain_BuildMesh(float t, struct VertexTextured* data) {
 	int i;
-	if (!rain_count) return;
-	
-	data = (struct VertexTextured*)Gfx_LockDynamicVb(particles_VB, 
-										VERTEX_FORMAT_TEXTURED, rain_count * 4);
 	for (i = 0; i < rain_count; i++) {
 		RainParticle_Render(&rain_Particles[i], t, data);
 		data += 4;
 	}
-
-	Gfx_BindTexture(particles_TexId);
-	Gfx_UnlockDynamicVb(particles_VB);
-	Gfx_DrawVb_IndexedTris(rain_count * 4);
+	return data;
 }
 
 static void Rain_RemoveAt(int i) {
-	for (; i < rain_count - 1; i++) {
-		rain_Particles[i] = rain_Particles[i + 1];
-	}
-	rain_count--;
+	rain_Particles[i] = rain_Particles[--rain_count];
 }
 
 static void Rain_Tick(float delta) {
@@ -197,8 +220,7 @@ void Particles_RainSnowEffect(float x, float y, float z) {
 	int i, type;
 
 	for (i = 0; i < 2; i++) {
-		if (rain_count == PARTICLES_MAX) Rain_RemoveAt(0);
-		p = &rain_Particles[rain_count++];
+		p = &rain_Particles[Particles_NextSlot(&rain_count, PARTICLES_MAX, &rain_replace)];
 
 		p->velocity.x = Random_Float(&rnd) * 0.8f - 0.4f; /* [-0.4, 0.4] */
 		p->velocity.z = Random_Float(&rnd) * 0.8f - 0.4f;
@@ -227,8 +249,8 @@ struct TerrainParticle {
 	BlockID block;
 };
 
-static struct TerrainParticle terrain_particles[PARTICLES_MAX];
-static int terrain_count;
+static struct TerrainParticle terrain_particles[BURST_PARTICLES_MAX] CC_BIG_VAR;
+static int terrain_count, terrain_replace;
 static cc_uint16 terrain_1DCount[ATLAS1D_MAX_ATLASES];
 static cc_uint16 terrain_1DIndices[ATLAS1D_MAX_ATLASES];
 
@@ -307,11 +329,7 @@ static void Terrain_Render(float t) {
 }
 
 static void Terrain_RemoveAt(int i) {
-	for (; i < terrain_count - 1; i++) 
-	{
-		terrain_particles[i] = terrain_particles[i + 1];
-	}
-	terrain_count--;
+	terrain_particles[i] = terrain_particles[--terrain_count];
 }
 
 static void Terrain_Tick(float delta) {
@@ -375,8 +393,7 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 				if (cell.x < minBB.x || cell.x > maxBB.x || cell.y < minBB.y
 					|| cell.y > maxBB.y || cell.z < minBB.z || cell.z > maxBB.z) continue;
 
-				if (terrain_count == PARTICLES_MAX) Terrain_RemoveAt(0);
-				p = &terrain_particles[terrain_count++];
+				p = &terrain_particles[Particles_NextSlot(&terrain_count, particles_budget, &terrain_replace)];
 
 				/* centre random offset around [-0.2, 0.2] */
 				p->base.velocity.x = CELL_CENTRE + (cellX - 0.5f) + (Random_Float(&rnd) * 0.4f - 0.2f);
@@ -418,7 +435,7 @@ struct CustomParticle {
 
 struct CustomParticleEffect Particles_CustomEffects[256];
 static struct CustomParticle custom_particles[PARTICLES_MAX];
-static int custom_count;
+static int custom_count, custom_replace;
 static cc_uint8 collideFlags;
 #define EXPIRES_UPON_TOUCHING_GROUND (1 << 0)
 #define SOLID_COLLIDES  (1 << 1)
@@ -471,28 +488,17 @@ static void CustomParticle_Render(struct CustomParticle* p, float t, struct Vert
 	Particle_DoRender(&size, &pos, &rec, col, vertices);
 }
 
-static void Custom_Render(float t) {
-	struct VertexTextured* data;
+static struct VertexTextured* Custom_BuildMesh(float t, struct VertexTextured* data) {
 	int i;
-	if (!custom_count) return;
-
-	data = (struct VertexTextured*)Gfx_LockDynamicVb(particles_VB, 
-										VERTEX_FORMAT_TEXTURED, custom_count * 4);
 	for (i = 0; i < custom_count; i++) {
 		CustomParticle_Render(&custom_particles[i], t, data);
 		data += 4;
 	}
-
-	Gfx_BindTexture(particles_TexId);
-	Gfx_UnlockDynamicVb(particles_VB);
-	Gfx_DrawVb_IndexedTris(custom_count * 4);
+	return data;
 }
 
 static void Custom_RemoveAt(int i) {
-	for (; i < custom_count - 1; i++) {
-		custom_particles[i] = custom_particles[i + 1];
-	}
-	custom_count--;
+	custom_particles[i] = custom_particles[--custom_count];
 }
 
 static void Custom_Tick(float delta) {
@@ -505,7 +511,8 @@ static void Custom_Tick(float delta) {
 }
 
 void Particles_CustomEffect(int effectID, float x, float y, float z, float originX, float originY, float originZ) {
-	struct CustomParticle* p;
+	struct CustomParticle particle;
+	struct CustomParticle* p = &particle;
 	struct CustomParticleEffect* e = &Particles_CustomEffects[effectID];
 	int i, count = e->particleCount;
 	Vec3 offset, delta, origin;
@@ -515,8 +522,6 @@ void Particles_CustomEffect(int effectID, float x, float y, float z, float origi
 
 	for (i = 0; i < count; i++) 
 	{
-		if (custom_count == PARTICLES_MAX) Custom_RemoveAt(0);
-		p = &custom_particles[custom_count++];
 		p->effectId = effectID;
 
 		offset.x = Random_Float(&rnd) - 0.5f;
@@ -549,14 +554,17 @@ void Particles_CustomEffect(int effectID, float x, float y, float z, float origi
 
 		/* Don't spawn custom particle inside a block (otherwise it appears */
 		/*   for a few frames, then disappears in first PhysicsTick call)*/
+		/* Checked before taking a slot, as when the pool is full that replaces an existing particle */
 		collideFlags = e->collideFlags;
-		if (IntersectsBlock(&p->base, CustomParticle_CanPass)) custom_count--;
+		if (IntersectsBlock(&p->base, CustomParticle_CanPass)) continue;
+
+		custom_particles[Particles_NextSlot(&custom_count, PARTICLES_MAX, &custom_replace)] = particle;
 	}
 }
 #else
 static int custom_count;
 
-static void Custom_Render(float t) { }
+static struct VertexTextured* Custom_BuildMesh(float t, struct VertexTextured* data) { return data; }
 static void Custom_Tick(float delta) { }
 #endif
 
@@ -564,80 +572,133 @@ static void Custom_Tick(float delta) { }
 /*########################################################################################################################*
 *-------------------------------------------------------Smoke particle----------------------------------------------------*
 *#########################################################################################################################*/
-#define SMOKE_PARTICLES_MAX 600
-static struct Particle smoke_Particles[SMOKE_PARTICLES_MAX];
-static int smoke_count;
+/* Smoke particles don't collide with anything, so are stored as a structure of arrays */
+/*  which allows integrating multiple particles at once with SIMD instructions */
+static struct SmokeParticles {
+	float lastX[BURST_PARTICLES_MAX], lastY[BURST_PARTICLES_MAX], lastZ[BURST_PARTICLES_MAX];
+	float nextX[BURST_PARTICLES_MAX], nextY[BURST_PARTICLES_MAX], nextZ[BURST_PARTICLES_MAX];
+	float velX[BURST_PARTICLES_MAX],  velY[BURST_PARTICLES_MAX],  velZ[BURST_PARTICLES_MAX];
+	float lifetime[BURST_PARTICLES_MAX], size[BURST_PARTICLES_MAX];
+} smoke CC_BIG_VAR;
+static int smoke_count, smoke_replace;
 /* Texture 7 in particles.png (8x8 tiles, 16 per row) = column 7, row 0 */
 static TextureRec smoke_rec = { 56.0f/128.0f, 0.0f/128.0f, 64.0f/128.0f, 8.0f/128.0f };
+/* Velocity is dampened on all axes over time */
+#define SMOKE_DAMPING 0.96f
+
+#define Smoke_Integrate1(i, next, last, vel) \
+	smoke.last[i] = smoke.next[i]; \
+	smoke.next[i] = smoke.next[i] + smoke.vel[i] * delta; \
+	smoke.vel[i]  = smoke.vel[i] * SMOKE_DAMPING;
+
+/* Integrates 4 particles at once, producing identical results to Smoke_Integrate1 */
+#if defined __SSE__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SMOKE_SIMD
+#define Smoke_Integrate4(i, next, last, vel) \
+	p = _mm_loadu_ps(&smoke.next[i]); v = _mm_loadu_ps(&smoke.vel[i]); \
+	_mm_storeu_ps(&smoke.last[i], p); \
+	_mm_storeu_ps(&smoke.next[i], _mm_add_ps(p, _mm_mul_ps(v, d))); \
+	_mm_storeu_ps(&smoke.vel[i],  _mm_mul_ps(v, damp));
+
+static int Smoke_IntegrateSIMD(float delta) {
+	__m128 d = _mm_set1_ps(delta), damp = _mm_set1_ps(SMOKE_DAMPING);
+	__m128 p, v;
+	int i;
 
-static cc_bool SmokeParticle_Tick(struct Particle* p, float delta) {
-	p->lastPos = p->nextPos;
-	p->nextPos.x += p->velocity.x * delta;
-	p->nextPos.y += p->velocity.y * delta;
-	p->nextPos.z += p->velocity.z * delta;
-	/* Dampen all axes over time */
-	p->velocity.x *= 0.96f;
-	p->velocity.y *= 0.96f;
-	p->velocity.z *= 0.96f;
-	p->lifetime -= delta;
-	return p->lifetime < 0.0f;
+	for (i = 0; i + 4 <= smoke_count; i += 4)
+	{
+		Smoke_Integrate4(i, nextX, lastX, velX);
+		Smoke_Integrate4(i, nextY, lastY, velY);
+		Smoke_Integrate4(i, nextZ, lastZ, velZ);
+		_mm_storeu_ps(&smoke.lifetime[i], _mm_sub_ps(_mm_loadu_ps(&smoke.lifetime[i]), d));
+	}
+	return i;
+}
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define SMOKE_SIMD
+#define Smoke_Integrate4(i, next, last, vel) \
+	p = vld1q_f32(&smoke.next[i]); v = vld1q_f32(&smoke.vel[i]); \
+	vst1q_f32(&smoke.last[i], p); \
+	vst1q_f32(&smoke.next[i], vaddq_f32(p, vmulq_f32(v, d))); \
+	vst1q_f32(&smoke.vel[i],  vmulq_f32(v, damp));
+
+static int Smoke_IntegrateSIMD(float delta) {
+	float32x4_t d = vdupq_n_f32(delta), damp = vdupq_n_f32(SMOKE_DAMPING);
+	float32x4_t p, v;
+	int i;
+
+	for (i = 0; i + 4 <= smoke_count; i += 4)
+	{
+		Smoke_Integrate4(i, nextX, lastX, velX);
+		Smoke_Integrate4(i, nextY, lastY, velY);
+		Smoke_Integrate4(i, nextZ, lastZ, velZ);
+		vst1q_f32(&smoke.lifetime[i], vsubq_f32(vld1q_f32(&smoke.lifetime[i]), d));
+	}
+	return i;
 }
+#endif
 
-static void SmokeParticle_Render(struct Particle* p, float t, struct VertexTextured* vertices) {
+static struct VertexTextured* Smoke_BuildMesh(float t, struct VertexTextured* data) {
 	Vec3 pos;
 	Vec2 size;
-
-	Vec3_Lerp(&pos, &p->lastPos, &p->nextPos, t);
-	size.x = p->size * 0.015625f; size.y = size.x;
-
-	Particle_DoRender(&size, &pos, &smoke_rec, PACKEDCOL_WHITE, vertices);
-}
-
-static void Smoke_Render(float t) {
-	struct VertexTextured* data;
 	int i;
-	if (!smoke_count) return;
 
-	data = (struct VertexTextured*)Gfx_LockDynamicVb(particles_VB, 
-									VERTEX_FORMAT_TEXTURED, smoke_count * 4);
-	for (i = 0; i < smoke_count; i++) {
-		SmokeParticle_Render(&smoke_Particles[i], t, data);
+	for (i = 0; i < smoke_count; i++) 
+	{
+		pos.x  = smoke.lastX[i] + (smoke.nextX[i] - smoke.lastX[i]) * t;
+		pos.y  = smoke.lastY[i] + (smoke.nextY[i] - smoke.lastY[i]) * t;
+		pos.z  = smoke.lastZ[i] + (smoke.nextZ[i] - smoke.lastZ[i]) * t;
+		size.x = smoke.size[i] * 0.015625f; size.y = size.x;
+
+		Particle_DoRender(&size, &pos, &smoke_rec, PACKEDCOL_WHITE, data);
 		data += 4;
 	}
-
-	Gfx_BindTexture(particles_TexId);
-	Gfx_UnlockDynamicVb(particles_VB);
-	Gfx_DrawVb_IndexedTris(smoke_count * 4);
+	return data;
 }
 
 static void Smoke_RemoveAt(int i) {
-	for (; i < smoke_count - 1; i++) {
-		smoke_Particles[i] = smoke_Particles[i + 1];
-	}
-	smoke_count--;
+	int last = --smoke_count;
+	smoke.lastX[i] = smoke.lastX[last]; smoke.lastY[i] = smoke.lastY[last]; smoke.lastZ[i] = smoke.lastZ[last];
+	smoke.nextX[i] = smoke.nextX[last]; smoke.nextY[i] = smoke.nextY[last]; smoke.nextZ[i] = smoke.nextZ[last];
+	smoke.velX[i]  = smoke.velX[last];  smoke.velY[i]  = smoke.velY[last];  smoke.velZ[i]  = smoke.velZ[last];
+
+	smoke.lifetime[i] = smoke.lifetime[last];
+	smoke.size[i]     = smoke.size[last];
 }
 
 static void Smoke_Tick(float delta) {
-	int i;
-	for (i = 0; i < smoke_count; i++) {
-		if (SmokeParticle_Tick(&smoke_Particles[i], delta)) {
-			Smoke_RemoveAt(i); i--;
-		}
+	int i = 0;
+#ifdef SMOKE_SIMD
+	i = Smoke_IntegrateSIMD(delta);
+#endif
+
+	for (; i < smoke_count; i++)
+	{
+		Smoke_Integrate1(i, nextX, lastX, velX);
+		Smoke_Integrate1(i, nextY, lastY, velY);
+		Smoke_Integrate1(i, nextZ, lastZ, velZ);
+		smoke.lifetime[i] -= delta;
+	}
+
+	/* Removal is done separately, so integration always works on consecutive particles */
+	for (i = 0; i < smoke_count; i++)
+	{
+		if (smoke.lifetime[i] < 0.0f) { Smoke_RemoveAt(i); i--; }
 	}
 }
 
 void Particles_SmokeEffect(float x, float y, float z, float radius) {
-	struct Particle* p;
-	int i, count;
+	int i, j, count;
 	float dx, dy, dz, dist, speed;
 
 	/* Spawn particles throughout the explosion sphere */
 	count = (int)(radius * radius * 24); /* scale count with explosion size */
-	if (count > 400) count = 400;
+	if (count > 1024) count = 1024;
 
 	for (i = 0; i < count; i++) {
-		if (smoke_count >= SMOKE_PARTICLES_MAX) Smoke_RemoveAt(0);
-		p = &smoke_Particles[smoke_count++];
+		j = Particles_NextSlot(&smoke_count, particles_budget, &smoke_replace);
 
 		/* Random position within the explosion sphere */
 		dx = (Random_Float(&rnd) - 0.5f) * 2.0f;
@@ -649,19 +710,21 @@ void Particles_SmokeEffect(float x, float y, float z, float radius) {
 		}
 		dist = Random_Float(&rnd) * radius;
 
-		p->lastPos.x = x + dx * dist;
-		p->lastPos.y = y + dy * dist;
-		p->lastPos.z = z + dz * dist;
-		p->nextPos = p->lastPos;
+		smoke.lastX[j] = x + dx * dist;
+		smoke.lastY[j] = y + dy * dist;
+		smoke.lastZ[j] = z + dz * dist;
+		smoke.nextX[j] = smoke.lastX[j];
+		smoke.nextY[j] = smoke.lastY[j];
+		smoke.nextZ[j] = smoke.lastZ[j];
 
 		/* Fast outward burst from explosion center */
 		speed = 2.0f + Random_Float(&rnd) * 3.0f;
-		p->velocity.x = dx * speed;
-		p->velocity.y = dy * speed;
-		p->velocity.z = dz * speed;
+		smoke.velX[j] = dx * speed;
+		smoke.velY[j] = dy * speed;
+		smoke.velZ[j] = dz * speed;
 
-		p->lifetime = 0.8f + Random_Float(&rnd) * 0.7f; /* 0.8-1.5 seconds */
-		p->size = 10.0f + Random_Float(&rnd) * 14.0f; /* varied sizes */
+		smoke.lifetime[j] = 0.8f + Random_Float(&rnd) * 0.7f; /* 0.8-1.5 seconds */
+		smoke.size[j]     = 10.0f + Random_Float(&rnd) * 14.0f; /* varied sizes */
 	}
 }
 
@@ -669,20 +732,36 @@ void Particles_SmokeEffect(float x, float y, float z, float radius) {
 /*########################################################################################################################*
 *--------------------------------------------------------Particles--------------------------------------------------------*
 *#########################################################################################################################*/
-void Particles_Render(float t) {
+/* Rain, custom and smoke particles all use particles.png, so can be drawn together */
+static void Particles_RenderBatch(float t) {
+	struct VertexTextured* data;
+	int count = rain_count + custom_count + smoke_count;
+	if (!count) return;
+
+	data = (struct VertexTextured*)Gfx_LockDynamicVb(particles_VB,
+										VERTEX_FORMAT_TEXTURED, count * 4);
+	data = Rain_BuildMesh(t,   data);
+	data = Custom_BuildMesh(t, data);
+	data = Smoke_BuildMesh(t,  data);
+
+	Gfx_BindTexture(particles_TexId);
+	Gfx_UnlockDynamicVb(particles_VB);
+	Gfx_DrawVb_IndexedTris(count * 4);
+}
+
+void Particles_Render(float delta, float t) {
+	Particles_UpdateBudget(delta);
 	if (!terrain_count && !rain_count && !custom_count && !smoke_count) return;
 
 	if (Gfx.LostContext) return;
 	if (!particles_VB)
-		particles_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, PARTICLES_MAX * 4);
+		particles_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, PARTICLES_VB_MAX);
 
 	Gfx_SetAlphaTest(true);
 
 	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
 	Terrain_Render(t);
-	Rain_Render(t);
-	Custom_Render(t);
-	Smoke_Render(t);
+	Particles_RenderBatch(t);
 
 	Gfx_SetAlphaTest(false);
 }
@@ -717,7 +796,7 @@ static void OnBreakBlockEffect_Handler(void* obj, IVec3 coords, BlockID old, Blo
 }
 
 static void OnInit(void) {
-	ScheduledTask_Add(GAME_DEF_TICKS, Particles_Tick);
+	ScheduledTask_AddNamed(GAME_DEF_TICKS, Particles_Tick, "Particles_Tick");
 	Random_SeedFromCurrentTime(&rnd);
 	TextureEntry_Register(&particles_entry);
 
@@ -41,7 +41,9 @@ extern struct CustomParticleEffect Particles_CustomEffects[256];
 
 /* http://www.opengl-tutorial.org/intermediate-tutorials/billboards-particles/billboards/ */
 void Particle_DoRender(const Vec2* size, const Vec3* pos, const TextureRec* rec, PackedCol col, struct VertexTextured* vertices);
-void Particles_Render(float t);
+/* Renders all particles, interpolated between their last and next tick positions */
+/* NOTE: delta is used to scale down the particle budget when frames take too long */
+void Particles_Render(float delta, float t);
 void Particles_BreakBlockEffect(IVec3 coords, BlockID oldBlock, BlockID block);
 void Particles_RainSnowEffect(float x, float y, float z);
 void Particles_CustomEffect(int effectID, float x, float y, float z, float originX, float originY, float originZ);
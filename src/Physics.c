@@ -149,17 +149,40 @@ static void Searcher_QuickSort(int left, int right) {
 	}
 }
 
+static struct SearcherState* Searcher_TryAdd(struct SearcherState* curState, Vec3* vel, struct AABB* entityBB, 
+											struct AABB* entityExtentBB, int x, int y, int z) {
+	BlockID block = World_GetPhysicsBlock(x, y, z);
+	struct AABB blockBB;
+	float xx, yy, zz, tx, ty, tz;
+	if (Blocks.Collide[block] != COLLIDE_SOLID) return curState;
+
+	xx = (float)x; yy = (float)y; zz = (float)z;
+	blockBB.Min = Blocks.MinBB[block];
+	blockBB.Min.x += xx; blockBB.Min.y += yy; blockBB.Min.z += zz;
+	blockBB.Max = Blocks.MaxBB[block];
+	blockBB.Max.x += xx; blockBB.Max.y += yy; blockBB.Max.z += zz;
+
+	if (!AABB_Intersects(entityExtentBB, &blockBB)) return curState; /* necessary for non whole blocks. (slabs) */
+	Searcher_CalcTime(vel, entityBB, &blockBB, &tx, &ty, &tz);
+	if (tx > 1.0f || ty > 1.0f || tz > 1.0f) return curState;
+
+	curState->x = (x << 3) | (block  & 0x007);
+	curState->y = (y << 4) | ((block & 0x078) >> 3);
+	curState->z = (z << 3) | ((block & 0x380) >> 7);
+	curState->tSquared = tx * tx + ty * ty + tz * tz;
+	return curState + 1;
+}
+
 int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, struct AABB* entityExtentBB) {
 	Vec3 vel = entity->Velocity;
 	IVec3 min, max;
 	cc_uint32 elements;
 	struct SearcherState* curState;
-	int count;
-
-	BlockID block;
-	struct AABB blockBB;
-	float xx, yy, zz, tx, ty, tz;
-	int x, y, z;
+	const cc_uint32* solid;
+	const cc_uint32* row;
+	cc_uint32 bits;
+	int count, inMinX, inMaxX;
+	int x, y, z, w;
 
 	Entity_GetBounds(entity, entityBB);
 	/* Exact maximum extent the entity can reach, and the equivalent map coordinates. */
@@ -181,29 +204,43 @@ int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, s
 		Searcher_States  = (struct SearcherState*)Mem_Alloc(elements, sizeof(struct SearcherState), "collision search states");
 	}
 	curState = Searcher_States;
+	solid    = World_GetSolidBits();
+
+	/* Part of each row inside the map, where the solid bitset can be used to skip non solid blocks */
+	inMinX = max(min.x, 0);
+	inMaxX = min(max.x, World.MaxX);
 
 	/* Order loops so that we minimise cache misses */
 	for (y = min.y; y <= max.y; y++) {
 		for (z = min.z; z <= max.z; z++) {
-			for (x = min.x; x <= max.x; x++) {
-				block = World_GetPhysicsBlock(x, y, z);
-				if (Blocks.Collide[block] != COLLIDE_SOLID) continue;
-
-				xx = (float)x; yy = (float)y; zz = (float)z;
-				blockBB.Min = Blocks.MinBB[block];
-				blockBB.Min.x += xx; blockBB.Min.y += yy; blockBB.Min.z += zz;
-				blockBB.Max = Blocks.MaxBB[block];
-				blockBB.Max.x += xx; blockBB.Max.y += yy; blockBB.Max.z += zz;
-
-				if (!AABB_Intersects(entityExtentBB, &blockBB)) continue; /* necessary for non whole blocks. (slabs) */
-				Searcher_CalcTime(&vel, entityBB, &blockBB, &tx, &ty, &tz);
-				if (tx > 1.0f || ty > 1.0f || tz > 1.0f) continue;
-
-				curState->x = (x << 3) | (block  & 0x007);
-				curState->y = (y << 4) | ((block & 0x078) >> 3);
-				curState->z = (z << 3) | ((block & 0x380) >> 7);
-				curState->tSquared = tx * tx + ty * ty + tz * tz;
-				curState++;
+			if (!solid || y < 0 || z < 0 || z >= World.Length || inMinX > inMaxX) {
+				for (x = min.x; x <= max.x; x++) {
+					curState = Searcher_TryAdd(curState, &vel, entityBB, entityExtentBB, x, y, z);
+				}
+				continue;
+			}
+
+			/* Outside the map is bedrock */
+			for (x = min.x; x < inMinX; x++) {
+				curState = Searcher_TryAdd(curState, &vel, entityBB, entityExtentBB, x, y, z);
+			}
+
+			/* Above the map is air */
+			row = solid + (y * World.Length + z) * World_SolidStride;
+			for (w = inMinX >> 5; y < World.Height && w <= inMaxX >> 5; w++) {
+				bits = row[w];
+				/* Mask out blocks outside the searched range */
+				if (w == inMinX >> 5) bits &= ~0u << (inMinX & 31);
+				if (w == inMaxX >> 5) bits &= ~0u >> (31 - (inMaxX & 31));
+
+				for (x = w << 5; bits; x++, bits >>= 1) {
+					if (!(bits & 1)) continue;
+					curState = Searcher_TryAdd(curState, &vel, entityBB, entityExtentBB, x, y, z);
+				}
+			}
+
+			for (x = inMaxX + 1; x <= max.x; x++) {
+				curState = Searcher_TryAdd(curState, &vel, entityBB, entityExtentBB, x, y, z);
 			}
 		}
 	}
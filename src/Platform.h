@@ -318,6 +318,8 @@ CC_API void Thread_Detach(void* handle);
 /* Blocks the current thread, until the given thread has finished. */
 /* NOTE: This cannot be used on a thread that has been detached. */
 CC_API void Thread_Join(void* handle);
+/* Returns the number of logical CPU cores available. (1 if unknown) */
+int Thread_CoreCount(void);
 
 
 /*########################################################################################################################*
@@ -347,6 +349,45 @@ CC_API void  Waitable_Wait(void* handle);
 /* Blocks the calling thread until the waitable gets signalled, or milliseconds delay passes. */
 CC_API void  Waitable_WaitFor(void* handle, cc_uint32 milliseconds);
 
+
+/*########################################################################################################################*
+*-----------------------------------------------------------Jobs----------------------------------------------------------*
+*#########################################################################################################################*/
+/* Small tasks run on a pool of worker threads (one per extra core), which steal queued jobs from each other */
+/* On cooperatively threaded or single core systems, jobs just run immediately on the calling thread */
+struct JobCounter;
+typedef void (*Job_Func)(void* arg);
+typedef void (*Job_RangeFunc)(void* arg, int beg, int end);
+
+struct JobEntry { Job_Func func; void* arg; struct JobCounter* counter; };
+#define JOB_MAX_CONTINUATIONS 4
+/* Tracks a group of jobs, and jobs that can only run once they have all completed */
+/* NOTE: Must be zero initialised before first use */
+struct JobCounter {
+	volatile int pending;
+	int waiters; /* Bitmask of threads blocked in Jobs_Wait on this counter */
+	int numContinuations;
+	struct JobEntry continuations[JOB_MAX_CONTINUATIONS];
+};
+
+/* Starts the worker threads jobs are run on */
+/* NOTE: Must be called from the main thread, before any other threads use jobs */
+/*  (until then, jobs are just run right away on the calling thread) */
+void Jobs_Init(void);
+/* Returns number of worker threads jobs are run on (0 if jobs always run on the calling thread) */
+int  Jobs_WorkerCount(void);
+/* Queues func(arg) to be run on a worker thread. */
+/* If counter is non NULL, it is incremented now and decremented once func has run */
+void Jobs_Submit(Job_Func func, void* arg, struct JobCounter* counter);
+/* Queues func(arg) to be run only after all jobs tracked by 'after' have completed */
+void Jobs_SubmitAfter(struct JobCounter* after, Job_Func func, void* arg, struct JobCounter* counter);
+/* Blocks until all jobs tracked by the counter have completed, running its still queued jobs in the meantime */
+/* NOTE: Never runs unrelated jobs, so waiting on a short job isn't held up by running some other long job */
+void Jobs_Wait(struct JobCounter* counter);
+/* Calls func over the range 0 to count, split into batches of at least minBatch indices */
+/* Batches run in parallel on the workers and calling thread. Returns once all have completed */
+void Jobs_ParallelFor(int count, int minBatch, Job_RangeFunc func, void* arg);
+
 /* Calls SysFonts_Register on each font that is available on this platform. */
 void Platform_LoadSysFonts(void);
 
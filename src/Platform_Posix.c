@@ -54,6 +54,7 @@ cc_uint8 Platform_Flags = PLAT_FLAG_SINGLE_PROCESS;
 cc_uint8 Platform_Flags;
 #endif
 cc_bool  Platform_ReadonlyFilesystem;
+#define OVERRIDE_CORE_COUNT_FUNC
 #include "_PlatformBase.h"
 
 /* Operating system specific include files */
@@ -484,6 +485,15 @@ void Thread_Join(void* handle) {
 	Mem_Free(ptr);
 }
 
+int Thread_CoreCount(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int)count : 1;
+#else
+	return 1;
+#endif
+}
+
 void* Mutex_Create(const char* name) {
 	pthread_mutex_t* ptr = (pthread_mutex_t*)Mem_Alloc(1, sizeof(pthread_mutex_t), "mutex");
 	int res = pthread_mutex_init(ptr, NULL);
@@ -8,6 +8,7 @@
 #include "Utils.h"
 #include "Errors.h"
 #define OVERRIDE_MEM_FUNCTIONS
+#define OVERRIDE_CORE_COUNT_FUNC
 
 #define WIN32_LEAN_AND_MEAN
 #define NOSERVICE
@@ -461,6 +462,12 @@ void Thread_Join(void* handle) {
 #endif
 }
 
+int Thread_CoreCount(void) {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors ? (int)info.dwNumberOfProcessors : 1;
+}
+
 
 /*########################################################################################################################*
 *-----------------------------------------------------Synchronisation-----------------------------------------------------*
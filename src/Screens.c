@@ -89,7 +89,7 @@ static struct HUDScreen {
 
 static void HUDScreen_RemakeLine1(struct HUDScreen* s) {
 	cc_string status; char statusBuffer[STRING_SIZE * 2];
-	int indices, ping, fps;
+	int indices, ping, fps, lag;
 	float real_fps;
 
 	String_InitArray(status, statusBuffer);
@@ -117,9 +117,13 @@ static void HUDScreen_RemakeLine1(struct HUDScreen* s) {
 
 		indices = ICOUNT(Game_Vertices);
 		String_Format1(&status, "%i vertices", &indices);
+		String_Format1(&status, ", %i draws", &Game_DrawCalls);
 
 		ping = Ping_AveragePingMS();
 		if (ping) String_Format1(&status, ", ping %i ms", &ping);
+
+		lag = (int)(Game.SimulationLag * 1000);
+		if (lag) String_Format1(&status, ", lag %i ms", &lag);
 	}
 	TextWidget_Set(&s->line1, &status, &s->font);
 	s->dirty = true;
@@ -329,9 +333,10 @@ static void HUDScreen_UpdateFPS(struct HUDScreen* s, float delta) {
 	if (s->accumulator < 1.0f) return;
 
 	HUDScreen_RemakeLine1(s);
-	s->accumulator    = 0.0f;
-	s->frames         = 0;
-	Game.ChunkUpdates = 0;
+	s->accumulator     = 0.0f;
+	s->frames          = 0;
+	Game.ChunkUpdates  = 0;
+	Game.SimulationLag = 0;
 }
 
 static void HUDScreen_Update(void* screen, float delta) {
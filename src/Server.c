@@ -201,11 +201,16 @@ static void SPConnection_SendBlock(int x, int y, int z, BlockID old, BlockID now
 static void SPConnection_SendData(const cc_uint8* data, cc_uint32 len) { }
 
 static void SPConnection_Tick(struct ScheduledTask* task) {
+	cc_uint64 beg;
 	if (Server.Disconnected) return;
 	/* 60 -> 20 ticks a second */
 	if ((ticks++ % 3) != 0)  return;
 	
+	beg = Benchmark_Begin();
+	Profiler_Begin("Physics_Tick");
 	Physics_Tick();
+	Profiler_End();
+	Benchmark_End(BENCH_PHYSICS_TICK, beg);
 	TexturePack_CheckPending();
 }
 
@@ -415,6 +420,7 @@ static void MPConnection_Tick(struct ScheduledTask* task) {
 		readEnd        = net_readCurrent + read;
 		net_lastPacket = Game.Time;
 
+		Profiler_Begin("Net_Dispatch");
 		while (readCur < readEnd) {
 			cc_uint8 opcode = readCur[0];
 
@@ -428,12 +434,13 @@ static void MPConnection_Tick(struct ScheduledTask* task) {
 
 			if (readCur + Protocol.Sizes[opcode] > readEnd) break;
 			handler = Protocol.Handlers[opcode];
-			if (!handler) { DisconnectInvalidOpcode(opcode); return; }
+			if (!handler) { Profiler_End(); DisconnectInvalidOpcode(opcode); return; }
 
 			lastOpcode = opcode;
 			handler(readCur + 1); /* skip opcode */
 			readCur += Protocol.Sizes[opcode];
 		}
+		Profiler_End();
 
 		/* Protocol packets might be split up across TCP packets */
 		/* If so, copy last few unprocessed bytes back to beginning of buffer */
@@ -523,7 +530,7 @@ static void OnInit(void) {
 		MPConnection_Init();
 	}
 
-	ScheduledTask_Add(GAME_NET_TICKS, Server.Tick);
+	ScheduledTask_AddNamed(GAME_NET_TICKS, Server.Tick, "Server_Tick");
 	String_AppendConst(&Server.AppName, GAME_APP_NAME);
 	String_AppendConst(&Server.AppName, Platform_AppNameSuffix);
 
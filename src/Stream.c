@@ -300,6 +300,27 @@ void Stream_ReadonlyMemory(struct Stream* s, void* data, cc_uint32 len) {
 	s->meta.mem.base   = (cc_uint8*)data;
 }
 
+static cc_result Stream_MemoryWrite(struct Stream* s, const cc_uint8* data, cc_uint32 count, cc_uint32* modified) {
+	count = min(count, s->meta.mem.left);
+	Mem_Copy(s->meta.mem.cur, data, count);
+	
+	s->meta.mem.cur  += count; 
+	s->meta.mem.left -= count;
+	*modified = count;
+	return 0;
+}
+
+void Stream_WriteonlyMemory(struct Stream* s, void* data, cc_uint32 len) {
+	Stream_Init(s);
+	s->Write    = Stream_MemoryWrite;
+	s->Position = Stream_MemoryPosition;
+
+	s->meta.mem.cur    = (cc_uint8*)data;
+	s->meta.mem.left   = len;
+	s->meta.mem.length = len;
+	s->meta.mem.base   = (cc_uint8*)data;
+}
+
 
 /*########################################################################################################################*
 *----------------------------------------------------BufferedStream-------------------------------------------------------*
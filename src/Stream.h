@@ -33,7 +33,7 @@ struct Stream {
 	union {
 		cc_file file;
 		void* inflate;
-		struct { cc_uint8* cur; cc_uint32 left, length; cc_uint8* base; } mem;
+		struct { cc_uint8* cur; cc_uint32 left, length; cc_uint8* base; void* decoded; } mem;
 		struct { struct Stream* source; cc_uint32 left, length; } portion;
 		struct { cc_uint8* cur; cc_uint32 left, length; cc_uint8* base; struct Stream* source; cc_uint32 end; } buffered;
 		struct { struct Stream* source; cc_uint32 crc32; } crc32;
@@ -72,6 +72,9 @@ CC_API void Stream_FromFile(struct Stream* s, cc_file file);
 CC_API void Stream_ReadonlyPortion(struct Stream* s, struct Stream* source, cc_uint32 len);
 /* Wraps a block of memory, allowing reading from and seeking in the block. */
 CC_API void Stream_ReadonlyMemory(struct Stream* s, void* data, cc_uint32 len);
+/* Wraps a block of memory, allowing writing up to 'len' bytes into the block. */
+/* NOTE: Use Position to get number of bytes written so far */
+void Stream_WriteonlyMemory(struct Stream* s, void* data, cc_uint32 len);
 /* Wraps another Stream, reading through an intermediary buffer. (Useful for files, since each read call is expensive) */
 CC_API void Stream_ReadonlyBuffered(struct Stream* s, struct Stream* source, void* data, cc_uint32 size);
 
@@ -80,9 +80,10 @@ TextureRec Atlas1D_TexRec(TextureLoc texLoc, int uCount, int* index) {
 }
 
 
-static void Atlas1D_Load(int index, struct Bitmap* atlas1D) {
-	int tileSize      = Atlas2D.TileSize;
-	int tilesPerAtlas = Atlas1D.TilesPerAtlas;
+static void Atlas1D_Load(struct _Atlas2DData* src, struct _Atlas1DData* dst, 
+						int index, struct Bitmap* atlas1D) {
+	int tileSize      = src->TileSize;
+	int tilesPerAtlas = dst->TilesPerAtlas;
 	int y, tile = index * tilesPerAtlas;
 	int atlasX, atlasY;
 	
@@ -92,9 +93,9 @@ static void Atlas1D_Load(int index, struct Bitmap* atlas1D) {
 		atlasY = Atlas2D_TileY(tile) * tileSize;
 
 		Bitmap_UNSAFE_CopyBlock(atlasX, atlasY, 0, y * tileSize,
-							&Atlas2D.Bmp, atlas1D, tileSize);
+							&src->Bmp, atlas1D, tileSize);
 	}
-	Gfx_RecreateTexture(&Atlas1D.TexIds[index], atlas1D, TEXTURE_FLAG_MANAGED | TEXTURE_FLAG_DYNAMIC, Gfx.Mipmaps);
+	Gfx_RecreateTexture(&dst->TexIds[index], atlas1D, TEXTURE_FLAG_MANAGED | TEXTURE_FLAG_DYNAMIC, Gfx.Mipmaps);
 }
 
 /* TODO: always do this? */
@@ -107,7 +108,7 @@ static void Atlas1D_LoadBlock(int index) {
 	Platform_Log2("Lazy load atlas #%i (%i per bmp)", &index, &tilesPerAtlas);
 	Bitmap_Allocate(&atlas1D, tileSize, tilesPerAtlas * tileSize);
 	
-	Atlas1D_Load(index, &atlas1D);
+	Atlas1D_Load(&Atlas2D, &Atlas1D, index, &atlas1D);
 	Mem_Free(atlas1D.scan0);
 }
 
@@ -139,43 +140,46 @@ static void Atlas_Convert2DTo1D(void) {
 	
 	for (i = 0; i < atlasesCount; i++) 
 	{
-		Atlas1D_Load(i, &atlas1D);
+		Atlas1D_Load(&Atlas2D, &Atlas1D, i, &atlas1D);
 	}
 	Mem_Free(atlas1D.scan0);
 }
 #endif
 
-static void Atlas_Update1D(void) {
+static void Atlas_Update1D(const struct _Atlas2DData* src, struct _Atlas1DData* dst) {
 	int maxAtlasHeight, maxTilesPerAtlas, maxTiles;
 	int maxTexHeight = Gfx.MaxTexHeight;
 
 	/* E.g. a graphics backend may support textures up to 256 x 256 */
 	/*   dimension wise, but only have enough storage for 16 x 256 */
 	if (Gfx.MaxTexSize) {
-		int maxCurHeight = Gfx.MaxTexSize / Atlas2D.TileSize;
+		int maxCurHeight = Gfx.MaxTexSize / src->TileSize;
 		maxTexHeight     = min(maxTexHeight, maxCurHeight);
 	}
 
 	maxAtlasHeight   = min(4096, maxTexHeight);
-	maxTilesPerAtlas = maxAtlasHeight / Atlas2D.TileSize;
-	maxTiles         = Atlas2D.RowsCount * ATLAS2D_TILES_PER_ROW;
+	maxTilesPerAtlas = maxAtlasHeight / src->TileSize;
+	maxTiles         = src->RowsCount * ATLAS2D_TILES_PER_ROW;
+
+	dst->TilesPerAtlas = min(maxTilesPerAtlas, maxTiles);
+	dst->Count = Math_CeilDiv(maxTiles, dst->TilesPerAtlas);
 
-	Atlas1D.TilesPerAtlas = min(maxTilesPerAtlas, maxTiles);
-	Atlas1D.Count = Math_CeilDiv(maxTiles, Atlas1D.TilesPerAtlas);
+	dst->InvTileSize = 1.0f / dst->TilesPerAtlas;
+	dst->Mask  = dst->TilesPerAtlas - 1;
+	dst->Shift = Math_ilog2(dst->TilesPerAtlas);
+}
 
-	Atlas1D.InvTileSize = 1.0f / Atlas1D.TilesPerAtlas;
-	Atlas1D.Mask  = Atlas1D.TilesPerAtlas - 1;
-	Atlas1D.Shift = Math_ilog2(Atlas1D.TilesPerAtlas);
+static void Atlas2D_Init(struct _Atlas2DData* dst, struct Bitmap* bmp) {
+	dst->Bmp       = *bmp;
+	dst->TileSize  = bmp->width  / ATLAS2D_TILES_PER_ROW;
+	dst->RowsCount = bmp->height / dst->TileSize;
+	dst->RowsCount = min(dst->RowsCount, ATLAS2D_MAX_ROWS_COUNT);
 }
 
 /* Loads the given atlas and converts it into an array of 1D atlases. */
 static void Atlas_Update(struct Bitmap* bmp) {
-	Atlas2D.Bmp       = *bmp;
-	Atlas2D.TileSize  = bmp->width  / ATLAS2D_TILES_PER_ROW;
-	Atlas2D.RowsCount = bmp->height / Atlas2D.TileSize;
-	Atlas2D.RowsCount = min(Atlas2D.RowsCount, ATLAS2D_MAX_ROWS_COUNT);
-
-	Atlas_Update1D();
+	Atlas2D_Init(&Atlas2D, bmp);
+	Atlas_Update1D(&Atlas2D, &Atlas1D);
 	Atlas_Convert2DTo1D();
 }
 
@@ -207,7 +211,8 @@ static void Atlas1D_Free(void) {
 	}
 }
 
-cc_bool Atlas_TryChange(struct Bitmap* atlas) {
+/* Checks whether the given bitmap can be used as the terrain atlas, showing why in chat if not */
+static cc_bool Atlas_Validate(struct Bitmap* atlas) {
 	static const cc_string terrain = String_FromConst("terrain.png");
 	int tileSize;
 
@@ -243,6 +248,11 @@ cc_bool Atlas_TryChange(struct Bitmap* atlas) {
 		Chat_Add4("&c terrain.png size is (%i,%i), your GPU supports (%i,%i) at most.", 
 			&atlas->width, &atlas->height, &Gfx.MaxTexWidth, &Gfx.MaxTexHeight);
 	}
+	return true;
+}
+
+cc_bool Atlas_TryChange(struct Bitmap* atlas) {
+	if (!Atlas_Validate(atlas)) return false;
 
 	if (Gfx.LostContext) return false;
 	Atlas1D_Free();
@@ -254,6 +264,82 @@ cc_bool Atlas_TryChange(struct Bitmap* atlas) {
 }
 
 
+/*########################################################################################################################*
+*-------------------------------------------------------Next atlas--------------------------------------------------------*
+*#########################################################################################################################*/
+/* When switching texture packs, the new terrain atlas is uploaded a few 1D atlases at a time, */
+/*  while the current atlas is still used for rendering until all of the new 1D atlases are ready */
+static struct _Atlas2DData next2D;
+static struct _Atlas1DData next1D;
+static int nextUploaded;
+static struct Bitmap nextScratch;
+/* Maximum time spent uploading 1D atlases per call to AtlasNext_Upload (in microseconds) */
+#define ATLAS_UPLOAD_BUDGET 4000
+
+static void AtlasNext_Free(void) {
+	int i;
+	for (i = 0; i < next1D.Count; i++) {
+		Gfx_DeleteTexture(&next1D.TexIds[i]);
+	}
+	Mem_Free(next2D.Bmp.scan0);
+	Mem_Free(nextScratch.scan0);
+
+	next2D.Bmp.scan0  = NULL;
+	nextScratch.scan0 = NULL;
+	next1D.Count = 0;
+	nextUploaded = 0;
+}
+
+/* Starts uploading the given validated bitmap as the next terrain atlas */
+/* NOTE: Takes ownership of the bitmap's pixels */
+static void AtlasNext_Begin(struct Bitmap* bmp) {
+	AtlasNext_Free();
+	Atlas2D_Init(&next2D, bmp);
+	Atlas_Update1D(&next2D, &next1D);
+#ifndef CC_BUILD_LOWMEM
+	Bitmap_Allocate(&nextScratch, next2D.TileSize, next1D.TilesPerAtlas * next2D.TileSize);
+#endif
+}
+
+/* Uploads some (or all) of the remaining 1D atlases, returning whether all have been uploaded */
+static cc_bool AtlasNext_Upload(cc_bool all) {
+#ifndef CC_BUILD_LOWMEM
+	cc_uint64 beg = Stopwatch_Measure();
+
+	while (nextUploaded < next1D.Count) 
+	{
+		Atlas1D_Load(&next2D, &next1D, nextUploaded++, &nextScratch);
+		if (all) continue;
+		if (Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure()) >= ATLAS_UPLOAD_BUDGET) return false;
+	}
+#endif
+	/* In low memory builds, 1D atlases are instead lazily loaded when first bound */
+	return true;
+}
+
+/* Replaces the current terrain atlas with the fully uploaded next atlas */
+static void AtlasNext_Commit(void) {
+	int tilesPerAtlas = next1D.TilesPerAtlas;
+	int atlasesCount  = next1D.Count;
+
+	Atlas1D_Free();
+	Atlas2D_Free();
+	Atlas2D = next2D;
+	Atlas1D = next1D;
+
+	/* Texture IDs are now owned by Atlas1D */
+	Mem_Set(next1D.TexIds, 0, sizeof(next1D.TexIds));
+	next2D.Bmp.scan0 = NULL;
+	next1D.Count     = 0;
+	nextUploaded     = 0;
+	Mem_Free(nextScratch.scan0);
+	nextScratch.scan0 = NULL;
+
+	Platform_Log2("Loaded terrain atlas: %i bmps, %i per bmp", &atlasesCount, &tilesPerAtlas);
+	Event_RaiseVoid(&TextureEvents.AtlasChanged);
+}
+
+
 /*########################################################################################################################*
 *------------------------------------------------------TextureUrls--------------------------------------------------------*
 *#########################################################################################################################*/
@@ -479,6 +565,271 @@ static void UpdateCache(struct HttpRequest* req) { }
 #endif
 
 
+/*########################################################################################################################*
+*---------------------------------------------------TexturePack loader----------------------------------------------------*
+*#########################################################################################################################*/
+/* Texture packs are read and their .png files decoded by background jobs. Once everything has been */
+/*  decoded and the new terrain atlas has been uploaded, all of the files are applied at once */
+struct PackFile {
+	struct PackFile* next;
+	cc_uint8* data;
+	cc_uint32 size;
+	/* Decoded image, if the file is a .png that was successfully decoded */
+	struct Bitmap bmp;
+	cc_result res;
+	cc_bool isTerrain;
+	cc_string name; char _nameBuffer[FILENAME_SIZE];
+};
+
+struct PackSource {
+	struct PackSource* next;
+	struct Stream stream;
+	/* Memory the stream reads from, which is freed once the stream has been read */
+	void* data;
+	struct PackFile* filesHead;
+	struct PackFile* filesTail;
+	cc_result res;
+	cc_bool isArchive;
+	cc_string path; char _pathBuffer[URL_MAX_SIZE];
+};
+
+/* Sources queued by ExtractFrom, which are only loaded once PackLoad_Start is called */
+static struct PackSource* queuedHead;
+static struct PackSource* queuedTail;
+/* Sources of the texture pack currently being loaded */
+static struct PackSource* sourcesHead;
+static struct PackSource* sourcesTail;
+static struct PackSource* readingSource;
+
+static struct JobCounter packJobs;
+static struct PackFile* packTerrain;
+static cc_bool packUploading, packApplying;
+
+static struct PackFile* PackSource_AddFile(struct PackSource* src, const cc_string* name, cc_uint32 size) {
+	static const cc_string terrain = String_FromConst("terrain.png");
+	struct PackFile* file = (struct PackFile*)Mem_TryAllocCleared(1, sizeof(struct PackFile));
+	if (!file) return NULL;
+
+	if (size) {
+		file->data = (cc_uint8*)Mem_TryAlloc(size, 1);
+		if (!file->data) { Mem_Free(file); return NULL; }
+	}
+	file->size = size;
+	String_InitArray(file->name, file->_nameBuffer);
+	String_Copy(&file->name, name);
+	file->isTerrain = String_CaselessEquals(name, &terrain);
+
+	LinkedList_Append(file, src->filesHead, src->filesTail);
+	return file;
+}
+
+static void PackFile_Decode(void* arg) {
+	struct PackFile* file = (struct PackFile*)arg;
+	struct Stream mem;
+	Stream_ReadonlyMemory(&mem, file->data, file->size);
+
+	file->res = Png_Decode(&file->bmp, &mem);
+	if (!file->res) return;
+
+	Mem_Free(file->bmp.scan0);
+	file->bmp.scan0 = NULL;
+}
+
+static cc_bool SelectZipEntry(const cc_string* path) { return true; }
+static cc_result ProcessZipEntry(const cc_string* path, struct Stream* stream, struct ZipEntry* source) {
+	static const cc_string png = String_FromConst(".png");
+	struct PackFile* file;
+	cc_string name = *path;
+	cc_result res;
+
+	Utils_UNSAFE_GetFilename(&name);
+	if (!source->UncompressedSize) return 0;
+
+	file = PackSource_AddFile(readingSource, &name, source->UncompressedSize);
+	if (!file) return ERR_OUT_OF_MEMORY;
+	if ((res = Stream_Read(stream, file->data, file->size))) return res;
+
+	if (!String_CaselessEnds(&name, &png)) return 0;
+#ifdef CC_BUILD_LOWMEM
+	/* Avoid keeping every image in the texture pack decoded in memory at once */
+	if (!file->isTerrain) return 0;
+#endif
+	Jobs_Submit(PackFile_Decode, file, &packJobs);
+	return 0;
+}
+
+static cc_result PackSource_Read(struct PackSource* src, struct ZipEntry* entries) {
+	static const cc_string terrain = String_FromConst("terrain.png");
+	struct PackFile* file;
+	struct Bitmap bmp;
+	cc_result res;
+
+	res = Png_Decode(&bmp, &src->stream);
+	if (res == PNG_ERR_INVALID_SIG) {
+		/* file isn't a .png image, probably a .zip archive then */
+		src->isArchive = true;
+		if (!entries) return ERR_OUT_OF_MEMORY;
+		return Zip_Extract(&src->stream, SelectZipEntry, ProcessZipEntry, entries, 512);
+	}
+
+	if (!res && (file = PackSource_AddFile(src, &terrain, 0))) {
+		file->bmp = bmp;
+		return 0;
+	}
+	Mem_Free(bmp.scan0);
+	return res ? res : ERR_OUT_OF_MEMORY;
+}
+
+/* Reads all the files from each source, queueing up .png files to be decoded by other jobs */
+static void PackSources_Read(void* arg) {
+	struct ZipEntry* entries = (struct ZipEntry*)Mem_TryAllocCleared(512, sizeof(struct ZipEntry));
+	struct PackSource* src;
+
+	for (src = sourcesHead; src; src = src->next) 
+	{
+		readingSource = src;
+		src->res = PackSource_Read(src, entries);
+
+		/* No point logging error for closing readonly file */
+		(void)src->stream.Close(&src->stream);
+		Mem_Free(src->data);
+		src->data = NULL;
+	}
+	readingSource = NULL;
+	Mem_Free(entries);
+}
+
+static void PackSources_Free(struct PackSource* src) {
+	struct PackSource* nextSrc;
+	struct PackFile* file;
+	struct PackFile* nextFile;
+
+	for (; src; src = nextSrc) 
+	{
+		for (file = src->filesHead; file; file = nextFile) 
+		{
+			nextFile = file->next;
+			Mem_Free(file->data);
+			Mem_Free(file->bmp.scan0);
+			Mem_Free(file);
+		}
+
+		nextSrc = src->next;
+		Mem_Free(src);
+	}
+}
+
+/* Cancels the texture pack currently being loaded (if any) */
+static void PackLoad_Free(void) {
+	Jobs_Wait(&packJobs);
+	PackSources_Free(sourcesHead);
+
+	sourcesHead   = NULL;
+	sourcesTail   = NULL;
+	packTerrain   = NULL;
+	packUploading = false;
+	AtlasNext_Free();
+}
+
+/* Picks the last terrain.png that can be used, as that is the one that would end up being used */
+static void PackLoad_BeginAtlas(void) {
+	struct PackSource* src;
+	struct PackFile* file;
+	struct PackFile* best;
+
+	for (;;) {
+		best = NULL;
+		for (src = sourcesHead; src; src = src->next) 
+		{
+			for (file = src->filesHead; file; file = file->next) 
+			{
+				if (file->isTerrain && file->bmp.scan0) best = file;
+			}
+		}
+		if (!best) return;
+		if (Atlas_Validate(&best->bmp)) break;
+
+		Mem_Free(best->bmp.scan0);
+		best->bmp.scan0 = NULL;
+	}
+
+	AtlasNext_Begin(&best->bmp);
+	best->bmp.scan0 = NULL;
+	packTerrain     = best;
+}
+
+static void PackFile_Apply(struct PackFile* file) {
+	struct Stream mem;
+	Png_DecodedStream(&mem, file->data, file->size, &file->bmp);
+
+	if (file->isTerrain) {
+		/* The terrain atlas is instead changed by the loader itself (see PackLoad_BeginAtlas) */
+		if (file->res) Logger_SysWarn2(file->res, "decoding", &file->name);
+		Mem_Free(file->bmp.scan0);
+		file->bmp.scan0 = NULL;
+	}
+
+	Event_RaiseEntry(&TextureEvents.FileChanged, &mem, &file->name);
+}
+
+static void PackLoad_Apply(void) {
+	struct PackSource* src;
+	struct PackFile* file;
+	packApplying = true;
+
+	for (src = sourcesHead; src; src = src->next) 
+	{
+		Event_RaiseVoid(&TextureEvents.PackChanged);
+
+		for (file = src->filesHead; file; file = file->next) 
+		{
+			if (file == packTerrain) AtlasNext_Commit();
+			if (src->isArchive) PackFile_Apply(file);
+		}
+
+		if (!src->res) continue;
+		Logger_SysWarn2(src->res, src->isArchive ? "extracting" : "decoding", &src->path);
+	}
+	packApplying = false;
+}
+
+/* Advances loading the current texture pack, or finishes loading it if finish is true */
+static void PackLoad_Step(cc_bool finish) {
+	if (!sourcesHead) return;
+
+	if (finish) {
+		Jobs_Wait(&packJobs);
+	} else if (packJobs.pending || Gfx.LostContext) {
+		return;
+	}
+
+	if (!packUploading) {
+		PackLoad_BeginAtlas();
+		packUploading = true;
+	}
+	if (!AtlasNext_Upload(finish)) return;
+
+	PackLoad_Apply();
+	PackLoad_Free();
+	/* Use fallback terrain texture with 1 pixel per tile */
+	if (!Atlas2D.Bmp.scan0) LoadFallbackAtlas();
+}
+
+/* Starts loading the queued texture pack sources, replacing any texture pack still being loaded */
+static void PackLoad_Start(cc_bool async) {
+	if (!queuedHead) return;
+	PackLoad_Free();
+
+	sourcesHead = queuedHead;
+	sourcesTail = queuedTail;
+	queuedHead  = NULL;
+	queuedTail  = NULL;
+
+	Jobs_Submit(PackSources_Read, NULL, &packJobs);
+	if (!async) PackLoad_Step(true);
+}
+
+
 /*########################################################################################################################*
 *-------------------------------------------------------TexturePack-------------------------------------------------------*
 *#########################################################################################################################*/
@@ -520,66 +871,37 @@ cc_result TexturePack_ExtractDefault(DefaultZipCallback callback, const char** d
 }
 
 
-static cc_bool SelectZipEntry(const cc_string* path) { return true; }
-static cc_result ProcessZipEntry(const cc_string* path, struct Stream* stream, struct ZipEntry* source) {
-	cc_string name = *path;
-	Utils_UNSAFE_GetFilename(&name);
-	Event_RaiseEntry(&TextureEvents.FileChanged, stream, &name);
-	return 0;
-}
-
-static cc_result ExtractPng(struct Stream* stream) {
-	struct Bitmap bmp;
-	cc_result res = Png_Decode(&bmp, stream);
-	if (!res && Atlas_TryChange(&bmp)) return 0;
-
-	Mem_Free(bmp.scan0);
-	return res;
-}
-
 static cc_bool needReload;
-static cc_result ExtractFrom(struct Stream* stream, const cc_string* path) {
-#if CC_BUILD_MAXSTACK <= (32 * 1024)
-	struct ZipEntry* entries = (struct ZipEntry*)Mem_TryAllocCleared(512, sizeof(struct ZipEntry));
-#else
-	struct ZipEntry entries[512];
-#endif
-	cc_result res;
-#if CC_BUILD_MAXSTACK <= (32 * 1024)
-	if (!entries) return ERR_OUT_OF_MEMORY;
-#endif
+/* Queues the texture pack in the given stream to be loaded, taking ownership of the stream */
+/* data is the memory the stream reads from (if any), and is freed once no longer needed */
+static cc_result ExtractFrom(struct Stream* stream, const cc_string* path, void* data) {
+	struct PackSource* src;
 
-	Event_RaiseVoid(&TextureEvents.PackChanged);
 	/* If context is lost, then trying to load textures will just fail */
 	/* So defer loading the texture pack until context is restored */
 	if (Gfx.LostContext) {
+		Event_RaiseVoid(&TextureEvents.PackChanged);
 		needReload = true;
-		res = 0;
-		goto ret;
+		(void)stream->Close(stream);
+		Mem_Free(data);
+		return 0;
 	}
 	needReload = false;
 
-	res = ExtractPng(stream);
-	if (res == PNG_ERR_INVALID_SIG) {
-		/* file isn't a .png image, probably a .zip archive then */
+	src = (struct PackSource*)Mem_TryAllocCleared(1, sizeof(struct PackSource));
+	if (!src) {
+		(void)stream->Close(stream);
+		Mem_Free(data);
+		return ERR_OUT_OF_MEMORY;
+	}
 
-#if CC_BUILD_MAXSTACK <= (32 * 1024)
-		res = Zip_Extract(stream, SelectZipEntry, ProcessZipEntry,
-							entries, 512);
-#else
-		res = Zip_Extract(stream, SelectZipEntry, ProcessZipEntry,
-							entries, Array_Elems(entries));
-#endif
+	src->stream = *stream;
+	src->data   = data;
+	String_InitArray(src->path, src->_pathBuffer);
+	String_Copy(&src->path, path);
 
-		if (res) Logger_SysWarn2(res, "extracting", path);
-	} else if (res) {
-		Logger_SysWarn2(res, "decoding", path);
-	}
-	ret:
-#if CC_BUILD_MAXSTACK <= (32 * 1024)
-	Mem_Free(entries);
-#endif
-	return res;
+	LinkedList_Append(src, queuedHead, queuedTail);
+	return 0;
 }
 
 #if defined CC_BUILD_PS1 || defined CC_BUILD_SATURN
@@ -590,7 +912,7 @@ static cc_result ExtractFromFile(const cc_string* path) {
 	struct Stream stream;
 	Stream_ReadonlyMemory(&stream, ccTextures, ccTextures_length);
 
-	return ExtractFrom(&stream, path);
+	return ExtractFrom(&stream, path, NULL);
 }
 #elif !defined CC_BUILD_FILESYSTEM
 /* E.g. GBA/32X don't support textures at all */
@@ -607,10 +929,7 @@ static cc_result ExtractFromFile(const cc_string* path) {
 	res = Stream_OpenPath(&stream, &raw_path);
 	if (res) { Logger_IOWarn2(res, "opening", &raw_path); return res; }
 
-	res = ExtractFrom(&stream, path);
-	/* No point logging error for closing readonly file */
-	(void)stream.Close(&stream);
-	return res;
+	return ExtractFrom(&stream, path, NULL);
 }
 #endif
 
@@ -638,7 +957,7 @@ static cc_result ExtractUserTextures(void) {
 }
 
 static cc_bool usingDefault;
-cc_result TexturePack_ExtractCurrent(cc_bool forceReload) {
+static cc_result ExtractCurrent(cc_bool forceReload, cc_bool async) {
 	cc_string url = TexturePack_Url;
 	struct Stream stream;
 	cc_result res = 0;
@@ -650,18 +969,24 @@ cc_result TexturePack_ExtractCurrent(cc_bool forceReload) {
 	}
 
 	if (url.length && OpenCachedData(&url, &stream)) {
-		res = ExtractFrom(&stream, &url);
+		res = ExtractFrom(&stream, &url, NULL);
 		usingDefault = false;
-
-		/* No point logging error for closing readonly file */
-		(void)stream.Close(&stream);
 	}
+	PackLoad_Start(async);
 
 	/* Use fallback terrain texture with 1 pixel per tile */
 	if (!Atlas2D.Bmp.scan0) LoadFallbackAtlas();
 	return res;
 }
 
+cc_result TexturePack_ExtractCurrent(cc_bool forceReload) {
+	return ExtractCurrent(forceReload, false);
+}
+
+cc_result TexturePack_ExtractCurrentAsync(cc_bool forceReload) {
+	return ExtractCurrent(forceReload, true);
+}
+
 /* Extracts and updates cache for the downloaded texture pack */
 static void ApplyDownloaded(struct HttpRequest* item) {
 	struct Stream mem;
@@ -672,11 +997,20 @@ static void ApplyDownloaded(struct HttpRequest* item) {
 	/* Took too long to download and is no longer active texture pack */
 	if (!String_Equals(&TexturePack_Url, &url)) return;
 
+	/* Loader takes ownership of the downloaded data */
 	Stream_ReadonlyMemory(&mem, item->data, item->size);
-	ExtractFrom(&mem, &url);
+	ExtractFrom(&mem, &url, item->data);
+	item->data = NULL;
+	item->size = 0;
+
+	PackLoad_Start(true);
 	usingDefault = false;
 }
 
+void TexturePack_Update(void) {
+	PackLoad_Step(false);
+}
+
 void TexturePack_CheckPending(void) {
 	struct HttpRequest item;
 	if (!Http_GetResult(TexturePack_ReqID, &item)) return;
@@ -720,7 +1054,7 @@ void TexturePack_Extract(const cc_string* url) {
 
 	if (String_Equals(url, &TexturePack_Url)) return;
 	String_Copy(&TexturePack_Url, url);
-	TexturePack_ExtractCurrent(false);
+	TexturePack_ExtractCurrentAsync(false);
 }
 
 static struct TextureEntry* entries_head;
@@ -736,7 +1070,11 @@ void TextureEntry_Register(struct TextureEntry* entry) {
 *#########################################################################################################################*/
 static void TerrainPngProcess(struct Stream* stream, const cc_string* name) {
 	struct Bitmap bmp;
-	cc_result res = Png_Decode(&bmp, stream);
+	cc_result res;
+	/* Texture pack loader changes the terrain atlas itself */
+	if (packApplying) return;
+
+	res = Png_Decode(&bmp, stream);
 
 	if (res) {
 		Logger_SysWarn2(res, "decoding", name);
@@ -760,7 +1098,10 @@ static void OnFileChanged(void* obj, struct Stream* stream, const cc_string* nam
 }
 
 static void OnContextLost(void* obj) {
-	if (!Gfx.ManagedTextures) Atlas1D_Free();
+	if (Gfx.ManagedTextures) return;
+	Atlas1D_Free();
+	/* Texture pack gets reloaded anyways once context is recreated */
+	PackLoad_Free();
 }
 
 static void OnContextRecreated(void* obj) {
@@ -795,11 +1136,12 @@ static void OnInit(void) {
 static void OnReset(void) {
 	if (!TexturePack_Url.length) return;
 	TexturePack_Url.length = 0;
-	TexturePack_ExtractCurrent(false);
+	TexturePack_ExtractCurrentAsync(false);
 }
 
 static void OnFree(void) {
 	OnContextLost(NULL);
+	PackLoad_Free();
 	Atlas2D_Free();
 	TexturePack_Url.length = 0;
 	entries_head = NULL;
@@ -99,6 +99,12 @@ void TexturePack_SetDefault(const cc_string* texPack);
 /* If TexturePack_Url is empty, extracts user's default texture pack. */
 /* Otherwise extracts the cached texture pack for that URL. */
 cc_result TexturePack_ExtractCurrent(cc_bool forceReload);
+/* Same as TexturePack_ExtractCurrent, except that the textures are decoded in the background */
+/*  and applied over the next few ticks (until then, the current textures are still used) */
+cc_result TexturePack_ExtractCurrentAsync(cc_bool forceReload);
+/* Advances loading of the texture pack being applied in the background. */
+/* NOTE: Called every frame, so that loading isn't limited by the tick rate */
+void TexturePack_Update(void);
 /* Checks if the texture pack currently being downloaded has completed. */
 /* If completed, then applies the downloaded texture pack and updates cache */
 void TexturePack_CheckPending(void);
@@ -1076,6 +1076,7 @@ void imdct_init(struct imdct_state* state, int n) {
 	log2_n   = Math_ilog2(n);
 	reversed = state->reversed;
 	state->n = n; state->log2_n = log2_n;
+	state->useSIMD = imdct_useSIMD;
 
 	/* setup twiddle factors */
 	for (k = 0, k2 = 0; k < n4; k++, k2 += 2) 
@@ -1097,6 +1098,95 @@ void imdct_init(struct imdct_state* state, int n) {
 	}
 }
 
+/* One stage of step 3, reading butterfly inputs from w and writing the outputs to u */
+static void imdct_stage(const float* w, float* u, const float* A, int n, int l) {
+	int n2 = n >> 1, k0 = n >> (l+3), k1 = 1 << (l+3);
+	int r, r2, rMax = n >> (l+4), s2, s2Max = 1 << (l+2);
+	float e_1, e_2, f_1, f_2;
+
+	for (r = 0, r2 = 0; r < rMax; r++, r2 += 2) 
+	{
+		for (s2 = 0; s2 < s2Max; s2 += 2) 
+		{
+			e_1 = w[n2-1-k0*s2-r2];     
+			e_2 = w[n2-2-k0*s2-r2];
+			f_1 = w[n2-1-k0*(s2+1)-r2]; 
+			f_2 = w[n2-2-k0*(s2+1)-r2];
+
+			u[n2-1-k0*s2-r2]     = e_1 + f_1;
+			u[n2-2-k0*s2-r2]     = e_2 + f_2;
+			u[n2-1-k0*(s2+1)-r2] = (e_1 - f_1) * A[r*k1] - (e_2 - f_2) * A[r*k1+1];
+			u[n2-2-k0*(s2+1)-r2] = (e_2 - f_2) * A[r*k1] + (e_1 - f_1) * A[r*k1+1];
+		}
+	}
+}
+
+#if defined __SSE__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define IMDCT_SIMD_STAGE
+/* Processes two adjacent butterflies (r and r+1) at once. Produces identical results to imdct_stage */
+static void imdct_stage_simd(const float* w, float* u, const float* A, int n, int l) {
+	int n2 = n >> 1, k0 = n >> (l+3), k1 = 1 << (l+3);
+	int r, p, rMax = n >> (l+4), s2, s2Max = 1 << (l+2);
+	__m128 sign = _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f);
+	__m128 e, f, d, ds, a0, a1;
+
+	for (s2 = 0; s2 < s2Max; s2 += 2) 
+	{
+		for (r = 0; r < rMax; r += 2) 
+		{
+			/* p..p+3 holds e_2 and e_1 of r+1, then e_2 and e_1 of r */
+			p = n2-4-k0*s2-r*2;
+			e = _mm_loadu_ps(w + p);
+			f = _mm_loadu_ps(w + p - k0);
+			_mm_storeu_ps(u + p, _mm_add_ps(e, f));
+
+			d  = _mm_sub_ps(e, f);
+			ds = _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1));
+			a0 = _mm_setr_ps(A[(r+1)*k1],   A[(r+1)*k1],   A[r*k1],   A[r*k1]);
+			a1 = _mm_setr_ps(A[(r+1)*k1+1], A[(r+1)*k1+1], A[r*k1+1], A[r*k1+1]);
+			_mm_storeu_ps(u + p - k0, _mm_add_ps(_mm_mul_ps(d, a0), _mm_mul_ps(_mm_mul_ps(ds, a1), sign)));
+		}
+	}
+}
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define IMDCT_SIMD_STAGE
+/* Processes two adjacent butterflies (r and r+1) at once. Produces identical results to imdct_stage */
+static void imdct_stage_simd(const float* w, float* u, const float* A, int n, int l) {
+	static const float signs[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+	int n2 = n >> 1, k0 = n >> (l+3), k1 = 1 << (l+3);
+	int r, p, rMax = n >> (l+4), s2, s2Max = 1 << (l+2);
+	float32x4_t sign = vld1q_f32(signs);
+	float32x4_t e, f, d, ds, a0, a1;
+	float tw[4];
+
+	for (s2 = 0; s2 < s2Max; s2 += 2) 
+	{
+		for (r = 0; r < rMax; r += 2) 
+		{
+			/* p..p+3 holds e_2 and e_1 of r+1, then e_2 and e_1 of r */
+			p = n2-4-k0*s2-r*2;
+			e = vld1q_f32(w + p);
+			f = vld1q_f32(w + p - k0);
+			vst1q_f32(u + p, vaddq_f32(e, f));
+
+			d  = vsubq_f32(e, f);
+			ds = vrev64q_f32(d);
+			tw[0] = tw[1] = A[(r+1)*k1];   tw[2] = tw[3] = A[r*k1];   a0 = vld1q_f32(tw);
+			tw[0] = tw[1] = A[(r+1)*k1+1]; tw[2] = tw[3] = A[r*k1+1]; a1 = vld1q_f32(tw);
+			vst1q_f32(u + p - k0, vaddq_f32(vmulq_f32(d, a0), vmulq_f32(vmulq_f32(ds, a1), sign)));
+		}
+	}
+}
+#endif
+
+#ifdef IMDCT_SIMD_STAGE
+cc_bool imdct_useSIMD = true;
+#else
+cc_bool imdct_useSIMD = false;
+#endif
+
 void imdct_calc(float* in, float* out, struct imdct_state* state) {
 	int k, k2, k4, n = state->n;
 	int n2 = n >> 1, n4 = n >> 2, n8 = n >> 3, n3_4 = n - n4;
@@ -1107,8 +1197,9 @@ void imdct_calc(float* in, float* out, struct imdct_state* state) {
 	/* Uses a few fixes for the paper noted at http://www.nothings.org/stb_vorbis/mdct_01.txt */
 	float *A = state->a, *B = state->b, *C = state->c;
 
-	float u[VORBIS_MAX_BLOCK_SIZE / 2];
+	float u_buf[VORBIS_MAX_BLOCK_SIZE / 2];
 	float w[VORBIS_MAX_BLOCK_SIZE / 2];
+	float *u = u_buf, *src, *dst;
 	float e_1, e_2, f_1, f_2;
 	float g_1, g_2, h_1, h_2;
 	float x_1, x_2, y_1, y_2;
@@ -1133,34 +1224,23 @@ void imdct_calc(float* in, float* out, struct imdct_state* state) {
 	}
 
 	/* step 3 */
+	/* each stage writes every element, so ping-pong between w and u instead of copying back */
 	log2_n = state->log2_n;
+	src = w; dst = u;
 	for (l = 0; l <= log2_n - 4; l++) 
 	{
-		int k0 = n >> (l+3), k1 = 1 << (l+3);
-		int r, r2, rMax = n >> (l+4), s2, s2Max = 1 << (l+2);
-
-		for (r = 0, r2 = 0; r < rMax; r++, r2 += 2) 
+#ifdef IMDCT_SIMD_STAGE
+		/* SIMD version needs an even number of butterflies */
+		if (state->useSIMD && (n >> (l+4)) >= 2) {
+			imdct_stage_simd(src, dst, A, n, l);
+		} else
+#endif
 		{
-			for (s2 = 0; s2 < s2Max; s2 += 2) 
-			{
-				e_1 = w[n2-1-k0*s2-r2];     
-				e_2 = w[n2-2-k0*s2-r2];
-				f_1 = w[n2-1-k0*(s2+1)-r2]; 
-				f_2 = w[n2-2-k0*(s2+1)-r2];
-
-				u[n2-1-k0*s2-r2]     = e_1 + f_1;
-				u[n2-2-k0*s2-r2]     = e_2 + f_2;
-				u[n2-1-k0*(s2+1)-r2] = (e_1 - f_1) * A[r*k1] - (e_2 - f_2) * A[r*k1+1];
-				u[n2-2-k0*(s2+1)-r2] = (e_2 - f_2) * A[r*k1] + (e_1 - f_1) * A[r*k1+1];
-			}
-		}
-
-		/* TODO: eliminate this, do w/u in-place */
-		/* TODO: dynamically allocate mem for imdct */
-		if (l+1 <= log2_n - 4) {
-			Mem_Copy(w, u, n2 * sizeof(float));
+			imdct_stage(src, dst, A, n, l);
 		}
+		u = dst; dst = src; src = u;
 	}
+	u = src;
 
 	/* step 4, step 5, step 6, step 7, step 8, output */
 	reversed = state->reversed;
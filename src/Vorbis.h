@@ -27,12 +27,20 @@ struct Codebook; struct Floor; struct Residue; struct Mapping; struct Mode;
 
 struct imdct_state {
 	int n, log2_n;
+	cc_bool useSIMD; /* Defaults to imdct_useSIMD */
 	float a[VORBIS_MAX_BLOCK_SIZE / 2];
 	float b[VORBIS_MAX_BLOCK_SIZE / 2];
 	float c[VORBIS_MAX_BLOCK_SIZE / 4];
 	cc_uint32 reversed[VORBIS_MAX_BLOCK_SIZE / 8];
 };
 
+/* Precalculates the twiddle factors for an inverse MDCT of the given size */
+void imdct_init(struct imdct_state* state, int n);
+/* Calculates the inverse MDCT of n/2 spectral coefficients into n output samples */
+void imdct_calc(float* in, float* out, struct imdct_state* state);
+/* Whether imdct_init sets up states to use SSE/NEON instructions. (always false if unsupported) */
+extern cc_bool imdct_useSIMD;
+
 struct VorbisWindow { float* Prev; float* Cur; };
 struct VorbisState {
 	cc_uint32 Bits;    /* Holds bits across byte boundaries*/
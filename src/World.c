@@ -37,7 +37,10 @@ static void GenerateNewUuid(void) {
 	World.Uuid[8] |= 0x80; /* variant 2*/
 }
 
+static void SolidBits_Free(void);
+
 void World_Reset(void) {
+	SolidBits_Free();
 #ifdef EXTENDED_BLOCKS
 	if (World.Blocks != World.Blocks2) Mem_Free(World.Blocks2);
 	World.Blocks2 = NULL;
@@ -63,6 +66,7 @@ void World_SetNewMap(BlockRaw* blocks, int width, int height, int length) {
 	/* TODO: TEMP HACK */
 	if (!blocks) { width = 0; height = 0; length = 0; }
 
+	SolidBits_Free();
 	World_SetDimensions(width, height, length);
 	World.Blocks      = blocks;
 	World.Name.length = 0;
@@ -113,6 +117,73 @@ void World_OutOfMemory(void) {
 }
 
 
+/*########################################################################################################################*
+*-----------------------------------------------------Solid occupancy-----------------------------------------------------*
+*#########################################################################################################################*/
+static cc_uint32* solidBits;
+static cc_bool solidDirty = true;
+/* Whether allocating the bitset failed, so it isn't retried until the next map */
+static cc_bool solidFailed;
+int World_SolidStride;
+
+static void SolidBits_Free(void) {
+	Mem_Free(solidBits);
+	solidBits   = NULL;
+	solidDirty  = true;
+	solidFailed = false;
+}
+
+static void SolidBits_Rebuild(void) {
+	cc_uint32* row;
+	int x, y, z, i = 0;
+	World_SolidStride = (World.Width + 31) >> 5;
+
+	if (!solidBits) {
+		solidBits = (cc_uint32*)Mem_TryAllocCleared(World_SolidStride * World.Height * World.Length, 4);
+		if (!solidBits) { solidFailed = true; return; }
+	} else {
+		Mem_Set(solidBits, 0, World_SolidStride * World.Height * World.Length * 4);
+	}
+
+	for (y = 0; y < World.Height; y++) {
+		for (z = 0; z < World.Length; z++) {
+			row = solidBits + (y * World.Length + z) * World_SolidStride;
+
+			for (x = 0; x < World.Width; x++, i++) {
+				if (Blocks.Collide[World_GetRawBlock(i)] != COLLIDE_SOLID) continue;
+				row[x >> 5] |= 1u << (x & 31);
+			}
+		}
+	}
+	solidDirty = false;
+}
+
+const cc_uint32* World_GetSolidBits(void) {
+	if (!World.Blocks || solidFailed) return NULL;
+	if (solidDirty) SolidBits_Rebuild();
+	return solidBits;
+}
+
+cc_bool World_IsSolidBlock(int x, int y, int z) {
+	if (!World.Blocks) return false;
+	return Blocks.Collide[World_GetBlock(x, y, z)] == COLLIDE_SOLID;
+}
+
+static void SolidBits_Update(int x, int y, int z, BlockID block) {
+	cc_uint32* word;
+	if (solidDirty) return;
+
+	word = solidBits + (y * World.Length + z) * World_SolidStride + (x >> 5);
+	if (Blocks.Collide[block] == COLLIDE_SOLID) {
+		*word |=  (1u << (x & 31));
+	} else {
+		*word &= ~(1u << (x & 31));
+	}
+}
+
+static void SolidBits_BlockDefChanged(void* obj) { solidDirty = true; }
+
+
 #ifdef EXTENDED_BLOCKS
 static CC_NOINLINE void LazyInitUpper(int i, BlockID block) {
 	BlockRaw* data = (BlockRaw*)Mem_TryAllocCleared(World.Volume, 1);
@@ -125,6 +196,7 @@ static CC_NOINLINE void LazyInitUpper(int i, BlockID block) {
 void World_SetBlock(int x, int y, int z, BlockID block) {
 	int i = World_Pack(x, y, z);
 	World.Blocks[i] = (BlockRaw)block;
+	SolidBits_Update(x, y, z, block);
 
 	/* defer allocation of second map array if possible */
 	if (World.Blocks == World.Blocks2) {
@@ -137,6 +209,7 @@ void World_SetBlock(int x, int y, int z, BlockID block) {
 #else
 void World_SetBlock(int x, int y, int z, BlockID block) {
 	World.Blocks[World_Pack(x, y, z)] = block; 
+	SolidBits_Update(x, y, z, block);
 }
 #endif
 
@@ -326,7 +399,12 @@ Vec3 Respawn_FindSpawnPosition(float x, float z, Vec3 modelSize) {
 	return spawn;
 }
 
+static void OnInit(void) {
+	World_Reset();
+	Event_Register_(&BlockEvents.BlockDefChanged, NULL, SolidBits_BlockDefChanged);
+}
+
 struct IGameComponent World_Component = {
-	World_Reset, /* Init  */
+	OnInit,      /* Init  */
 	World_Reset  /* Free  */
 };
@@ -103,6 +103,16 @@ void World_SetBlock(int x, int y, int z, BlockID block);
 /* Otherwise returns the block at the given coordinates. */
 BlockID World_SafeGetBlock(int x, int y, int z);
 
+/* Number of 32 bit words per X row of the solid occupancy bitset */
+extern int World_SolidStride;
+/* Returns a bitset of whether each block in the map has COLLIDE_SOLID collision */
+/*  Bit x & 31 of word ((y * World.Length + z) * World_SolidStride + (x >> 5)) is for block x,y,z */
+/*  NOTE: Rebuilt on demand after new maps or block definition changes */
+/*  NOTE: Returns NULL if no map, or if the bitset could not be allocated for the current map */
+const cc_uint32* World_GetSolidBits(void);
+/* Looks up whether the block has COLLIDE_SOLID collision directly, for when there is no solid bitset */
+cc_bool World_IsSolidBlock(int x, int y, int z);
+
 /* Whether the given coordinates lie inside the map. */
 static CC_INLINE cc_bool World_Contains(int x, int y, int z) {
 	return (unsigned)x < (unsigned)World.Width
@@ -115,6 +125,14 @@ static CC_INLINE cc_bool World_ContainsXZ(int x, int z) {
 		&& (unsigned)z < (unsigned)World.Length;
 }
 
+/* Whether the block at the given coordinates has COLLIDE_SOLID collision */
+/* NOTE: Does NOT check that the coordinates are inside the map. */
+static CC_INLINE cc_bool World_IsSolid(int x, int y, int z) {
+	const cc_uint32* bits = World_GetSolidBits();
+	if (!bits) return World_IsSolidBlock(x, y, z);
+	return (bits[(y * World.Length + z) * World_SolidStride + (x >> 5)] >> (x & 31)) & 1;
+}
+
 static CC_INLINE cc_bool World_CheckVolume(int width, int height, int length) {
 	cc_uint64 volume = (cc_uint64)width * height * length;
 	return volume <= Int32_MaxValue;
@@ -15,7 +15,7 @@ struct _GfxData Gfx;
 static GfxResourceID Gfx_quadVb, Gfx_texVb;
 const cc_string Gfx_LowPerfMessage = String_FromConst("&eRunning in reduced performance mode (game minimised or hidden)");
 
-static const int strideSizes[] = { SIZEOF_VERTEX_COLOURED, SIZEOF_VERTEX_TEXTURED };
+static const int strideSizes[] = { SIZEOF_VERTEX_COLOURED, SIZEOF_VERTEX_TEXTURED, SIZEOF_VERTEX_CHUNK };
 /* Whether mipmaps must be created for all dimensions down to 1x1 or not */
 static cc_bool customMipmapsLevels;
 
@@ -527,6 +527,18 @@ void Gfx_DeleteDynamicVb(GfxResourceID* vb) { Gfx_DeleteVb(vb); }
 #endif
 
 
+#ifndef CC_GFX_NATIVE_MULTIDRAW
+void Gfx_DrawIndexedTris_T2fC4b_Multi(int count, const int* verticesCounts, const int* startVertices) {
+	int i;
+	for (i = 0; i < count; i++)
+	{
+		Gfx_DrawIndexedTris_T2fC4b(verticesCounts[i], startVertices[i]);
+	}
+	Game_DrawCalls += count;
+}
+#endif
+
+
 /*########################################################################################################################*
 *----------------------------------------------------Graphics component---------------------------------------------------*
 *#########################################################################################################################*/
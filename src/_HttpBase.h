@@ -408,7 +408,7 @@ static void Http_InitCommon(void) {
 	httpsVerify = Options_GetBool(OPT_HTTPS_VERIFY, true);
 
 	Options_Get(OPT_SKIN_SERVER, &skinServer, SKINS_SERVER);
-	ScheduledTask_Add(30, Http_CleanCacheTask);
+	ScheduledTask_AddNamed(30, Http_CleanCacheTask, "Http_CleanCacheTask");
 }
 static void Http_Init(void);
 
@@ -546,3 +546,362 @@ void Waitable_Wait(void* handle) {
 void Waitable_WaitFor(void* handle, cc_uint32 milliseconds) {
 }
 #endif
+
+#ifndef OVERRIDE_CORE_COUNT_FUNC
+int Thread_CoreCount(void) { return 1; }
+#endif
+
+
+/*########################################################################################################################*
+*-----------------------------------------------------------Jobs----------------------------------------------------------*
+*#########################################################################################################################*/
+#define JOBS_MAX_WORKERS 15
+#define JOBS_QUEUE_SIZE  512
+#define JOBS_MAX_BATCHES 64
+#define JOBS_MAX_WAITERS 16
+
+struct JobRange { Job_RangeFunc func; void* arg; int beg, end; };
+static void Jobs_RunRange(void* arg) {
+	struct JobRange* range = (struct JobRange*)arg;
+	range->func(range->arg, range->beg, range->end);
+}
+
+#if defined CC_BUILD_COOPTHREADED || defined CC_NO_THREADING
+/* No real threads to run jobs on, so just run them right away */
+void Jobs_Init(void) { }
+int  Jobs_WorkerCount(void) { return 0; }
+
+void Jobs_Submit(Job_Func func, void* arg, struct JobCounter* counter) {
+	func(arg);
+}
+
+void Jobs_SubmitAfter(struct JobCounter* after, Job_Func func, void* arg, struct JobCounter* counter) {
+	func(arg);
+}
+
+void Jobs_Wait(struct JobCounter* counter) { }
+
+void Jobs_ParallelFor(int count, int minBatch, Job_RangeFunc func, void* arg) {
+	if (count > 0) func(arg, 0, count);
+}
+#else
+/* Each worker owns a queue, which it runs jobs from newest first (better for cache locality) */
+/* Idle workers steal the oldest jobs from the other queues, which tend to be the largest pieces of work */
+/* Queue 0 is owned by whichever threads submit jobs from outside of the pool (e.g. main thread) */
+struct JobQueue {
+	void* lock;
+	int head, count;
+	struct JobEntry entries[JOBS_QUEUE_SIZE];
+};
+
+static struct JobQueue* job_queues;
+static void* job_wakeups[JOBS_MAX_WORKERS];
+static cc_bool job_sleeping[JOBS_MAX_WORKERS];
+static int job_numWorkers, job_startedWorkers, job_nextQueue;
+static cc_bool job_inited;
+static void* job_stateLock;  /* Protects counters, sleeping workers and waiters */
+/* Threads blocked in Jobs_Wait each borrow one of these, which is signalled when their counter reaches 0 */
+static void* job_waiters[JOBS_MAX_WAITERS];
+static int job_usedWaiters;
+
+static void Jobs_WorkerMain(void);
+void Jobs_Init(void) {
+	void* thread;
+	int i, count;
+	if (job_inited) return;
+	job_inited = true;
+
+	count = min(Thread_CoreCount() - 1, JOBS_MAX_WORKERS);
+	if (count <= 0) return;
+
+	job_queues = (struct JobQueue*)Mem_TryAllocCleared(count + 1, sizeof(struct JobQueue));
+	if (!job_queues) return;
+	job_numWorkers = count;
+
+	for (i = 0; i <= job_numWorkers; i++) {
+		job_queues[i].lock = Mutex_Create("Job queue");
+	}
+	job_stateLock = Mutex_Create("Jobs state");
+	for (i = 0; i < JOBS_MAX_WAITERS; i++) {
+		job_waiters[i] = Waitable_Create("Jobs waiter");
+	}
+
+	for (i = 0; i < job_numWorkers; i++) {
+		job_wakeups[i] = Waitable_Create("Job worker wakeup");
+	}
+	for (i = 0; i < job_numWorkers; i++) {
+		Thread_Run(&thread, Jobs_WorkerMain, 256 * 1024, "Job worker");
+		Thread_Detach(thread);
+	}
+}
+
+int Jobs_WorkerCount(void) { return job_numWorkers; }
+
+static cc_bool JobQueue_Push(struct JobQueue* queue, struct JobEntry* job) {
+	cc_bool pushed = false;
+	Mutex_Lock(queue->lock);
+	{
+		if (queue->count < JOBS_QUEUE_SIZE) {
+			queue->entries[(queue->head + queue->count) % JOBS_QUEUE_SIZE] = *job;
+			queue->count++;
+			pushed = true;
+		}
+	}
+	Mutex_Unlock(queue->lock);
+	return pushed;
+}
+
+/* Owner takes newest job, thieves take oldest job */
+static cc_bool JobQueue_Pop(struct JobQueue* queue, struct JobEntry* job, cc_bool steal) {
+	cc_bool popped = false;
+	if (!queue->count) return false; /* Avoid locking when queue is obviously empty */
+
+	Mutex_Lock(queue->lock);
+	{
+		if (queue->count && steal) {
+			*job = queue->entries[queue->head];
+			queue->head = (queue->head + 1) % JOBS_QUEUE_SIZE;
+			queue->count--;
+			popped = true;
+		} else if (queue->count) {
+			queue->count--;
+			*job = queue->entries[(queue->head + queue->count) % JOBS_QUEUE_SIZE];
+			popped = true;
+		}
+	}
+	Mutex_Unlock(queue->lock);
+	return popped;
+}
+
+/* Takes newest job tracked by the given counter, shifting down the jobs queued after it */
+static cc_bool JobQueue_PopFor(struct JobQueue* queue, struct JobCounter* counter, struct JobEntry* job) {
+	cc_bool popped = false;
+	int i, j;
+	if (!queue->count) return false;
+
+	Mutex_Lock(queue->lock);
+	{
+		for (i = queue->count - 1; i >= 0; i--) {
+			if (queue->entries[(queue->head + i) % JOBS_QUEUE_SIZE].counter != counter) continue;
+			*job = queue->entries[(queue->head + i) % JOBS_QUEUE_SIZE];
+
+			for (j = i; j < queue->count - 1; j++) {
+				queue->entries[(queue->head + j) % JOBS_QUEUE_SIZE] = queue->entries[(queue->head + j + 1) % JOBS_QUEUE_SIZE];
+			}
+			queue->count--;
+			popped = true;
+			break;
+		}
+	}
+	Mutex_Unlock(queue->lock);
+	return popped;
+}
+
+static cc_bool Jobs_TryTake(int queueIndex, struct JobEntry* job) {
+	int i, count = job_numWorkers + 1;
+	if (JobQueue_Pop(&job_queues[queueIndex], job, false)) return true;
+
+	for (i = 1; i < count; i++) {
+		if (JobQueue_Pop(&job_queues[(queueIndex + i) % count], job, true)) return true;
+	}
+	return false;
+}
+
+static void Jobs_Enqueue(struct JobEntry* job);
+static void Jobs_Run(struct JobEntry* job) {
+	struct JobCounter* counter = job->counter;
+	struct JobEntry continuations[JOB_MAX_CONTINUATIONS];
+	int i, count = 0, waiters = 0;
+
+	job->func(job->arg);
+	if (!counter) return;
+
+	Mutex_Lock(job_stateLock);
+	{
+		if (--counter->pending == 0) {
+			count = counter->numContinuations;
+			for (i = 0; i < count; i++) continuations[i] = counter->continuations[i];
+			counter->numContinuations = 0;
+
+			waiters = counter->waiters;
+			counter->waiters = 0;
+		}
+	}
+	Mutex_Unlock(job_stateLock);
+	/* NOTE: counter may no longer exist from here on (e.g. Jobs_ParallelFor returned) */
+
+	/* Continuations were already counted in their own counters when they were deferred */
+	for (i = 0; i < count; i++) Jobs_Enqueue(&continuations[i]);
+
+	for (i = 0; i < JOBS_MAX_WAITERS; i++) {
+		if (waiters & (1 << i)) Waitable_Signal(job_waiters[i]);
+	}
+}
+
+static void Jobs_WakeWorkers(int count) {
+	int i;
+	Mutex_Lock(job_stateLock);
+	{
+		for (i = 0; i < job_numWorkers && count > 0; i++) {
+			if (!job_sleeping[i]) continue;
+			job_sleeping[i] = false;
+			Waitable_Signal(job_wakeups[i]);
+			count--;
+		}
+	}
+	Mutex_Unlock(job_stateLock);
+}
+
+static void Jobs_WorkerMain(void) {
+	struct JobEntry job;
+	int index, queueIndex;
+
+	Mutex_Lock(job_stateLock);
+	index = job_startedWorkers++;
+	Mutex_Unlock(job_stateLock);
+	queueIndex = index + 1;
+
+	for (;;) {
+		if (Jobs_TryTake(queueIndex, &job)) { Jobs_Run(&job); continue; }
+
+		Mutex_Lock(job_stateLock);
+		job_sleeping[index] = true;
+		Mutex_Unlock(job_stateLock);
+
+		/* Check again, in case a job was queued just before this worker was marked as sleeping */
+		if (Jobs_TryTake(queueIndex, &job)) {
+			Mutex_Lock(job_stateLock);
+			job_sleeping[index] = false;
+			Mutex_Unlock(job_stateLock);
+			Jobs_Run(&job); continue;
+		}
+		Waitable_Wait(job_wakeups[index]);
+	}
+}
+
+/* Jobs are spread across all the queues, as there is no portable way for a worker to know its own queue */
+static void Jobs_Enqueue(struct JobEntry* job) {
+	int i, start, count = job_numWorkers + 1;
+
+	/* Jobs are submitted from main, worker and HTTP threads */
+	Mutex_Lock(job_stateLock);
+	start = job_nextQueue++;
+	Mutex_Unlock(job_stateLock);
+
+	for (i = 0; i < count; i++) {
+		if (JobQueue_Push(&job_queues[(start + i) % count], job)) { Jobs_WakeWorkers(1); return; }
+	}
+	/* Every queue is full, so just run the job now */
+	Jobs_Run(job);
+}
+
+void Jobs_Submit(Job_Func func, void* arg, struct JobCounter* counter) {
+	struct JobEntry job;
+	job.func = func; job.arg = arg; job.counter = counter;
+	if (!Jobs_WorkerCount()) { func(arg); return; }
+
+	if (counter) {
+		Mutex_Lock(job_stateLock);
+		counter->pending++;
+		Mutex_Unlock(job_stateLock);
+	}
+	Jobs_Enqueue(&job);
+}
+
+void Jobs_SubmitAfter(struct JobCounter* after, Job_Func func, void* arg, struct JobCounter* counter) {
+	struct JobEntry* job;
+	cc_bool deferred = false;
+	if (!Jobs_WorkerCount()) { func(arg); return; }
+
+	Mutex_Lock(job_stateLock);
+	{
+		if (after->pending && after->numContinuations < JOB_MAX_CONTINUATIONS) {
+			job = &after->continuations[after->numContinuations++];
+			job->func = func; job->arg = arg; job->counter = counter;
+
+			if (counter) counter->pending++;
+			deferred = true;
+		}
+	}
+	Mutex_Unlock(job_stateLock);
+	if (deferred) return;
+
+	/* Either the jobs have already completed, or there's no room left to defer this job */
+	Jobs_Wait(after);
+	Jobs_Submit(func, arg, counter);
+}
+
+static cc_bool Jobs_TryTakeFor(struct JobCounter* counter, struct JobEntry* job) {
+	int i;
+	for (i = 0; i <= job_numWorkers; i++) {
+		if (JobQueue_PopFor(&job_queues[i], counter, job)) return true;
+	}
+	return false;
+}
+
+void Jobs_Wait(struct JobCounter* counter) {
+	struct JobEntry job;
+	int i, waiter = -1;
+	cc_bool blocked;
+	if (!Jobs_WorkerCount()) return;
+
+	while (counter->pending) {
+		/* Help out with this counter's own jobs instead of just idly waiting */
+		if (Jobs_TryTakeFor(counter, &job)) { Jobs_Run(&job); continue; }
+
+		Mutex_Lock(job_stateLock);
+		{
+			for (i = 0; waiter == -1 && i < JOBS_MAX_WAITERS; i++) {
+				if (job_usedWaiters & (1 << i)) continue;
+				job_usedWaiters |= 1 << i;
+				waiter = i;
+			}
+
+			/* Register while holding the lock, so the final job can't complete without signalling this waiter */
+			blocked = counter->pending && waiter >= 0;
+			if (blocked) counter->waiters |= 1 << waiter;
+		}
+		Mutex_Unlock(job_stateLock);
+
+		/* NOTE: Waiter may have been signalled by a previous counter, so spurious wakeups are possible */
+		if (blocked) {
+			Waitable_Wait(job_waiters[waiter]);
+		} else if (waiter == -1) {
+			Thread_Sleep(1); /* Too many threads are already waiting */
+		}
+	}
+	if (waiter == -1) return;
+
+	Mutex_Lock(job_stateLock);
+	job_usedWaiters &= ~(1 << waiter);
+	Mutex_Unlock(job_stateLock);
+}
+
+void Jobs_ParallelFor(int count, int minBatch, Job_RangeFunc func, void* arg) {
+	struct JobRange ranges[JOBS_MAX_BATCHES];
+	struct JobCounter counter = { 0 };
+	int i, batches, batchSize;
+	if (count <= 0) return;
+
+	/* Several batches per thread, so that threads finishing early can steal the remaining batches */
+	batches = (Jobs_WorkerCount() + 1) * 4;
+	batches = min(batches, JOBS_MAX_BATCHES);
+	batches = min(batches, count / max(minBatch, 1));
+
+	if (batches <= 1) { func(arg, 0, count); return; }
+	batchSize = (count + batches - 1) / batches;
+
+	for (i = 0; i < batches; i++) {
+		ranges[i].func = func; ranges[i].arg = arg;
+		ranges[i].beg  = i * batchSize;
+		ranges[i].end  = min(count, (i + 1) * batchSize);
+		if (ranges[i].beg >= ranges[i].end) break;
+
+		/* Calling thread runs the first batch itself */
+		if (i) Jobs_Submit(Jobs_RunRange, &ranges[i], &counter);
+	}
+
+	Jobs_RunRange(&ranges[0]);
+	Jobs_Wait(&counter);
+}
+#endif
@@ -8,6 +8,7 @@ CC_BEGIN_HEADER
 
 #define DEFAULT_SINGLEPLAYER_ARG "--singleplayer"
 #define DEFAULT_RESUME_ARG       "--resume"
+#define DEFAULT_BENCHMARK_ARG    "--benchmark"
 
 struct ResumeInfo {
 	cc_string user, ip, port, server, mppass;
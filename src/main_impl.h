@@ -18,6 +18,7 @@ Eg. the webclient 'main' function loads IndexedDB, and when that has asynchronou
 #include "Launcher.h"
 #include "Server.h"
 #include "Options.h"
+#include "ExtMath.h"
 #include "main.h"
 
 /*########################################################################################################################*
@@ -206,6 +207,20 @@ cc_string args[GAME_MAX_CMDARGS];
 		return ARG_RESULT_RUN_GAME;
 	}
 
+	/* --benchmark [frames] - run singleplayer headless benchmark, then exit */
+	if (argsCount <= 2 && String_CaselessEqualsConst(&args[0], DEFAULT_BENCHMARK_ARG)) {
+		Game_BenchmarkFrames = BENCHMARK_DEF_FRAMES;
+
+		if (argsCount == 2 && (!Convert_ParseInt(&args[1], &Game_BenchmarkFrames) || Game_BenchmarkFrames <= 0)) {
+			WarnInvalidArg("Invalid benchmark frames", &args[1]);
+			return ARG_RESULT_INVALID_ARGS;
+		}
+
+		Random_FixedSeed = BENCHMARK_SEED;
+		Options_Get(LOPT_USERNAME, &Game_Username, DEFAULT_USERNAME);
+		return ARG_RESULT_RUN_GAME;
+	}
+
 	/* [file path] - run singleplayer with auto loaded map */
 	if (argsCount == 1 && IsOpenableFile(&args[0])) {
 		Options_Get(LOPT_USERNAME, &Game_Username, DEFAULT_USERNAME);